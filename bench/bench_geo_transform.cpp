@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+#include "geoslice/geo_transform.hpp"
+
+namespace {
+// Same grid as tests/test_geo_transform.cpp (UTM 36N orthophoto)
+const std::array<double, 6> TRANSFORM = {0.337810489610016, 0.0, 668780.082, 0.0, -0.40736344335616, 3481925.5373};
+
+void BM_LatLonToPixel(benchmark::State& state) {
+    const geoslice::GeoTransform geo(TRANSFORM, 36);
+    double lat = 31.45;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(geo.latlon_to_pixel(lat, 34.8));
+        lat += 1e-7;  // defeat hoisting without leaving the raster
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LatLonToPixel);
+
+void BM_PixelToLatLon(benchmark::State& state) {
+    const geoslice::GeoTransform geo(TRANSFORM, 36);
+    int px = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(geo.pixel_to_latlon(px, 2048));
+        px = (px + 1) & 4095;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PixelToLatLon);
+
+void BM_FovToPixels(benchmark::State& state) {
+    const geoslice::GeoTransform geo(TRANSFORM, 36);
+    double altitude = 50.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(geo.fov_to_pixels(altitude, 60.0));
+        altitude = altitude < 200.0 ? altitude + 0.5 : 50.0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FovToPixels);
+}
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include "geoslice/copy_engine.hpp"
+#include "geoslice/mmap_reader.hpp"
+#include "synthetic_raster.hpp"
+
+#include <memory>
+
+namespace {
+constexpr int SIDE = 512;
+
+// Args: raster size; windows are SIDE x SIDE at random positions
+void BM_GetWindow(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    const geoslice::MMapReader reader(geoslice_bench::synthetic_raster(size));
+    const auto origins = geoslice_bench::random_origins(size, SIDE, 1024);
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& [x, y] = origins[i++ % origins.size()];
+        benchmark::DoNotOptimize(reader.get_window(x, y, SIDE, SIDE));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetWindow)->Arg(1024)->Arg(4096)->Arg(8192);
+
+// Args: raster size, window side
+void BM_ReadWindowCopy(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    const int side = static_cast<int>(state.range(1));
+    const geoslice::MMapReader reader(geoslice_bench::synthetic_raster(size));
+    const auto origins = geoslice_bench::random_origins(size, side, 1024);
+    std::vector<uint8_t> out(static_cast<size_t>(geoslice_bench::BANDS) * side * side);
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& [x, y] = origins[i++ % origins.size()];
+        reader.read_window(x, y, side, side, out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * out.size()));
+}
+BENCHMARK(BM_ReadWindowCopy)->ArgsProduct({{1024, 4096, 8192}, {64, 512}});
+
+// Args: raster size; a batch of 64 SIDE x SIDE windows copied with all cores
+void BM_ReadWindowsBatch(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    const geoslice::MMapReader reader(geoslice_bench::synthetic_raster(size));
+    const auto origins = geoslice_bench::random_origins(size, SIDE, 64);
+    std::vector<geoslice::WindowRect> windows;
+    std::vector<std::vector<uint8_t>> buffers;
+    std::vector<void*> outs;
+    for (const auto& [x, y] : origins) {
+        windows.push_back({x, y, SIDE, SIDE});
+        buffers.emplace_back(static_cast<size_t>(geoslice_bench::BANDS) * SIDE * SIDE);
+        outs.push_back(buffers.back().data());
+    }
+    for (auto _ : state) {
+        reader.read_windows(windows, outs, 0);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * windows.size());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * windows.size() * buffers[0].size()));
+}
+BENCHMARK(BM_ReadWindowsBatch)->Arg(4096)->Arg(8192)->UseRealTime();
+
+// Args: 0 = reader.read_window, 1 = CopyEngine. One 4000x4000 frame per
+// iteration into a fresh buffer, first touched by the copy like a new array
+void BM_HugeWindowCopy(benchmark::State& state) {
+    constexpr int FRAME = 4000;
+    const geoslice::MMapReader reader(geoslice_bench::synthetic_raster(8192));
+    geoslice::CopyEngine engine;
+    const size_t bytes = static_cast<size_t>(geoslice_bench::BANDS) * FRAME * FRAME;
+    for (auto _ : state) {
+        std::unique_ptr<uint8_t[]> out(new uint8_t[bytes]);
+        if (state.range(0)) {
+            engine.read_window(reader, 100, 100, FRAME, FRAME, out.get());
+        } else {
+            reader.read_window(100, 100, FRAME, FRAME, out.get());
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+BENCHMARK(BM_HugeWindowCopy)->Arg(0)->Arg(1)->UseRealTime();
+}
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+#include "geoslice/window_cache.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace {
+constexpr int SIDE = 256;
+constexpr int WINDOWS = 64;  // distinct keys, all resident
+constexpr size_t WINDOW_BYTES = 4 * SIDE * SIDE;
+
+// One cache shared by all threads of a run, filled by thread 0 before the
+// timed loop (the loop starts with a barrier)
+std::unique_ptr<geoslice::WindowCache> shared_cache;
+
+void fill(geoslice::WindowCache& cache) {
+    const std::vector<uint8_t> data(WINDOW_BYTES, 7);
+    for (int i = 0; i < WINDOWS; i++) cache.put(i * SIDE, 0, SIDE, SIDE, data.data(), data.size());
+}
+
+void BM_WindowCacheGet(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        shared_cache = std::make_unique<geoslice::WindowCache>(2 * WINDOWS * WINDOW_BYTES);
+        fill(*shared_cache);
+    }
+    int i = state.thread_index();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shared_cache->get((i++ % WINDOWS) * SIDE, 0, SIDE, SIDE));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) shared_cache.reset();
+}
+BENCHMARK(BM_WindowCacheGet)->ThreadRange(1, 8)->UseRealTime();
+
+// Replaces resident windows: every put evicts one entry once the cache is full
+void BM_WindowCachePut(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        shared_cache = std::make_unique<geoslice::WindowCache>(WINDOWS * WINDOW_BYTES);
+        fill(*shared_cache);
+    }
+    const std::vector<uint8_t> data(WINDOW_BYTES, 9);
+    int i = state.thread_index() * WINDOWS;
+    for (auto _ : state) {
+        shared_cache->put((i++ % (4 * WINDOWS)) * SIDE, SIDE, SIDE, SIDE, data.data(), data.size());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * WINDOW_BYTES));
+    if (state.thread_index() == 0) shared_cache.reset();
+}
+BENCHMARK(BM_WindowCachePut)->ThreadRange(1, 8)->UseRealTime();
+}
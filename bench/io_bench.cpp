@@ -0,0 +1,276 @@
+// Cold vs warm page cache I/O benchmark.
+//
+// Reads a sequence of windows from a raster through MMapReader and
+// FileReader, once after evicting the .bin from the page cache (cold) and
+// once with it cached (warm), and reports per-window latency percentiles
+// and the page faults and block reads of each run.
+//
+//   geoslice_io_bench [--raster BASE | --size N] [--pattern random|sequential|flight|all]
+//                     [--cache cold|warm|both] [--windows N] [--side PX] [--json FILE]
+//
+// Without --raster a synthetic 4-band uint8 raster of --size pixels is
+// written under /tmp. Eviction is posix_fadvise(DONTNEED) on the .bin: it
+// works on any file the user can read, but only drops pages no other
+// process keeps mapped.
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "geoslice/file_reader.hpp"
+#include "geoslice/geo_transform.hpp"
+#include "geoslice/mmap_reader.hpp"
+#include "synthetic_raster.hpp"
+
+namespace {
+
+struct Options {
+    std::string raster;
+    int size = 8192;
+    std::string pattern = "all";
+    std::string cache = "both";
+    size_t windows = 200;
+    int side = 512;
+    std::string json;
+};
+
+struct Result {
+    std::string reader, pattern, cache;
+    size_t windows = 0;
+    double total_ms = 0;
+    double mean_us = 0, p50_us = 0, p90_us = 0, p99_us = 0, max_us = 0;
+    long major_faults = 0, minor_faults = 0, blocks_in = 0;
+    double mb = 0;
+};
+
+[[noreturn]] void usage(const char* error) {
+    std::fprintf(stderr, "%s\nusage: geoslice_io_bench [--raster BASE | --size N] "
+                         "[--pattern random|sequential|flight|all] [--cache cold|warm|both] "
+                         "[--windows N] [--side PX] [--json FILE]\n", error);
+    std::exit(2);
+}
+
+Options parse_args(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") usage("Cold vs warm page cache window reads");
+        if (i + 1 >= argc) usage(("missing value for " + arg).c_str());
+        const char* value = argv[++i];
+        if (arg == "--raster") o.raster = value;
+        else if (arg == "--size") o.size = std::atoi(value);
+        else if (arg == "--pattern") o.pattern = value;
+        else if (arg == "--cache") o.cache = value;
+        else if (arg == "--windows") o.windows = static_cast<size_t>(std::atol(value));
+        else if (arg == "--side") o.side = std::atoi(value);
+        else if (arg == "--json") o.json = value;
+        else usage(("unknown option " + arg).c_str());
+    }
+    if (o.size <= 0 || o.side <= 0 || o.windows == 0) usage("sizes must be positive");
+    return o;
+}
+
+// Writes back and drops the cached pages of path
+void evict(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path);
+    fdatasync(fd);  // dirty pages (a freshly written raster) cannot be dropped
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// Reads every page of path so a warm run starts fully cached
+void warm(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path);
+    std::vector<char> buf(8 << 20);
+    while (read(fd, buf.data(), buf.size()) > 0) {
+    }
+    close(fd);
+}
+
+// Row-major sweep of non-overlapping windows, wrapping around the raster
+std::vector<geoslice::WindowRect> sequential_windows(const geoslice::GeoMetadata& meta, int side, size_t n) {
+    std::vector<geoslice::WindowRect> out;
+    const int cols = std::max(1, meta.width / side);
+    const int rows = std::max(1, meta.height / side);
+    for (size_t i = 0; i < n; i++) {
+        const int c = static_cast<int>(i % cols);
+        const int r = static_cast<int>((i / cols) % rows);
+        out.push_back({c * side, r * side, std::min(side, meta.width), std::min(side, meta.height)});
+    }
+    return out;
+}
+
+std::vector<geoslice::WindowRect> random_windows(const geoslice::GeoMetadata& meta, int side, size_t n) {
+    const int w = std::min(side, meta.width);
+    const int h = std::min(side, meta.height);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> px(0, meta.width - w);
+    std::uniform_int_distribution<int> py(0, meta.height - h);
+    std::vector<geoslice::WindowRect> out;
+    for (size_t i = 0; i < n; i++) out.push_back({px(rng), py(rng), w, h});
+    return out;
+}
+
+// A drone spiralling out from the raster centre through the altitude
+// ladder of FlightPath.spiral; the window is the camera footprint
+std::vector<geoslice::WindowRect> flight_windows(const geoslice::GeoMetadata& meta, size_t n) {
+    const geoslice::GeoTransform geo(meta.transform);
+    const double altitudes[] = {50, 100, 150, 200};
+    const double max_radius = 0.4 * std::min(meta.width, meta.height);
+    std::vector<geoslice::WindowRect> out;
+    for (size_t i = 0; i < n; i++) {
+        const double t = static_cast<double>(i) / n;
+        const double angle = t * 6 * M_PI;
+        const auto [w, h] = geo.fov_to_pixels(altitudes[i % 4], 60.0);
+        const int fw = std::clamp(w, 1, meta.width);
+        const int fh = std::clamp(h, 1, meta.height);
+        const int cx = static_cast<int>(meta.width / 2 + t * max_radius * std::cos(angle));
+        const int cy = static_cast<int>(meta.height / 2 + t * max_radius * std::sin(angle));
+        out.push_back({std::clamp(cx - fw / 2, 0, meta.width - fw), std::clamp(cy - fh / 2, 0, meta.height - fh), fw, fh});
+    }
+    return out;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    const size_t i = static_cast<size_t>(std::ceil(p * sorted.size())) - 1;
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+using ReadFn = std::function<void(const geoslice::WindowRect&, void*)>;
+
+Result run(const std::vector<geoslice::WindowRect>& windows, size_t pixel_bytes, const ReadFn& read) {
+    size_t max_bytes = 0;
+    for (const auto& w : windows) max_bytes = std::max(max_bytes, pixel_bytes * w.width * w.height);
+    std::vector<uint8_t> out(max_bytes);
+
+    std::vector<double> latencies;
+    latencies.reserve(windows.size());
+    rusage before, after;
+    getrusage(RUSAGE_SELF, &before);
+    const auto start = std::chrono::steady_clock::now();
+    double bytes = 0;
+    for (const auto& w : windows) {
+        const auto t0 = std::chrono::steady_clock::now();
+        read(w, out.data());
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+        bytes += static_cast<double>(pixel_bytes) * w.width * w.height;
+    }
+    const auto total = std::chrono::steady_clock::now() - start;
+    getrusage(RUSAGE_SELF, &after);
+
+    Result r;
+    r.windows = windows.size();
+    r.total_ms = std::chrono::duration<double, std::milli>(total).count();
+    r.major_faults = after.ru_majflt - before.ru_majflt;
+    r.minor_faults = after.ru_minflt - before.ru_minflt;
+    r.blocks_in = after.ru_inblock - before.ru_inblock;
+    r.mb = bytes / (1 << 20);
+    std::sort(latencies.begin(), latencies.end());
+    for (double l : latencies) r.mean_us += l / latencies.size();
+    r.p50_us = percentile(latencies, 0.50);
+    r.p90_us = percentile(latencies, 0.90);
+    r.p99_us = percentile(latencies, 0.99);
+    r.max_us = latencies.back();
+    return r;
+}
+
+void write_json(const std::string& path, const std::string& raster, const std::vector<Result>& results) {
+    std::ofstream f(path);
+    if (!f) throw std::runtime_error("Cannot write " + path);
+    f << "{\n  \"raster\": \"" << raster << "\",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        f << "    {\"reader\": \"" << r.reader << "\", \"pattern\": \"" << r.pattern << "\", \"cache\": \"" << r.cache
+          << "\", \"windows\": " << r.windows << ", \"total_ms\": " << r.total_ms << ", \"mean_us\": " << r.mean_us
+          << ", \"p50_us\": " << r.p50_us << ", \"p90_us\": " << r.p90_us << ", \"p99_us\": " << r.p99_us
+          << ", \"max_us\": " << r.max_us << ", \"major_faults\": " << r.major_faults
+          << ", \"minor_faults\": " << r.minor_faults << ", \"blocks_in\": " << r.blocks_in << ", \"mb\": " << r.mb
+          << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    f << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Options options = parse_args(argc, argv);
+    try {
+        const std::string base = options.raster.empty() ? geoslice_bench::synthetic_raster(options.size) : options.raster;
+        const std::string bin = base + ".bin";
+        const geoslice::GeoMetadata meta = geoslice::read_metadata(base);
+        const size_t pixel_bytes = meta.pixel_size() * meta.count;
+
+        std::vector<std::pair<std::string, std::vector<geoslice::WindowRect>>> patterns;
+        if (options.pattern == "random" || options.pattern == "all")
+            patterns.emplace_back("random", random_windows(meta, options.side, options.windows));
+        if (options.pattern == "sequential" || options.pattern == "all")
+            patterns.emplace_back("sequential", sequential_windows(meta, options.side, options.windows));
+        if (options.pattern == "flight" || options.pattern == "all")
+            patterns.emplace_back("flight", flight_windows(meta, options.windows));
+        if (patterns.empty()) usage("unknown pattern");
+
+        std::vector<std::string> caches;
+        if (options.cache == "cold" || options.cache == "both") caches.push_back("cold");
+        if (options.cache == "warm" || options.cache == "both") caches.push_back("warm");
+        if (caches.empty()) usage("unknown cache mode");
+
+        std::printf("%s: %dx%dx%d %s, %.0f MiB\n", base.c_str(), meta.width, meta.height, meta.count,
+                    meta.dtype(), static_cast<double>(meta.total_bytes()) / (1 << 20));
+        std::printf("%-14s %-11s %-5s %10s %9s %9s %9s %9s %9s %8s %8s %9s\n", "reader", "pattern", "cache",
+                    "total_ms", "mean_us", "p50_us", "p90_us", "p99_us", "max_us", "majflt", "minflt", "MiB/s");
+
+        std::vector<Result> results;
+        for (const auto& [pattern, windows] : patterns) {
+            for (const auto& cache : caches) {
+                for (const std::string reader_name : {"mmap", "file"}) {
+                    // Readers are opened after eviction: pages mapped by a
+                    // live reader would survive DONTNEED
+                    if (cache == "cold") evict(bin);
+                    else warm(bin);
+
+                    Result r;
+                    if (reader_name == "mmap") {
+                        const geoslice::MMapReader reader(base);
+                        r = run(windows, pixel_bytes, [&](const geoslice::WindowRect& w, void* out) {
+                            reader.read_window(w.x, w.y, w.width, w.height, out);
+                        });
+                    } else {
+                        const geoslice::FileReader reader(base);
+                        r = run(windows, pixel_bytes, [&](const geoslice::WindowRect& w, void* out) {
+                            reader.read_window(w.x, w.y, w.width, w.height, out);
+                        });
+                        r.reader = std::string("file/") + reader.backend().name();
+                    }
+                    if (r.reader.empty()) r.reader = reader_name;
+                    r.pattern = pattern;
+                    r.cache = cache;
+                    std::printf("%-14s %-11s %-5s %10.1f %9.1f %9.1f %9.1f %9.1f %9.1f %8ld %8ld %9.0f\n",
+                                r.reader.c_str(), r.pattern.c_str(), r.cache.c_str(), r.total_ms, r.mean_us, r.p50_us,
+                                r.p90_us, r.p99_us, r.max_us, r.major_faults, r.minor_faults,
+                                r.mb / (r.total_ms / 1000));
+                    results.push_back(r);
+                }
+            }
+        }
+        if (!options.json.empty()) write_json(options.json, base, results);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
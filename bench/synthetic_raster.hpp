@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace geoslice_bench {
+
+constexpr int BANDS = 4;
+
+// Base path of a BANDS-band uint8 size x size raster under /tmp, written on
+// first use and removed when the benchmark exits
+inline const std::string& synthetic_raster(int size) {
+    struct Files {
+        std::map<int, std::string> bases;
+        ~Files() {
+            for (const auto& [size, base] : bases) {
+                std::remove((base + ".bin").c_str());
+                std::remove((base + ".json").c_str());
+            }
+        }
+    };
+    static Files files;
+
+    auto it = files.bases.find(size);
+    if (it != files.bases.end()) return it->second;
+
+    const std::string base = "/tmp/geoslice_bench_" + std::to_string(size);
+    std::ofstream json(base + ".json");
+    json << R"({"dtype": "uint8", "count": )" << BANDS << R"(, "height": )" << size << R"(, "width": )" << size
+         << R"(, "transform": [0.3378, 0.0, 668780.082, 0.0, -0.4074, 3481925.5373], "crs": "EPSG:32636"})";
+    json.close();
+
+    std::ofstream bin(base + ".bin", std::ios::binary);
+    std::vector<char> row(size);
+    for (int b = 0; b < BANDS; b++)
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) row[x] = static_cast<char>((x + y * 3 + b * 50) & 0xFF);
+            bin.write(row.data(), size);
+        }
+    return files.bases.emplace(size, base).first->second;
+}
+
+// n window origins for side x side windows inside a size x size raster
+inline std::vector<std::pair<int, int>> random_origins(int size, int side, size_t n) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pos(0, size - side);
+    std::vector<std::pair<int, int>> origins(n);
+    for (auto& o : origins) o = {pos(rng), pos(rng)};
+    return origins;
+}
+
+} // namespace geoslice_bench
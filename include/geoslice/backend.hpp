@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace geoslice {
+
+// One contiguous read from a file into caller memory
+struct ReadRequest {
+    uint64_t offset;
+    size_t length;
+    void* dst;
+};
+
+// Explicit-I/O engine behind FileReader, the alternative to letting page
+// faults on a mapping do the reads: every request of a window (or a batch of
+// windows) is in flight at once, so cold reads get real queue depth.
+class ReaderBackend {
+public:
+    virtual ~ReaderBackend() = default;
+
+    virtual const char* name() const = 0;
+    // Returns once every request is complete. Throws std::runtime_error on
+    // an I/O error or a read past the end of the file. Thread-safe.
+    virtual void read(int fd, const std::vector<ReadRequest>& requests) = 0;
+};
+
+// pread(2) on up to `threads` threads (0 = all cores): the caller and tasks
+// of io_executor()
+std::unique_ptr<ReaderBackend> make_pread_backend(unsigned threads = 0);
+
+// io_uring with up to queue_depth reads in flight. Throws std::runtime_error
+// when the kernel (or a seccomp policy) does not allow io_uring.
+std::unique_ptr<ReaderBackend> make_io_uring_backend(unsigned queue_depth = 128);
+
+// io_uring when available, otherwise the pread pool
+std::unique_ptr<ReaderBackend> make_default_backend();
+
+// Offset, length and buffer address alignment that O_DIRECT reads use: the
+// largest logical block size of common devices
+constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+// Fixed set of equally sized buffers aligned for O_DIRECT, bounding the
+// memory that direct reads stage through. A caller takes all the buffers
+// it needs at once, blocking until they are free, so concurrent callers
+// never hold some while waiting for more.
+class AlignedBufferPool {
+public:
+    // Buffers go back to the pool when the lease is destroyed
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept : pool_(other.pool_), buffers_(std::move(other.buffers_)) {
+            other.buffers_.clear();
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease() { pool_->release(buffers_); }
+
+        uint8_t* operator[](size_t i) const { return buffers_[i]; }
+        size_t size() const { return buffers_.size(); }
+
+    private:
+        friend class AlignedBufferPool;
+        Lease(AlignedBufferPool* pool, std::vector<uint8_t*> buffers)
+            : pool_(pool), buffers_(std::move(buffers)) {}
+
+        AlignedBufferPool* pool_;
+        std::vector<uint8_t*> buffers_;
+    };
+
+    // buffer_bytes must be a positive multiple of alignment (a power of two)
+    AlignedBufferPool(size_t buffer_bytes, size_t count, size_t alignment = DIRECT_IO_ALIGNMENT);
+    ~AlignedBufferPool();
+
+    AlignedBufferPool(const AlignedBufferPool&) = delete;
+    AlignedBufferPool& operator=(const AlignedBufferPool&) = delete;
+
+    // Throws std::invalid_argument if count is 0 or exceeds capacity()
+    Lease acquire(size_t count);
+
+    size_t buffer_bytes() const { return buffer_bytes_; }
+    size_t capacity() const { return capacity_; }
+    size_t available() const;
+
+private:
+    void release(const std::vector<uint8_t*>& buffers);
+
+    size_t buffer_bytes_;
+    size_t capacity_;
+    uint8_t* storage_ = nullptr;
+    std::vector<uint8_t*> free_;
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+};
+
+} // namespace geoslice
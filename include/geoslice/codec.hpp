@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "geoslice/dtype.hpp"
+
+namespace geoslice {
+
+// Compression of tiled rasters. The values are stored in the tile
+// directory: only ever append new codecs.
+enum class TileCodec : uint8_t {
+    None = 0,
+    LZ4 = 1,      // built in, no library needed
+    Deflate = 2,  // needs zlib (GEOSLICE_HAVE_ZLIB)
+};
+
+// Reversible predictors applied to each row of a tile before compression,
+// turning smooth data (elevation, temperature) into small residuals. The
+// values are stored in the tile directory: only ever append new filters.
+enum class TileFilter : uint8_t {
+    None = 0,
+    Delta = 1,         // horizontal difference of samples, wrapping
+    FloatShuffle = 2,  // byte planes (most significant first), then byte delta
+};
+
+TileCodec parse_codec(const char* name);  // "none", "lz4", "deflate"; throws std::invalid_argument
+const char* codec_name(TileCodec codec);
+bool codec_available(TileCodec codec);
+
+TileFilter parse_filter(const char* name);  // "none", "delta", "float_shuffle"; throws std::invalid_argument
+const char* filter_name(TileFilter filter);
+// Delta for 16-bit and wider integers, FloatShuffle for floats, None for bytes
+TileFilter default_filter(DType dtype);
+
+// Filters rows of row_values samples of sample_size bytes from src into dst
+void apply_filter(TileFilter filter, const uint8_t* src, uint8_t* dst, size_t rows, size_t row_values,
+                  size_t sample_size);
+// Reverses apply_filter in place (SSE2 prefix sums where available)
+void undo_filter(TileFilter filter, uint8_t* data, size_t rows, size_t row_values, size_t sample_size);
+
+// LZ4 block format (no frame), compatible with liblz4's LZ4_compress_default
+// and LZ4_decompress_safe. lz4_compress returns the compressed size, or 0 if
+// it would exceed capacity; lz4_bound(n) bytes are always enough.
+size_t lz4_bound(size_t n);
+size_t lz4_compress(const uint8_t* src, size_t n, uint8_t* dst, size_t capacity);
+// Throws std::runtime_error unless src decodes to exactly out_size bytes
+void lz4_decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t out_size);
+
+// Compresses n bytes into out (resized to fit) with codec; returns false if
+// that did not make them smaller, in which case out is meaningless.
+// Throws std::runtime_error for a codec that is not available.
+bool compress_block(TileCodec codec, const uint8_t* src, size_t n, std::vector<uint8_t>& out);
+// Throws std::runtime_error unless src decodes to exactly out_size bytes
+void decompress_block(TileCodec codec, const uint8_t* src, size_t n, uint8_t* dst, size_t out_size);
+
+} // namespace geoslice
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+#include "geoslice/mmap_reader.hpp"
+
+namespace geoslice {
+
+struct ConvertOptions {
+    unsigned threads = 0;          // 0 = all cores
+    bool overwrite = false;
+    bool write_mask = false;       // also write <base>.mask from the nodata value
+    bool write_occupancy = false;  // also write <base>.occ
+    bool write_header = false;     // prefix the .bin with a RasterHeader
+    int tile_size = OccupancyIndex::DEFAULT_TILE_SIZE;
+};
+
+// Converts a GeoTIFF into the <base>.bin (BSQ) / <base>.json pair without
+// GDAL. Reads classic and BigTIFF files in either byte order, stripped or
+// tiled, chunky or planar, uncompressed / LZW / PackBits / Deflate (when
+// built with zlib), with horizontal or floating-point predictors. Strips and
+// tiles are decoded in parallel straight into the mapped output file.
+// Georeferencing comes from ModelPixelScale + ModelTiepoint or
+// ModelTransformation, the CRS from the EPSG code in the GeoKey directory and
+// nodata from the GDAL_NODATA tag. Throws std::runtime_error for anything else,
+// and on big-endian hosts.
+GeoMetadata convert_tiff(const std::string& tiff_path, const std::string& output_base,
+                         const ConvertOptions& options = {});
+
+} // namespace geoslice
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <sched.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "geoslice/mmap_reader.hpp"
+#include "geoslice/thread_pool.hpp"
+
+namespace geoslice {
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;  // CPUs of the node this process may run on
+};
+
+// Parses a sysfs CPU list such as "0-3,8,10-11"; throws std::invalid_argument
+std::vector<int> parse_cpu_list(const std::string& list);
+
+// NUMA nodes with at least one usable CPU, from /sys/devices/system/node.
+// Without NUMA information the machine is a single node 0.
+std::vector<NumaNode> numa_nodes();
+
+struct CopyEngineOptions {
+    unsigned threads_per_node = 0;      // most threads per copy, caller included; 0 = the node's CPUs
+    bool pin = true;                    // helpers move to the caller's node for the copy
+    size_t min_parallel_bytes = 4 << 20;  // smaller windows are copied by the caller alone
+    size_t task_bytes = 1 << 20;        // rows of one band per task, about this many bytes
+};
+
+// Parallel copies of large windows (a 4000x4000x4 frame is 64 MB). The
+// engine starts no threads: its helpers are tasks of default_executor(), so
+// copies and parallel loops together never run more threads than the pool
+// has. While a helper works on a copy it is moved onto the CPUs of the
+// calling thread's NUMA node: the output pages, untouched until then, are
+// first touched - and so allocated - on the node of the thread consuming
+// them. Copies from several threads may run at once.
+class CopyEngine {
+public:
+    explicit CopyEngine(const CopyEngineOptions& options = {});
+
+    // Same result as reader.read_window(), split into stripes of bands and
+    // rows; the caller works on its share too
+    void read_window(const MMapReader& reader, int x, int y, int width, int height, void* out) const;
+
+    const std::vector<NumaNode>& nodes() const { return nodes_; }
+    // Most threads one copy uses right now, the caller included
+    size_t threads() const;
+
+private:
+    size_t threads_on(size_t node, const Executor& executor) const;
+
+    std::vector<NumaNode> nodes_;
+    std::vector<cpu_set_t> node_sets_;  // nodes_[i].cpus as a set
+    std::vector<int> node_of_cpu_;
+    CopyEngineOptions options_;
+};
+
+} // namespace geoslice
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+namespace geoslice {
+
+// Pixel data types, parsed once from the metadata dtype string. The values
+// are stored in the .bin header: only ever append new types.
+enum class DType : uint8_t {
+    UInt8,
+    Int8,
+    UInt16,
+    Int16,
+    UInt32,
+    Int32,
+    Float32,
+    Float64,
+};
+
+DType parse_dtype(const std::string& name);  // throws std::invalid_argument
+const char* dtype_name(DType dtype);
+
+constexpr size_t dtype_size(DType dtype) {
+    switch (dtype) {
+        case DType::UInt8:
+        case DType::Int8: return 1;
+        case DType::UInt16:
+        case DType::Int16: return 2;
+        case DType::UInt32:
+        case DType::Int32:
+        case DType::Float32: return 4;
+        case DType::Float64: return 8;
+    }
+    return 1;
+}
+
+template<typename T> struct dtype_of;
+template<> struct dtype_of<uint8_t>  { static constexpr DType value = DType::UInt8; };
+template<> struct dtype_of<int8_t>   { static constexpr DType value = DType::Int8; };
+template<> struct dtype_of<uint16_t> { static constexpr DType value = DType::UInt16; };
+template<> struct dtype_of<int16_t>  { static constexpr DType value = DType::Int16; };
+template<> struct dtype_of<uint32_t> { static constexpr DType value = DType::UInt32; };
+template<> struct dtype_of<int32_t>  { static constexpr DType value = DType::Int32; };
+template<> struct dtype_of<float>    { static constexpr DType value = DType::Float32; };
+template<> struct dtype_of<double>   { static constexpr DType value = DType::Float64; };
+
+// Calls f(T{}) with the C++ type matching dtype, so the callee is
+// instantiated once per pixel type and the switch happens once per call.
+template<typename F>
+decltype(auto) dispatch_dtype(DType dtype, F&& f) {
+    switch (dtype) {
+        case DType::Int8: return f(int8_t{});
+        case DType::UInt16: return f(uint16_t{});
+        case DType::Int16: return f(int16_t{});
+        case DType::UInt32: return f(uint32_t{});
+        case DType::Int32: return f(int32_t{});
+        case DType::Float32: return f(float{});
+        case DType::Float64: return f(double{});
+        case DType::UInt8: break;
+    }
+    return f(uint8_t{});
+}
+
+// NaN test on the bit pattern: unlike v != v and std::isnan it still works
+// in code built with -ffast-math. Always false for integer types.
+template<typename T>
+inline bool is_nan(T v) {
+    if constexpr (std::is_same_v<T, float>) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return (bits & 0x7fffffffu) > 0x7f800000u;
+    } else if constexpr (std::is_same_v<T, double>) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return (bits & 0x7fffffffffffffffull) > 0x7ff0000000000000ull;
+    } else {
+        return false;
+    }
+}
+
+// False for NaN and +-inf, by bit pattern like is_nan. Always true for
+// integer types.
+template<typename T>
+inline bool is_finite(T v) {
+    if constexpr (std::is_same_v<T, float>) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return (bits & 0x7fffffffu) < 0x7f800000u;
+    } else if constexpr (std::is_same_v<T, double>) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return (bits & 0x7fffffffffffffffull) < 0x7ff0000000000000ull;
+    } else {
+        return true;
+    }
+}
+
+// Converts a nodata value to the pixel type. Returns false when there is no
+// nodata or the type cannot represent it (no pixel can match, e.g. -9999 for
+// uint8); NaN nodata is handled by the callers' NaN checks instead.
+template<typename T>
+bool nodata_as(std::optional<double> nodata, T& out) {
+    if (!nodata || is_nan(*nodata)) return false;
+    if (*nodata < static_cast<double>(std::numeric_limits<T>::lowest()) ||
+        *nodata > static_cast<double>(std::numeric_limits<T>::max())) {
+        return false;
+    }
+    out = static_cast<T>(*nodata);
+    return static_cast<double>(out) == *nodata;
+}
+
+} // namespace geoslice
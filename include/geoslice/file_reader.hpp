@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "geoslice/backend.hpp"
+#include "geoslice/mmap_reader.hpp"
+
+namespace geoslice {
+
+struct FileReaderOptions {
+    // Bypass the page cache with O_DIRECT, for bulk scans that must not
+    // evict the hot pages of live readers. Reads are widened to whole
+    // aligned blocks, neighbouring rows merged into one read, and staged
+    // through max_buffers aligned buffers of buffer_bytes each. Where the
+    // filesystem refuses O_DIRECT, reads are buffered and the pages they
+    // brought in are dropped afterwards.
+    bool direct = false;
+    size_t buffer_bytes = 8 << 20;
+    size_t max_buffers = 4;
+};
+
+// Reads windows of a .bin with explicit I/O instead of a mapping: each
+// window becomes one read per band row (rows that meet or overlap in the
+// file, within a window or across a batch, are merged), and all reads of a
+// window (or of a whole batch) are handed to the backend at once. On a cold page cache this
+// keeps the device queue full where MMapReader faults pages in one at a
+// time; it also costs no address space, so any number of readers stay open.
+class FileReader {
+public:
+    // Metadata as for MMapReader. Without a backend, io_uring is used when
+    // the kernel allows it and the pread pool otherwise.
+    explicit FileReader(const std::string& base_path, std::shared_ptr<ReaderBackend> backend = nullptr,
+                        const FileReaderOptions& options = {});
+    ~FileReader();
+
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+
+    // Copies a window into out as (bands, height, width). Thread-safe.
+    void read_window(int x, int y, int width, int height, void* out) const;
+    // outs[i] receives windows[i], all windows in one submission. Where
+    // windows overlap, the union of their row spans is read once and
+    // scattered to each output.
+    void read_windows(const std::vector<WindowRect>& windows, const std::vector<void*>& outs) const;
+    bool is_valid_window(int x, int y, int width, int height) const;
+
+    // Bulk scan: reads the raster `rows` full-width rows at a time and calls
+    // fn(strip, data) with data as (bands, strip.height, width), valid only
+    // during the call. The next strip is read on io_executor() while fn runs.
+    void scan_strips(int rows, const std::function<void(const WindowRect&, const void*)>& fn) const;
+
+    const GeoMetadata& metadata() const { return meta_; }
+    int width() const { return meta_.width; }
+    int height() const { return meta_.height; }
+    int bands() const { return meta_.count; }
+    size_t data_offset() const { return data_offset_; }
+    ReaderBackend& backend() const { return *backend_; }
+    // O_DIRECT in effect (false in direct mode's buffered fallback)
+    bool direct() const { return direct_fd_ >= 0; }
+    // Bytes requested from the backend so far, after coalescing
+    uint64_t bytes_read() const { return bytes_read_; }
+
+private:
+    void add_requests(const WindowRect& window, void* out, std::vector<ReadRequest>& requests) const;
+    void submit(std::vector<ReadRequest>& requests) const;
+    void read_buffered(std::vector<ReadRequest>& requests) const;
+    void read_direct(std::vector<ReadRequest>& requests) const;
+    void drop_cached(std::vector<ReadRequest>& requests) const;
+
+    GeoMetadata meta_;
+    size_t data_offset_ = 0;
+    size_t file_size_ = 0;
+    int fd_ = -1;
+    int direct_fd_ = -1;
+    bool drop_after_read_ = false;
+    std::shared_ptr<ReaderBackend> backend_;
+    std::unique_ptr<AlignedBufferPool> buffers_;  // direct mode only
+    mutable std::atomic<uint64_t> bytes_read_{0};
+};
+
+} // namespace geoslice
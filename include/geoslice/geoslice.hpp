@@ -1,8 +1,20 @@
 #pragma once
 
 #include "geoslice/mmap_reader.hpp"
+#include "geoslice/converter.hpp"
+#include "geoslice/copy_engine.hpp"
+#include "geoslice/file_reader.hpp"
 #include "geoslice/geo_transform.hpp"
+#include "geoslice/histogram.hpp"
+#include "geoslice/metrics.hpp"
+#include "geoslice/mosaic.hpp"
+#include "geoslice/reader_pool.hpp"
+#include "geoslice/simd.hpp"
+#include "geoslice/thread_pool.hpp"
+#include "geoslice/tiled_raster.hpp"
+#include "geoslice/trace.hpp"
 #include "geoslice/window_cache.hpp"
+#include "geoslice/window_stats.hpp"
 
 namespace geoslice {
     constexpr const char* VERSION = "0.0.1";
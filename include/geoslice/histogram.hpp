@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "geoslice/mmap_reader.hpp"
+
+namespace geoslice {
+
+struct HistogramOptions {
+    int bins = 256;
+    // Bin range; defaults to the full type range for 8-bit rasters and to
+    // the band's finite valid data range otherwise. Values outside are not
+    // counted. Both must be finite.
+    std::optional<double> min;
+    std::optional<double> max;
+    std::optional<double> nodata;
+};
+
+struct BandHistogram {
+    double min;  // lower edge of the first bin
+    double max;  // upper edge of the last bin (inclusive)
+    std::vector<uint64_t> counts;
+};
+
+// Per-band histograms over a view. Pixels are spread across several private
+// sub-histograms so consecutive equal values don't serialize on one counter.
+std::vector<BandHistogram> window_histogram(const WindowView& view,
+                                            const HistogramOptions& options = {});
+
+// Same result, rows split across threads (worth it for multi-megapixel windows).
+// threads = 0 uses std::thread::hardware_concurrency().
+std::vector<BandHistogram> window_histogram_parallel(const WindowView& view,
+                                                     const HistogramOptions& options = {},
+                                                     unsigned threads = 0);
+
+} // namespace geoslice
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "geoslice/occupancy.hpp"
+
+namespace geoslice {
+
+// Packed validity bitmask shared by all bands, stored as the optional
+// <base>.mask sidecar: one bit per pixel (1 = valid), most significant bit
+// first, each row padded to a whole byte (numpy.packbits layout).
+// Per-tile Empty/Full/Partial flags are summarized on load so coverage
+// queries rarely need to look at individual bits.
+class NodataMask {
+public:
+    static constexpr int TILE_SIZE = OccupancyIndex::DEFAULT_TILE_SIZE;
+
+    NodataMask(int width, int height, std::vector<uint8_t> bits);
+
+    static NodataMask load(const std::string& path, int width, int height);
+    // Built with pixel_validity(): without a nodata value all pixels are valid
+    static NodataMask from_nodata(const MMapReader& reader);
+    void save(const std::string& path) const;
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    size_t row_bytes() const { return (static_cast<size_t>(width_) + 7) / 8; }
+    const uint8_t* row(int y) const { return bits_.data() + y * row_bytes(); }
+    bool valid(int x, int y) const { return (row(y)[x >> 3] >> (7 - (x & 7))) & 1; }
+
+    const OccupancyIndex& tiles() const { return tiles_; }
+    int tiles_x() const { return tiles_.tiles_x(); }
+    int tiles_y() const { return tiles_.tiles_y(); }
+    Coverage tile(int tx, int ty) const { return tiles_.tile(tx, ty); }
+    Coverage coverage(int x, int y, int width, int height) const;
+
+private:
+    Coverage scan(int x0, int y0, int x1, int y1) const;
+
+    static OccupancyIndex summarize(const NodataMask& mask);
+
+    int width_;
+    int height_;
+    std::vector<uint8_t> bits_;
+    OccupancyIndex tiles_;
+};
+
+} // namespace geoslice
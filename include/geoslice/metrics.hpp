@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace geoslice {
+
+// Optional instrumentation of reader operations. The library records only
+// when built with -DGEOSLICE_METRICS=ON; otherwise the recording macros
+// below compile to nothing and snapshots stay empty. Recording is lock-free
+// (relaxed atomics) and process-wide.
+
+enum class Counter : uint8_t {
+    WindowViews,         // MMapReader::get_window
+    WindowCopies,        // windows copied by MMapReader, FileReader, TiledReader
+    BytesCopied,         // bytes of those copies
+    FileBytesRead,       // bytes FileReader requested from its backend
+    WindowCacheHits,
+    WindowCacheMisses,
+    WindowCacheEvictions,
+    TileCacheHits,       // TiledReader decoded-tile cache
+    TileCacheMisses,
+    TileCacheEvictions,
+    PoolHits,            // ReaderPool
+    PoolMisses,
+    PoolEvictions,
+    PrefetchIssued,      // MMapReader::prefetch calls the kernel accepted
+    PrefetchFailed,      // ... it refused (or chunked readers, which cannot prefetch)
+    PrefetchBytes,       // bytes of accepted prefetches
+    Count,
+};
+
+enum class Op : uint8_t {
+    GetWindow,     // MMapReader::get_window
+    ReadWindow,    // MMapReader::read_window
+    ReadWindows,   // MMapReader::read_windows, whole batch
+    FileRead,      // FileReader::read_window / read_windows, whole submission
+    TiledRead,     // TiledReader::read_window / read_windows
+    TileDecode,    // one tile decompressed and unfiltered
+    Prefetch,      // MMapReader::prefetch
+    Count,
+};
+
+const char* counter_name(Counter counter);
+const char* op_name(Op op);
+
+// True if this build of the library records metrics
+bool metrics_enabled();
+
+// Log-linear latency histogram in nanoseconds, in the style of HdrHistogram:
+// each power of two is split into 2^SUB_BITS buckets, so any recorded value
+// is known to within 12.5% over the whole range.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 3;
+    static constexpr size_t BUCKETS = (65 - SUB_BITS) << SUB_BITS;
+
+    static size_t bucket(uint64_t ns);
+    static uint64_t bucket_upper(size_t bucket);  // largest value in the bucket
+
+    void record(uint64_t ns);
+    void reset();
+
+    std::array<uint64_t, BUCKETS> counts() const;
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum_ns() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t max_ns() const { return max_.load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+struct LatencySummary {
+    uint64_t count = 0;
+    double mean_ns = 0;
+    uint64_t p50_ns = 0, p90_ns = 0, p99_ns = 0, p999_ns = 0, max_ns = 0;
+};
+
+struct MetricsSnapshot {
+    bool enabled = false;
+    std::array<uint64_t, static_cast<size_t>(Counter::Count)> counters{};
+    std::array<LatencySummary, static_cast<size_t>(Op::Count)> latencies{};
+
+    uint64_t counter(Counter c) const { return counters[static_cast<size_t>(c)]; }
+    const LatencySummary& latency(Op op) const { return latencies[static_cast<size_t>(op)]; }
+};
+
+MetricsSnapshot metrics_snapshot();
+void reset_metrics();
+
+// Recording, used by the library itself through the macros below
+void count_metric(Counter counter, uint64_t n);
+void record_latency(Op op, uint64_t ns);
+
+class ScopedLatency {
+public:
+    explicit ScopedLatency(Op op) : op_(op), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        record_latency(op_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start_).count()));
+    }
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    Op op_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace geoslice
+
+#ifdef GEOSLICE_METRICS
+#define GEOSLICE_COUNT(counter, n) ::geoslice::count_metric(::geoslice::Counter::counter, (n))
+#define GEOSLICE_TIME(op) const ::geoslice::ScopedLatency geoslice_scoped_latency(::geoslice::Op::op)
+#else
+#define GEOSLICE_COUNT(counter, n) ((void)0)
+#define GEOSLICE_TIME(op) ((void)0)
+#endif
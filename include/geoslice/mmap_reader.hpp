@@ -2,25 +2,66 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
 #include <string>
+#include <vector>
 #include <array>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 
+#include "geoslice/dtype.hpp"
+#include "geoslice/mask.hpp"
+#include "geoslice/occupancy.hpp"
+
 namespace geoslice {
 
 struct GeoMetadata {
-    std::string dtype;
+    DType dtype_id = DType::UInt8;
     int count;      // bands
     int height;
     int width;
     std::array<double, 6> transform;
     std::string crs;
+    std::optional<double> nodata;  // "nodata" key; absent or null = none
 
-    size_t pixel_size() const;
+    const char* dtype() const { return dtype_name(dtype_id); }  // "uint8", ...
+    size_t pixel_size() const { return dtype_size(dtype_id); }
     size_t total_bytes() const;
 };
 
+struct WindowRect {
+    int x, y, width, height;
+};
+
+// Metadata of <base> without mapping it: the .bin header if present, else
+// the .json. Cheap enough to call for every raster of a large catalog.
+// data_offset, if given, receives where pixel data starts in the .bin.
+GeoMetadata read_metadata(const std::string& base_path, size_t* data_offset = nullptr);
+
+// Fills pixels values of meta's dtype with its nodata value; 0 if there is
+// none or it is not representable (NaN for float rasters with NaN nodata)
+void fill_nodata(const GeoMetadata& meta, void* out, size_t pixels);
+
+template<typename T>
+struct TypedWindowView {
+    using value_type = T;
+
+    const uint8_t* data;
+    int bands;
+    int height;
+    int width;
+    size_t stride_band;
+    size_t stride_row;
+
+    // Rows are contiguous: row(b, y)[0..width) can be iterated directly
+    const T* row(int b, int y) const {
+        return reinterpret_cast<const T*>(data + b * stride_band + y * stride_row);
+    }
+};
+
 struct WindowView {
     const uint8_t* data;
     int bands;
@@ -29,21 +70,70 @@ struct WindowView {
     size_t stride_band;
     size_t stride_row;
     size_t pixel_size;
+    DType dtype;
 
     template<typename T>
     const T* band(int b) const {
         return reinterpret_cast<const T*>(data + b * stride_band);
     }
 
+    template<typename T>
+    const T* row(int b, int y) const {
+        return reinterpret_cast<const T*>(data + b * stride_band + y * stride_row);
+    }
+
+    template<typename T>
+    TypedWindowView<T> typed() const {
+        return TypedWindowView<T>{data, bands, height, width, stride_band, stride_row};
+    }
+
     template<typename T>
     T at(int b, int y, int x) const {
         return *reinterpret_cast<const T*>(data + b * stride_band + y * stride_row + x * pixel_size);
     }
 };
 
+// Dispatches on view.dtype once and calls kernel(TypedWindowView<T>), so the
+// kernel body is compiled per pixel type and its row loops can vectorize.
+template<typename F>
+decltype(auto) visit_window(const WindowView& view, F&& kernel) {
+    return dispatch_dtype(view.dtype, [&](auto tag) -> decltype(auto) {
+        using T = decltype(tag);
+        return kernel(view.typed<T>());
+    });
+}
+
+// Which tiles of a mapped raster are entirely in the page cache
+struct ResidencyMap {
+    int tile_size = 0;
+    int tiles_x = 0;
+    int tiles_y = 0;
+    std::vector<uint64_t> bits;  // row-major, bit set = every page of the tile (all bands) resident
+
+    bool resident(int tx, int ty) const {
+        const size_t i = static_cast<size_t>(ty) * tiles_x + tx;
+        return (bits[i / 64] >> (i % 64)) & 1;
+    }
+    size_t resident_tiles() const;
+};
+
+struct ReaderOptions {
+    // 0 maps the whole .bin at once. Otherwise the raster is mapped on demand
+    // in chunks of whole rows of one band, about this many bytes each, and
+    // at most max_chunks of them stay mapped (least recently used unmapped).
+    size_t chunk_bytes = 0;
+    size_t max_chunks = 4;
+};
+
+class ChunkedMapping;
+
 class MMapReader {
 public:
-    explicit MMapReader(const std::string& base_path);
+    // Maps <base>.bin. Metadata comes from the .bin's RasterHeader when it has
+    // one (no .json needed), otherwise from <base>.json. In chunked mode the
+    // reader keeps its fd open to map chunks later and has no zero-copy
+    // views: get_window() throws, read_window() and scan_tiles() copy.
+    explicit MMapReader(const std::string& base_path, const ReaderOptions& options = {});
     ~MMapReader();
 
     MMapReader(const MMapReader&) = delete;
@@ -51,19 +141,85 @@ public:
     MMapReader(MMapReader&&) noexcept;
     MMapReader& operator=(MMapReader&&) noexcept;
 
+    // Zero-copy view; throws std::logic_error in chunked mode
     WindowView get_window(int x, int y, int width, int height) const;
     bool is_valid_window(int x, int y, int width, int height) const;
 
+    // Asks the kernel to start reading the window's pages (MADV_WILLNEED),
+    // e.g. the next waypoint's window while the current one is processed,
+    // so the later read does not fault them in one at a time. Returns false
+    // if the kernel refused, and always in chunked mode.
+    bool prefetch(int x, int y, int width, int height) const;
+    // Fraction of the window's pages (all bands) in the page cache right
+    // now (mincore), i.e. how much of a read would be served without I/O.
+    // Both throw std::logic_error in chunked mode.
+    double residency(int x, int y, int width, int height) const;
+    ResidencyMap residency_map(int tile_size = 256) const;
+
+    // Copies a window into out as (bands, height, width). Tiles the occupancy
+    // index (or mask) reports as all-nodata are filled with the nodata value
+    // (or 0) without touching the mapping.
+    void read_window(int x, int y, int width, int height, void* out) const;
+    // Copies band `band` of a window into out as (height, width); parallel
+    // copies (CopyEngine) split a window into such stripes
+    void read_band(int band, int x, int y, int width, int height, void* out) const;
+    // read_window on io_executor(), for callers that must not block on page
+    // faults (event loops). The window is checked here; the reader and out
+    // must stay valid until the read completes. done gets the read's
+    // exception or nullptr, on the I/O thread, and must not throw.
+    std::future<void> read_window_async(int x, int y, int width, int height, void* out) const;
+    void read_window_async(int x, int y, int width, int height, void* out,
+                           std::function<void(std::exception_ptr)> done) const;
+    // outs[i] receives windows[i]; threads = 0 uses all cores
+    void read_windows(const std::vector<WindowRect>& windows, const std::vector<void*>& outs,
+                      unsigned threads = 1) const;
+
+    // Visits the raster tile by tile in row-major order. Empty tiles get a
+    // null view, so a full scan never faults in their pages. In chunked mode
+    // views point at a tile copy valid only during the call.
+    void scan_tiles(const std::function<void(const WindowRect&, const WindowView*)>& fn) const;
+
+    // Exact with a <base>.mask, tile-level with only a <base>.occ, and
+    // Coverage::Partial when neither sidecar exists
+    Coverage coverage(int x, int y, int width, int height) const;
+    bool has_mask() const { return mask_.has_value(); }
+    const NodataMask* mask() const { return mask_ ? &*mask_ : nullptr; }
+    const OccupancyIndex* occupancy() const { return occupancy_ ? &*occupancy_ : nullptr; }
+
     const GeoMetadata& metadata() const { return meta_; }
     int width() const { return meta_.width; }
     int height() const { return meta_.height; }
     int bands() const { return meta_.count; }
+    // Byte offset of the pixel data in the .bin (0 without a header)
+    size_t data_offset() const { return data_offset_; }
+    // Address space the reader may map: the file, or its chunk budget
+    size_t mapped_bytes() const;
+    bool chunked() const { return chunks_ != nullptr; }
+    size_t mapped_chunks() const;  // chunks mapped right now (0 if not chunked)
 
 private:
+    void open_chunked(const std::string& base_path, int fd, size_t file_size, const ReaderOptions& options);
+    void load_sidecars(const std::string& base_path);
+
+    // Calls fn(y, row) for y in [y0, y1), row pointing at column 0 of that
+    // raster row of band b, and valid only during the call
+    template<typename F>
+    void for_each_row(int b, int y0, int y1, F&& fn) const;
+    // Copies band b of a window of coverage cov into dst, rows packed
+    void copy_band(int b, int x, int y, int width, int height, Coverage cov, uint8_t* dst) const;
+    // Calls fn(start, end) for each run of touching pages holding the
+    // window's rows, as page-aligned addresses; fully mapped mode only
+    template<typename F>
+    void for_each_page_run(int x, int y, int width, int height, F&& fn) const;
+
     GeoMetadata meta_;
+    std::optional<NodataMask> mask_;
+    std::optional<OccupancyIndex> occupancy_;
     void* mapped_data_ = nullptr;
+    const uint8_t* data_ = nullptr;  // pixel data, past the header if any
     size_t mapped_size_ = 0;
-    int fd_ = -1;
+    size_t data_offset_ = 0;
+    std::unique_ptr<ChunkedMapping> chunks_;  // set in chunked mode only
 };
 
 } // namespace geoslice
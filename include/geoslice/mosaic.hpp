@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "geoslice/mmap_reader.hpp"
+#include "geoslice/reader_pool.hpp"
+
+namespace geoslice {
+
+// Serves windows from a catalog of adjacent rasters (e.g. orthophoto tiles,
+// each its own .bin/.json pair) as one virtual raster. Sources must share
+// dtype, band count, CRS, nodata and pixel size, be north-up and sit on a
+// common pixel grid. Only metadata is read up front; a uniform grid index over the
+// source extents finds the sources a window touches, and sources are mapped
+// through a ReaderPool when a window needs them, so a catalog of any size
+// stays within the pool's mapping budget.
+class MosaicReader {
+public:
+    // Throws std::invalid_argument for an empty or incompatible catalog.
+    // Without a pool the mosaic gets its own with the default budget; pass
+    // one to share a budget between mosaics.
+    explicit MosaicReader(const std::vector<std::string>& base_paths,
+                          std::shared_ptr<ReaderPool> pool = nullptr);
+
+    MosaicReader(const MosaicReader&) = delete;
+    MosaicReader& operator=(const MosaicReader&) = delete;
+
+    // Copies a window in mosaic pixel coordinates into out as (bands, height,
+    // width), stitched across source boundaries. Pixels no source covers get
+    // the mosaic nodata value (or 0); where sources overlap, the later one in
+    // the catalog wins except at its nodata pixels, which keep the earlier
+    // sources' values. Safe to call from several threads.
+    void read_window(int x, int y, int width, int height, void* out) const;
+    bool is_valid_window(int x, int y, int width, int height) const;
+
+    // Sources whose extent intersects the window, in catalog order
+    std::vector<size_t> sources_in(int x, int y, int width, int height) const;
+    // Extent of source i in mosaic pixel coordinates
+    const WindowRect& source_extent(size_t i) const { return extents_[i]; }
+    const std::string& source_path(size_t i) const { return paths_[i]; }
+    size_t num_sources() const { return paths_.size(); }
+    size_t open_sources() const;  // currently mapped in the pool
+    ReaderPool& pool() const { return *pool_; }
+
+    // Grid of the whole mosaic: transform origin is the top-left corner of
+    // the union of the sources, nodata and CRS come from the first source
+    const GeoMetadata& metadata() const { return meta_; }
+    int width() const { return meta_.width; }
+    int height() const { return meta_.height; }
+    int bands() const { return meta_.count; }
+
+private:
+    std::shared_ptr<const MMapReader> source(size_t i) const;
+
+    GeoMetadata meta_;
+    std::vector<std::string> paths_;
+    std::vector<WindowRect> extents_;
+
+    // Uniform grid index: cells_[cy * cells_x_ + cx] lists the sources
+    // intersecting that cell
+    int cell_size_ = 0;
+    int cells_x_ = 0;
+    int cells_y_ = 0;
+    std::vector<std::vector<uint32_t>> cells_;
+
+    std::shared_ptr<ReaderPool> pool_;
+};
+
+} // namespace geoslice
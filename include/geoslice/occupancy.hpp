@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace geoslice {
+
+class MMapReader;
+
+enum class Coverage : uint8_t {
+    Empty = 0,    // every pixel is nodata
+    Full = 1,     // every pixel is valid
+    Partial = 2,  // mixed (or unknown): the data has to be read
+};
+
+// One Coverage byte per square tile, stored as the optional <base>.occ
+// sidecar written at conversion time. Readers consult it to synthesize
+// empty tiles as nodata fills instead of faulting in their pages.
+//
+// File layout (little-endian): "GSOC", uint32 tile_size, uint32 tiles_x,
+// uint32 tiles_y, then tiles_x * tiles_y coverage bytes in row-major order.
+class OccupancyIndex {
+public:
+    static constexpr int DEFAULT_TILE_SIZE = 256;
+
+    OccupancyIndex(int width, int height, int tile_size, std::vector<Coverage> tiles);
+
+    static OccupancyIndex load(const std::string& path, int width, int height);
+    // Scans the raster once; see pixel_validity() for what counts as valid
+    static OccupancyIndex build(const MMapReader& reader, int tile_size = DEFAULT_TILE_SIZE);
+    void save(const std::string& path) const;
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int tile_size() const { return tile_size_; }
+    int tiles_x() const { return tiles_x_; }
+    int tiles_y() const { return tiles_y_; }
+    Coverage tile(int tx, int ty) const { return tiles_[ty * tiles_x_ + tx]; }
+    size_t empty_tiles() const;
+
+    // Tile-level answer: Partial as soon as a non-uniform tile is touched
+    Coverage coverage(int x, int y, int width, int height) const;
+
+private:
+    int width_;
+    int height_;
+    int tile_size_;
+    int tiles_x_;
+    int tiles_y_;
+    std::vector<Coverage> tiles_;
+};
+
+// valid[x] = 1 when any band at (x, y) is not the raster's nodata value (and
+// not NaN for float rasters), else 0. valid must hold reader.width() bytes.
+void pixel_validity(const MMapReader& reader, int y, uint8_t* valid);
+
+} // namespace geoslice
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+#include "geoslice/thread_pool.hpp"
+
+namespace geoslice {
+
+inline unsigned resolve_threads(unsigned threads, size_t tasks) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(tasks, 1)));
+}
+
+// Runs fn(i) for i in [0, n) on up to `threads` threads (0 = all cores),
+// the calling thread included; the others are tasks of default_executor(),
+// so nested loops share its threads instead of starting their own. Tasks
+// are handed out dynamically. The first exception stops further tasks and
+// is rethrown once the tasks already started are done.
+template<typename F>
+void parallel_for(size_t n, unsigned threads, F&& fn) {
+    threads = resolve_threads(threads, n);
+    if (threads == 1) {
+        for (size_t i = 0; i < n; i++) fn(i);
+        return;
+    }
+    detail::run_parallel(*default_executor(), threads - 1, n, [&fn](size_t i) { fn(i); });
+}
+
+// Like parallel_for, but calls fn(worker, i) where worker in
+// [0, resolve_threads(threads, n)) names the task running it. Lets a loop
+// keep scratch buffers per call, indexed by worker, instead of thread_local
+// ones that the pool threads would hold on to after the loop returns.
+template<typename F>
+void parallel_for_workers(size_t n, unsigned threads, F&& fn) {
+    const unsigned workers = resolve_threads(threads, n);
+    std::atomic<size_t> next{0};
+    parallel_for(workers, workers, [&](size_t worker) {
+        try {
+            for (size_t i; (i = next++) < n;) fn(worker, i);
+        } catch (...) {
+            next = n;  // stop the other workers
+            throw;
+        }
+    });
+}
+
+} // namespace geoslice
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "geoslice/mmap_reader.hpp"
+
+namespace geoslice {
+
+enum class Interleave : uint8_t {
+    BSQ = 0,    // band sequential: (bands, height, width)
+    Tiled = 1,  // compressed (bands, tile, tile) blocks, see tiled_raster.hpp
+};
+
+// Optional fixed-layout header at the start of a .bin, which makes the file
+// self-describing: readers take the metadata from it instead of parsing the
+// .json. Pixel data starts at data_offset (HEADER_DATA_OFFSET when written
+// by geoslice, so it stays page aligned). All fields are little-endian.
+struct RasterHeader {
+    char magic[4];           // "GSRH"
+    uint16_t version;        // HEADER_VERSION
+    uint8_t dtype;           // DType value
+    uint8_t interleave;      // Interleave value
+    uint32_t count;
+    uint32_t height;
+    uint32_t width;
+    uint32_t flags;          // HEADER_HAS_NODATA
+    uint64_t data_offset;    // from the start of the file
+    double transform[6];
+    double nodata;
+    char crs[168];           // NUL-padded, empty = none
+};
+static_assert(sizeof(RasterHeader) == 256, "RasterHeader layout is part of the file format");
+
+constexpr char HEADER_MAGIC[4] = {'G', 'S', 'R', 'H'};
+constexpr uint16_t HEADER_VERSION = 1;
+constexpr uint32_t HEADER_HAS_NODATA = 1u << 0;
+constexpr size_t HEADER_DATA_OFFSET = 4096;
+
+// Throws std::invalid_argument if the CRS does not fit the fixed field
+RasterHeader make_header(const GeoMetadata& meta);
+
+// Fills meta and data_offset from a header at the start of data, where
+// size is the size of the whole file and data holds at least
+// min(size, sizeof(RasterHeader)) bytes. Returns false if data does not start
+// with the header magic; throws std::runtime_error for an unsupported or
+// inconsistent header, or one whose layout is not `layout`. Does not
+// allocate (the CRS fits std::string's inline buffer for EPSG codes).
+bool parse_header(const void* data, size_t size, GeoMetadata& meta, size_t& data_offset,
+                  Interleave layout = Interleave::BSQ);
+
+} // namespace geoslice
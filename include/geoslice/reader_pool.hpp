@@ -0,0 +1,62 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "geoslice/mmap_reader.hpp"
+
+namespace geoslice {
+
+// Opens rasters on demand and keeps the most recently used ones mapped,
+// within a budget on the number of mappings (vm.max_map_count) and on mapped
+// address space. Readers hold no file descriptor once mapped. An evicted
+// reader stays valid for callers still holding it and is unmapped when the
+// last of them lets go.
+class ReaderPool {
+public:
+    static constexpr size_t DEFAULT_MAX_READERS = 1024;
+
+    // max_mapped_bytes = 0 means no address-space limit. reader_options
+    // applies to every reader opened, e.g. chunked mapping for huge rasters
+    // (which then count their chunk budget, not their file size).
+    explicit ReaderPool(size_t max_readers = DEFAULT_MAX_READERS, size_t max_mapped_bytes = 0,
+                        const ReaderOptions& reader_options = {});
+
+    ReaderPool(const ReaderPool&) = delete;
+    ReaderPool& operator=(const ReaderPool&) = delete;
+
+    // Maps <base_path> if it is not open yet; thread-safe
+    std::shared_ptr<const MMapReader> acquire(const std::string& base_path);
+    bool contains(const std::string& base_path) const;
+    void clear();
+
+    size_t size() const;
+    size_t mapped_bytes() const;
+    size_t max_readers() const { return max_readers_; }
+    size_t max_mapped_bytes() const { return max_mapped_bytes_; }
+    size_t hits() const;
+    size_t misses() const;
+    size_t evictions() const;
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const MMapReader>>;
+
+    void evict_if_needed(size_t needed_bytes);
+
+    size_t max_readers_;
+    size_t max_mapped_bytes_;
+    ReaderOptions reader_options_;
+    size_t current_bytes_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t evictions_ = 0;
+
+    std::list<Entry> lru_list_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> readers_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace geoslice
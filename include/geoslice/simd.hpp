@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+namespace geoslice {
+
+// The library is built for the baseline ISA of the target (no -march=native
+// unless GEOSLICE_NATIVE=ON), so one binary runs on any CPU of the
+// architecture. Hot pixel kernels are compiled once per x86 ISA level with
+// GEOSLICE_MULTIVERSION and the loader picks the best clone for the running
+// CPU. On aarch64 NEON is part of the baseline and needs no dispatch.
+// Bulk copies go through memcpy, which glibc already dispatches.
+
+// ISA level the multiversioned kernels run at on this CPU: "avx512f",
+// "avx2", "sse4.2", "neon" or "baseline"
+const char* simd_level();
+
+} // namespace geoslice
+
+// Marks a kernel for per-ISA compilation with run-time selection (GCC/Clang
+// target_clones through an ifunc resolver, so x86 with glibc only)
+#if defined(__x86_64__) && defined(__GLIBC__) && (defined(__GNUC__) || defined(__clang__))
+#define GEOSLICE_MULTIVERSION __attribute__((target_clones("default", "sse4.2", "avx2", "avx512f")))
+#else
+#define GEOSLICE_MULTIVERSION
+#endif
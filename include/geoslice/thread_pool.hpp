@@ -0,0 +1,95 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace geoslice {
+
+// Where the library's parallel loops (parallel_for: batch reads, statistics,
+// histograms, conversion, tile writes) run their work. Applications with
+// their own scheduler can install an adapter with set_default_executor().
+class Executor {
+public:
+    virtual ~Executor() = default;
+    // Runs task on some thread, eventually; must not run it inline
+    virtual void submit(std::function<void()> task) = 0;
+    // Threads that may run tasks at once
+    virtual size_t concurrency() const = 0;
+};
+
+struct ThreadPoolOptions {
+    unsigned threads = 0;   // 0 = std::thread::hardware_concurrency()
+    std::vector<int> cpus;  // if not empty, workers only run on these CPUs
+};
+
+// Work-stealing pool: every worker has its own deque. Tasks submitted by a
+// worker (nested parallel loops) go to the front of its deque and run
+// there first; others come in through a shared queue, and idle workers
+// steal from the back of busy ones. Tasks still queued when the pool is
+// destroyed are run before the workers exit.
+class ThreadPool : public Executor {
+public:
+    explicit ThreadPool(const ThreadPoolOptions& options = {});
+    ~ThreadPool() override;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task) override;
+    size_t concurrency() const override;
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;  // shared with the workers
+    std::vector<std::thread> threads_;
+};
+
+// The executor parallel_for submits to: a ThreadPool created on first use,
+// unless replaced. Replacing it does not affect loops already running.
+std::shared_ptr<Executor> default_executor();
+// nullptr goes back to a fresh built-in pool
+void set_default_executor(std::shared_ptr<Executor> executor);
+// Replaces the default executor with a new ThreadPool
+void configure_thread_pool(const ThreadPoolOptions& options);
+
+// Runs blocking reads (read_window_async, pread batches): page faults and
+// syscalls park these threads, not the compute pool's. A ThreadPool of
+// IO_THREADS workers created on first use, unless replaced; nullptr goes
+// back to it.
+constexpr unsigned IO_THREADS = 16;
+std::shared_ptr<Executor> io_executor();
+void set_io_executor(std::shared_ptr<Executor> executor);
+
+// Keeps thread on the given CPUs; best effort, ignored if refused
+void pin_thread(std::thread& thread, const std::vector<int>& cpus);
+
+namespace detail {
+// n items claimed one at a time by the caller and by helper tasks. Helpers
+// that start after the last item was claimed find nothing left: the caller
+// waits for the items, not for the helpers. The first exception skips the
+// unclaimed items.
+struct ParallelJob {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t next = 0;
+    size_t count = 0;
+    size_t running = 0;
+    std::exception_ptr error;
+    std::function<void(size_t)> fn;
+
+    void work();
+    void wait();
+};
+
+// Runs fn(i) for i in [0, n) with up to helpers tasks on executor beside the
+// calling thread, and rethrows the first exception
+void run_parallel(Executor& executor, size_t helpers, size_t n, std::function<void(size_t)> fn);
+}
+
+} // namespace geoslice
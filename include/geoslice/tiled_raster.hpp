@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "geoslice/codec.hpp"
+#include "geoslice/mmap_reader.hpp"
+
+namespace geoslice {
+
+// Compressed tiled raster, <base>.gsz:
+//   RasterHeader    interleave = Tiled, data_offset = offset of the directory
+//   TileDirectory
+//   uint64_t[tiles_x * tiles_y + 1]  tile offsets from the start of the file
+//   tile blocks, row-major
+// A tile block holds all bands of one tile as (bands, tile_h, tile_w), edge
+// tiles clipped to the raster. A block exactly as long as its raw tile is
+// stored uncompressed (incompressible data never grows). Compressed blocks
+// hold the tile after the directory's filter, applied per row of each band.
+struct TileDirectory {
+    uint32_t tile_size;
+    uint8_t codec;   // TileCodec value
+    uint8_t filter;  // TileFilter value
+    uint16_t reserved;
+    uint32_t tiles_x;
+    uint32_t tiles_y;
+};
+static_assert(sizeof(TileDirectory) == 16, "TileDirectory layout is part of the file format");
+
+struct TiledOptions {
+    TileCodec codec = TileCodec::LZ4;
+    TileFilter filter = TileFilter::None;  // default_filter(dtype) suits most rasters
+    int tile_size = 256;   // clamped to the raster's larger side
+    unsigned threads = 0;  // tiles are compressed in parallel, 0 = all cores
+    bool overwrite = false;
+};
+
+// Writes <output_base>.gsz from the raw raster <base_path> (.bin + header
+// or .json). Returns the raster's metadata.
+GeoMetadata write_tiled_raster(const std::string& base_path, const std::string& output_base,
+                               const TiledOptions& options = {});
+
+struct TiledReaderOptions {
+    size_t cache_bytes = 256 * 1024 * 1024;  // decompressed tiles kept, LRU
+    unsigned threads = 0;                    // tiles decoded in parallel, 0 = all cores
+};
+
+// Window reads from a .gsz with the same contract as MMapReader::read_window.
+// Only the tiles a window intersects are decompressed, in parallel, and kept
+// in an LRU cache of decompressed tiles shared by all reads of this reader.
+class TiledReader {
+public:
+    explicit TiledReader(const std::string& base_path, const TiledReaderOptions& options = {});
+    ~TiledReader();
+
+    TiledReader(const TiledReader&) = delete;
+    TiledReader& operator=(const TiledReader&) = delete;
+
+    // Copies a window into out as (bands, height, width). Thread-safe.
+    void read_window(int x, int y, int width, int height, void* out) const;
+    // outs[i] receives windows[i]; tiles shared by several windows are
+    // decoded once
+    void read_windows(const std::vector<WindowRect>& windows, const std::vector<void*>& outs) const;
+    bool is_valid_window(int x, int y, int width, int height) const;
+
+    const GeoMetadata& metadata() const { return meta_; }
+    int width() const { return meta_.width; }
+    int height() const { return meta_.height; }
+    int bands() const { return meta_.count; }
+    int tile_size() const { return static_cast<int>(dir_.tile_size); }
+    TileCodec codec() const { return static_cast<TileCodec>(dir_.codec); }
+    TileFilter filter() const { return static_cast<TileFilter>(dir_.filter); }
+    size_t num_tiles() const { return static_cast<size_t>(dir_.tiles_x) * dir_.tiles_y; }
+    size_t file_bytes() const { return mapped_size_; }
+
+    size_t cached_tiles() const;
+    size_t cached_bytes() const;
+    size_t cache_hits() const;
+    size_t cache_misses() const;  // tiles decoded
+    void clear_cache();
+
+private:
+    using Tile = std::shared_ptr<const std::vector<uint8_t>>;
+
+    WindowRect tile_rect(size_t tile) const;
+    // Decoded tiles for the given tile indices (sorted, unique), through the cache
+    std::vector<Tile> load_tiles(const std::vector<size_t>& tiles) const;
+    std::vector<uint8_t> decode_tile(size_t tile) const;
+    void tiles_in(const WindowRect& window, std::vector<size_t>& tiles) const;
+    void copy_from_tiles(const WindowRect& window, const std::vector<size_t>& tiles,
+                         const std::vector<Tile>& decoded, void* out) const;
+
+    GeoMetadata meta_;
+    TileDirectory dir_{};
+    unsigned threads_;
+    void* mapped_data_ = nullptr;
+    size_t mapped_size_ = 0;
+    const uint64_t* offsets_ = nullptr;
+
+    size_t cache_capacity_;
+    mutable size_t cache_bytes_ = 0;
+    mutable size_t hits_ = 0;
+    mutable size_t misses_ = 0;
+    mutable std::list<std::pair<size_t, Tile>> lru_list_;
+    mutable std::unordered_map<size_t, std::list<std::pair<size_t, Tile>>::iterator> cache_map_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace geoslice
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace geoslice {
+
+// Scoped trace events for finding where the time of a stutter went (page
+// faults inside copies, transforms, cache lock waits). Each thread appends
+// to its own ring of the last events_per_thread events, without locks;
+// dump_trace() writes them as Chrome trace JSON (chrome://tracing,
+// ui.perfetto.dev). The library's trace points exist only when built with
+// -DGEOSLICE_TRACE=ON, and record only between start_tracing() and
+// stop_tracing(); ScopedTrace itself is always available to applications.
+
+struct TraceEvent {
+    const char* name;      // static or intern_trace_name() string
+    uint64_t start_ns;     // since start_tracing()
+    uint64_t duration_ns;
+};
+
+// Discards earlier events and starts recording
+void start_tracing(size_t events_per_thread = 1 << 16);
+void stop_tracing();
+// True if this build of the library has its own trace points
+bool trace_points_enabled();
+
+// Writes the recorded events as Chrome trace JSON; returns how many. Call
+// after stop_tracing() for a consistent dump: rings still being written
+// may yield a few torn events.
+size_t dump_trace(const std::string& path);
+
+// Stable copy of name, for event names built at run time (e.g. in Python)
+const char* intern_trace_name(const std::string& name);
+
+namespace detail {
+inline std::atomic<bool> tracing_on{false};
+uint64_t trace_now_ns();
+void record_trace(const char* name, uint64_t start_ns, uint64_t duration_ns);
+}
+
+inline bool tracing_active() { return detail::tracing_on.load(std::memory_order_relaxed); }
+
+class ScopedTrace {
+public:
+    explicit ScopedTrace(const char* name)
+        : name_(tracing_active() ? name : nullptr)
+        , start_(name_ ? detail::trace_now_ns() : 0) {}
+    ~ScopedTrace() {
+        if (name_) detail::record_trace(name_, start_, detail::trace_now_ns() - start_);
+    }
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+};
+
+} // namespace geoslice
+
+// GEOSLICE_TRACE_SCOPE("name") traces the rest of the enclosing scope;
+// GEOSLICE_TRACED_LOCK(lock, m, "name") declares a lock of the std::mutex m,
+// tracing the wait for it
+#ifdef GEOSLICE_TRACE
+#define GEOSLICE_TRACE_SCOPE(name) const ::geoslice::ScopedTrace geoslice_scoped_trace(name)
+#define GEOSLICE_TRACED_LOCK(lock, m, name)                              \
+    std::unique_lock<std::mutex> lock(m, std::defer_lock);               \
+    {                                                                    \
+        const ::geoslice::ScopedTrace geoslice_lock_trace(name);         \
+        lock.lock();                                                     \
+    }
+#else
+#define GEOSLICE_TRACE_SCOPE(name) ((void)0)
+#define GEOSLICE_TRACED_LOCK(lock, m, name) std::lock_guard<std::mutex> lock(m)
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "geoslice/mmap_reader.hpp"
+
+namespace geoslice {
+
+struct BandStats {
+    double min;
+    double max;
+    double mean;
+    double std;          // population standard deviation
+    size_t valid_count;  // pixels that are not nodata (or NaN for float rasters)
+};
+
+// Per-band statistics in a single pass over the view's rows, no copy.
+// Bands without valid pixels report NaN for min/max/mean/std.
+std::vector<BandStats> window_stats(const WindowView& view,
+                                    std::optional<double> nodata = std::nullopt);
+
+// Statistics for many windows of one raster, computed in parallel.
+// threads = 0 uses std::thread::hardware_concurrency().
+std::vector<std::vector<BandStats>> window_stats_batch(
+    const MMapReader& reader,
+    const std::vector<WindowRect>& windows,
+    std::optional<double> nodata = std::nullopt,
+    unsigned threads = 0);
+
+} // namespace geoslice
@@ -5,7 +5,13 @@ try:
 except ImportError:
     __version__ = "0.0.0.dev0"  # Fallback for editable installs without build
 
-from .core import FastGeoMap, GeoTransform, convert_tif_to_raw
+from .core import (
+    FastGeoMap,
+    GeoTransform,
+    convert_tif_to_raw,
+    read_raster_header,
+    write_occupancy_index,
+)
 from .drone import DroneState, FlightPath
 
 __all__ = [
@@ -14,6 +20,8 @@ __all__ = [
     "DroneState",
     "FlightPath",
     "convert_tif_to_raw",
+    "read_raster_header",
+    "write_occupancy_index",
 ]
 
 # Try to import C++ backend
@@ -2,13 +2,15 @@
 
 from __future__ import annotations
 
+import asyncio
 import json
 import math
 import os
+import struct
 import subprocess
 from dataclasses import dataclass
 from pathlib import Path
-from typing import Optional, Tuple, Union
+from typing import List, Optional, Sequence, Tuple, Union
 
 import numpy as np
 
@@ -21,6 +23,19 @@ try:
 except ImportError:
     _USE_CPP = False
 
+try:
+    from ._geoslice_cpp import convert_tiff as _cpp_convert_tiff
+except ImportError:
+    _cpp_convert_tiff = None
+
+
+# Binary .bin header (see include/geoslice/raster_header.hpp)
+_HEADER_MAGIC = b"GSRH"
+_HEADER_FORMAT = "<4sHBBIIIIQ6dd168s"
+_HEADER_SIZE = struct.calcsize(_HEADER_FORMAT)  # 256
+_HEADER_DTYPES = ("uint8", "int8", "uint16", "int16", "uint32", "int32", "float32", "float64")
+_HEADER_HAS_NODATA = 1
+
 
 @dataclass
 class GeoMetadata:
@@ -32,6 +47,39 @@ class GeoMetadata:
     width: int
     transform: Tuple[float, ...]
     crs: Optional[str] = None
+    nodata: Optional[float] = None
+
+
+def read_raster_header(bin_path: Union[str, Path]) -> Optional[Tuple["GeoMetadata", int]]:
+    """
+    Read the optional binary header at the start of a ``.bin``.
+
+    Returns:
+        (metadata, data_offset), or None if the file has no header
+    """
+    with open(bin_path, "rb") as f:
+        raw = f.read(_HEADER_SIZE)
+    if len(raw) < _HEADER_SIZE or raw[:4] != _HEADER_MAGIC:
+        return None
+
+    (_, version, dtype, interleave, count, height, width, flags, data_offset, *rest) = struct.unpack(
+        _HEADER_FORMAT, raw
+    )
+    transform, nodata, crs = tuple(rest[:6]), rest[6], rest[7]
+    if version != 1 or dtype >= len(_HEADER_DTYPES) or interleave != 0:
+        raise ValueError(f"Unsupported raster header in {bin_path}")
+
+    crs = crs.split(b"\0", 1)[0].decode()
+    meta = GeoMetadata(
+        dtype=_HEADER_DTYPES[dtype],
+        count=count,
+        height=height,
+        width=width,
+        transform=transform,
+        crs=crs or None,
+        nodata=nodata if flags & _HEADER_HAS_NODATA else None,
+    )
+    return meta, data_offset
 
 
 class FastGeoMap:
@@ -39,7 +87,8 @@ class FastGeoMap:
     Zero-copy memory-mapped geospatial raster reader.
 
     Args:
-        base_name: Path without extension (expects .bin and .json files)
+        base_name: Path without extension (expects a .bin, plus a .json unless
+            the .bin starts with a binary header)
         use_cpp: Force C++ backend (None = auto-detect)
 
     Example:
@@ -55,29 +104,37 @@ class FastGeoMap:
         json_path = f"{self._base_name}.json"
         bin_path = f"{self._base_name}.bin"
 
-        if not os.path.exists(json_path):
-            raise FileNotFoundError(f"Metadata not found: {json_path}")
         if not os.path.exists(bin_path):
             raise FileNotFoundError(f"Binary data not found: {bin_path}")
 
-        with open(json_path) as f:
-            meta_dict = json.load(f)
-
-        self.meta = GeoMetadata(
-            dtype=meta_dict["dtype"],
-            count=meta_dict["count"],
-            height=meta_dict["height"],
-            width=meta_dict["width"],
-            transform=tuple(meta_dict["transform"]),
-            crs=meta_dict.get("crs"),
-        )
+        header = read_raster_header(bin_path)
+        if header is not None:
+            self.meta, self._data_offset = header
+        else:
+            if not os.path.exists(json_path):
+                raise FileNotFoundError(f"Metadata not found: {json_path}")
+            with open(json_path) as f:
+                meta_dict = json.load(f)
+
+            self.meta = GeoMetadata(
+                dtype=meta_dict["dtype"],
+                count=meta_dict["count"],
+                height=meta_dict["height"],
+                width=meta_dict["width"],
+                transform=tuple(meta_dict["transform"]),
+                crs=meta_dict.get("crs"),
+                nodata=meta_dict.get("nodata"),
+            )
+            self._data_offset = 0
 
         if self._use_cpp:
             self._reader = _CppReader(self._base_name)
         else:
             self._shape = (self.meta.count, self.meta.height, self.meta.width)
             self._dtype = np.dtype(self.meta.dtype)
-            self._data = np.memmap(bin_path, dtype=self._dtype, mode="r", shape=self._shape)
+            self._data = np.memmap(
+                bin_path, dtype=self._dtype, mode="r", offset=self._data_offset, shape=self._shape
+            )
 
     @property
     def width(self) -> int:
@@ -135,8 +192,53 @@ class FastGeoMap:
 
     def get_window_copy(self, x: int, y: int, width: int, height: int) -> np.ndarray:
         """Get a copy of a window (safe for modification)."""
+        if self._use_cpp:
+            return self._reader.get_window_copy(x, y, width, height)
         return np.array(self.get_window(x, y, width, height))
 
+    async def get_windows_async(
+        self, windows: Sequence[Tuple[int, int, int, int]]
+    ) -> List[np.ndarray]:
+        """
+        Copies of many (x, y, width, height) windows without blocking the
+        event loop.
+
+        With the C++ backend the copies run on its I/O thread pool, without
+        the GIL, and complete an asyncio future, so page faults on a cold
+        raster never stall the loop and many requests can be in flight.
+        Otherwise they run in the loop's default executor.
+        """
+        loop = asyncio.get_running_loop()
+        if not self._use_cpp:
+            return await loop.run_in_executor(
+                None, lambda: [self.get_window_copy(*w) for w in windows]
+            )
+
+        future = loop.create_future()
+
+        def done(arrays, error):
+            # Called on an I/O thread
+            try:
+                loop.call_soon_threadsafe(_complete_future, future, arrays, error)
+            except RuntimeError:
+                pass  # loop closed: nobody is waiting any more
+
+        self._reader.read_windows_async([list(w) for w in windows], done)
+        return await future
+
+    async def get_window_copy_async(self, x: int, y: int, width: int, height: int) -> np.ndarray:
+        """Awaitable get_window_copy(); see get_windows_async()."""
+        return (await self.get_windows_async([(x, y, width, height)]))[0]
+
+
+def _complete_future(future: asyncio.Future, arrays, error: Optional[str]) -> None:
+    if future.cancelled():
+        return
+    if error is not None:
+        future.set_exception(RuntimeError(error))
+    else:
+        future.set_result(list(arrays))
+
 
 class GeoTransform:
     """
@@ -277,19 +379,38 @@ def convert_tif_to_raw(
     input_path: Union[str, Path],
     output_base: Union[str, Path],
     overwrite: bool = False,
+    write_mask: bool = False,
+    write_occupancy: bool = False,
+    tile_size: int = 256,
+    backend: str = "auto",
+    write_header: bool = False,
 ) -> Tuple[str, str]:
     """
     Convert a GeoTIFF to raw binary format for memory mapping.
 
+    The native backend decodes the TIFF in C++ (stripped/tiled, uncompressed,
+    LZW, PackBits or Deflate) in parallel, with no GDAL subprocess. ``"auto"``
+    uses it when the extension is built and falls back to GDAL for files it
+    cannot read (JPEG, palette, sub-byte samples, ...).
+
     Args:
         input_path: Path to input GeoTIFF
         output_base: Base path for output (without extension)
         overwrite: Overwrite existing files
+        write_mask: Also write the packed validity mask sidecar (``.mask``)
+        write_occupancy: Also write the per-tile occupancy index (``.occ``)
+        tile_size: Occupancy index tile size in pixels
+        backend: ``"native"``, ``"gdal"`` or ``"auto"``
+        write_header: Prefix the ``.bin`` with the binary metadata header
+            (native backend only); the ``.json`` is still written
 
     Returns:
         Tuple of (bin_path, json_path)
     """
-    import rasterio
+    if backend not in ("auto", "native", "gdal"):
+        raise ValueError(f"Unknown backend: {backend}")
+    if write_header and backend == "gdal":
+        raise ValueError("write_header requires the native backend")
 
     input_path = str(input_path)
     output_base = str(output_base)
@@ -299,6 +420,31 @@ def convert_tif_to_raw(
     if not overwrite and (os.path.exists(bin_path) or os.path.exists(json_path)):
         raise FileExistsError(f"Output files already exist: {output_base}.*")
 
+    if backend != "gdal":
+        if _cpp_convert_tiff is None:
+            if backend == "native":
+                raise RuntimeError("Native converter requires the C++ extension")
+        else:
+            try:
+                _cpp_convert_tiff(
+                    input_path,
+                    output_base,
+                    overwrite=True,
+                    write_mask=write_mask,
+                    write_occupancy=write_occupancy,
+                    tile_size=tile_size,
+                    write_header=write_header,
+                )
+                return bin_path, json_path
+            except (RuntimeError, ValueError):
+                if backend == "native" or write_header:
+                    raise
+
+    if write_header:
+        raise RuntimeError("write_header requires the C++ extension")
+
+    import rasterio
+
     # Convert using GDAL
     cmd = [
         "gdal_translate",
@@ -320,7 +466,15 @@ def convert_tif_to_raw(
             "width": src.width,
             "transform": list(src.transform)[:6],
             "crs": src.crs.to_string() if src.crs else None,
+            "nodata": src.nodata,
         }
+        if write_mask or write_occupancy:
+            valid = src.dataset_mask() > 0
+        if write_mask:
+            # One bit per pixel, 1 = valid, rows padded to whole bytes
+            np.packbits(valid, axis=1).tofile(f"{output_base}.mask")
+        if write_occupancy:
+            write_occupancy_index(valid, f"{output_base}.occ", tile_size)
 
     with open(json_path, "w") as f:
         json.dump(metadata, f, indent=2)
@@ -333,3 +487,29 @@ def convert_tif_to_raw(
         os.remove(hdr_path)
 
     return bin_path, json_path
+
+
+def write_occupancy_index(valid: np.ndarray, path: Union[str, Path], tile_size: int = 256) -> None:
+    """
+    Write a tile occupancy index (``.occ``) from a (height, width) validity array.
+
+    Each tile is stored as one byte: 0 = all nodata, 1 = all valid, 2 = mixed.
+    """
+    height, width = valid.shape
+    tiles_y = -(-height // tile_size)
+    tiles_x = -(-width // tile_size)
+
+    # Pad with a third state so edge tiles only judge their real pixels
+    padded = np.full((tiles_y * tile_size, tiles_x * tile_size), 2, dtype=np.uint8)
+    padded[:height, :width] = valid
+    blocks = padded.reshape(tiles_y, tile_size, tiles_x, tile_size).swapaxes(1, 2)
+    blocks = blocks.reshape(tiles_y, tiles_x, -1)
+
+    any_valid = (blocks == 1).any(axis=2)
+    any_invalid = (blocks == 0).any(axis=2)
+    occupancy = np.where(any_valid & any_invalid, 2, np.where(any_valid, 1, 0)).astype(np.uint8)
+
+    with open(path, "wb") as f:
+        f.write(b"GSOC")
+        f.write(struct.pack("<III", tile_size, tiles_x, tiles_y))
+        f.write(occupancy.tobytes())
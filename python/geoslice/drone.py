@@ -3,6 +3,7 @@
 from __future__ import annotations
 
 import math
+from contextlib import nullcontext
 from dataclasses import dataclass
 from typing import List, Optional
 
@@ -10,6 +11,12 @@ import numpy as np
 
 from .core import FastGeoMap, GeoTransform
 
+try:
+    from ._geoslice_cpp import TraceScope as _TraceScope
+    from ._geoslice_cpp import tracing_active as _tracing_active
+except ImportError:
+    _TraceScope = None
+
 
 @dataclass
 class DroneState:
@@ -192,8 +199,16 @@ def simulate_flight(
     Returns:
         List of window arrays (copies, not views)
     """
+    # Stages show up in dump_trace() output while the C++ tracer is recording
+    if _TraceScope is not None and _tracing_active():
+        stage = _TraceScope
+    else:
+        def stage(_name):
+            return nullcontext()
+
     geo = GeoTransform(loader.meta.transform)
-    windows = path.compute_windows(geo)
+    with stage("flight.compute_windows"):
+        windows = path.compute_windows(geo)
 
     results = []
     for state, win in zip(path, windows):
@@ -201,10 +216,12 @@ def simulate_flight(
             results.append(None)
             continue
 
-        data = loader.get_window_copy(win.x, win.y, win.width, win.height)
+        with stage("flight.get_window"):
+            data = loader.get_window_copy(win.x, win.y, win.width, win.height)
         results.append(data)
 
         if callback:
-            callback(state, data)
+            with stage("flight.callback"):
+                callback(state, data)
 
     return results
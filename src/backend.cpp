@@ -0,0 +1,430 @@
+#include "geoslice/backend.hpp"
+#include "geoslice/parallel.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// io_uring is driven through its raw syscalls, so only kernel headers are
+// needed (no liburing)
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define GEOSLICE_HAVE_IO_URING 1
+#endif
+
+namespace geoslice {
+
+namespace {
+// Spread a pread batch over threads only in slices of at least this many
+// bytes; handing a slice to another thread costs more than a small cached
+// read
+constexpr size_t PREAD_BYTES_PER_THREAD = 256 * 1024;
+
+[[noreturn]] void throw_errno(const char* what, int err) {
+    throw std::runtime_error(std::string(what) + ": " + std::strerror(err));
+}
+
+void read_fully(int fd, const ReadRequest& r) {
+    uint8_t* dst = static_cast<uint8_t*>(r.dst);
+    size_t done = 0;
+    while (done < r.length) {
+        const ssize_t n = pread(fd, dst + done, r.length - done, static_cast<off_t>(r.offset + done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw_errno("pread failed", errno);
+        }
+        if (n == 0) throw std::runtime_error("Read past end of file");
+        done += static_cast<size_t>(n);
+    }
+}
+
+class PreadBackend : public ReaderBackend {
+public:
+    explicit PreadBackend(unsigned threads) : threads_(threads) {}
+
+    const char* name() const override { return "pread"; }
+
+    void read(int fd, const std::vector<ReadRequest>& requests) override {
+        size_t total = 0;
+        for (const auto& r : requests) total += r.length;
+        const unsigned threads = resolve_threads(
+            threads_, std::min(requests.size(), total / PREAD_BYTES_PER_THREAD + 1));
+        if (threads == 1) {
+            for (const auto& r : requests) read_fully(fd, r);
+            return;
+        }
+        // Blocking reads go to the I/O pool, not the compute pool
+        detail::run_parallel(*io_executor(), threads - 1, requests.size(),
+                             [&](size_t i) { read_fully(fd, requests[i]); });
+    }
+
+private:
+    unsigned threads_;
+};
+
+#ifdef GEOSLICE_HAVE_IO_URING
+template<typename T>
+T load_acquire(const T* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+
+template<typename T>
+void store_release(T* p, T v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+// Consecutive EAGAIN/EBUSY submit failures with nothing in flight before a
+// batch gives up; the sleep between them doubles up to the cap
+constexpr int MAX_BUSY_RETRIES = 20;
+constexpr auto MAX_BUSY_SLEEP = std::chrono::milliseconds(8);
+
+// One submission/completion queue pair, used by one read() at a time.
+// IORING_OP_READV is used over IORING_OP_READ so any kernel with io_uring
+// (5.1+) will do.
+class Ring {
+public:
+    explicit Ring(unsigned queue_depth) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, std::max(queue_depth, 1u), &params));
+        if (ring_fd_ < 0) throw_errno("io_uring unavailable", errno);
+
+        sq_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+        sqe_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+
+        sq_ring_ = map(sq_bytes_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap ? sq_ring_ : map(cq_bytes_, IORING_OFF_CQ_RING);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqe_bytes_, IORING_OFF_SQES));
+        if (!sq_ring_ || !cq_ring_ || !sqes_) {
+            const int err = errno;
+            release();
+            throw_errno("io_uring ring mmap failed", err);
+        }
+
+        uint8_t* sq = static_cast<uint8_t*>(sq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        uint8_t* cq = static_cast<uint8_t*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // The CQ ring is at least as large as the SQ ring, so keeping at most
+        // sq_entries reads in flight can never overflow it
+        slots_.resize(params.sq_entries);
+    }
+
+    ~Ring() { release(); }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    // Runs the batch to completion. Whatever fails, it only returns (or
+    // throws) once no read is in flight, so the caller's buffers are free
+    // and the ring can be reused.
+    void read(int fd, const std::vector<ReadRequest>& requests) {
+        std::vector<unsigned> ready;  // slots to (re)submit
+        std::vector<unsigned> idle;
+        idle.reserve(slots_.size());
+        for (unsigned s = static_cast<unsigned>(slots_.size()); s-- > 0;) idle.push_back(s);
+
+        size_t next = 0;
+        size_t in_flight = 0;
+        unsigned unsubmitted = 0;
+        int busy_retries = 0;
+        int error = 0;
+
+        // `ready` holds short reads and refused submissions still to resend
+        while (in_flight > 0 || (error == 0 && (next < requests.size() || !ready.empty()))) {
+            if (error == 0) {
+                while (!idle.empty() && next < requests.size()) {
+                    const unsigned s = idle.back();
+                    idle.pop_back();
+                    slots_[s] = {next++, 0, {}};
+                    ready.push_back(s);
+                }
+                unsigned tail = *sq_tail_;
+                for (unsigned s : ready) {
+                    Slot& slot = slots_[s];
+                    const ReadRequest& r = requests[slot.request];
+                    slot.iov.iov_base = static_cast<uint8_t*>(r.dst) + slot.done;
+                    slot.iov.iov_len = r.length - slot.done;
+
+                    const unsigned index = tail & sq_mask_;
+                    io_uring_sqe& sqe = sqes_[index];
+                    std::memset(&sqe, 0, sizeof(sqe));
+                    sqe.opcode = IORING_OP_READV;
+                    sqe.fd = fd;
+                    sqe.off = r.offset + slot.done;
+                    sqe.addr = reinterpret_cast<uint64_t>(&slot.iov);
+                    sqe.len = 1;
+                    sqe.user_data = s;
+                    sq_array_[index] = index;
+                    tail++;
+                }
+                unsubmitted += static_cast<unsigned>(ready.size());
+                in_flight += ready.size();
+                ready.clear();
+                store_release(sq_tail_, tail);
+            }
+
+            int submitted = enter(unsubmitted, 1);
+            if (submitted < 0) {
+                // The kernel took none of the queued entries: take them back.
+                // A full completion queue or a lack of kernel memory clears
+                // as reads complete, so those are retried (with a back-off
+                // and a bound when no read is in flight to wait for);
+                // anything else stops the batch once the reads in flight are
+                // done.
+                bool transient = submitted == -EAGAIN || submitted == -EBUSY;
+                if (transient && in_flight == unsubmitted && ++busy_retries > MAX_BUSY_RETRIES) {
+                    transient = false;
+                }
+                if (!transient && error == 0) error = -submitted;
+                unsigned tail = *sq_tail_;
+                for (; unsubmitted > 0; unsubmitted--) {
+                    tail--;
+                    const unsigned s = static_cast<unsigned>(sqes_[sq_array_[tail & sq_mask_]].user_data);
+                    in_flight--;
+                    (transient ? ready : idle).push_back(s);
+                }
+                store_release(sq_tail_, tail);
+                if (in_flight == 0) {
+                    if (transient) {
+                        std::this_thread::sleep_for(std::min<std::chrono::microseconds>(
+                            std::chrono::microseconds(50 << std::min(busy_retries, 10)), MAX_BUSY_SLEEP));
+                    }
+                    continue;
+                }
+                submitted = 0;
+                wait_completion();
+            } else {
+                busy_retries = 0;
+            }
+            unsubmitted -= static_cast<unsigned>(submitted);
+
+            unsigned head = *cq_head_;
+            const unsigned tail = load_acquire(cq_tail_);
+            for (; head != tail; head++) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                const unsigned s = static_cast<unsigned>(cqe.user_data);
+                in_flight--;
+                if (cqe.res <= 0) {
+                    if (error == 0) error = cqe.res < 0 ? -cqe.res : -1;
+                    idle.push_back(s);
+                    continue;
+                }
+                Slot& slot = slots_[s];
+                slot.done += static_cast<size_t>(cqe.res);
+                if (slot.done < requests[slot.request].length) {
+                    (error == 0 ? ready : idle).push_back(s);  // short read: queue the rest
+                } else {
+                    idle.push_back(s);
+                }
+            }
+            store_release(cq_head_, head);
+        }
+
+        if (error == -1) throw std::runtime_error("Read past end of file");
+        if (error != 0) throw_errno("io_uring read failed", error);
+    }
+
+private:
+    struct Slot {
+        size_t request;
+        size_t done;
+        iovec iov;
+    };
+
+    void* map(size_t bytes, off_t offset) const {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    // Submits `count` queued entries and waits for at least `wait`
+    // completions. Returns the number submitted or -errno.
+    int enter(unsigned count, unsigned wait) const {
+        for (;;) {
+            const long n = syscall(__NR_io_uring_enter, ring_fd_, count, wait, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (n >= 0) return static_cast<int>(n);
+            if (errno != EINTR) return -errno;
+        }
+    }
+
+    // Blocks until the completion queue is not empty. Should waiting in the
+    // kernel fail, the queue is polled instead: reads in flight still
+    // complete into it, and they must before their buffers go back.
+    void wait_completion() const {
+        if (enter(0, 1) >= 0) return;
+        while (load_acquire(cq_tail_) == *cq_head_) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    void release() {
+        if (sqes_) munmap(sqes_, sqe_bytes_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_bytes_);
+        if (sq_ring_) munmap(sq_ring_, sq_bytes_);
+        sqes_ = nullptr;
+        cq_ring_ = sq_ring_ = nullptr;
+        if (ring_fd_ >= 0) close(ring_fd_);
+        ring_fd_ = -1;
+    }
+
+    int ring_fd_ = -1;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sq_bytes_ = 0;
+    size_t cq_bytes_ = 0;
+    size_t sqe_bytes_ = 0;
+
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    std::vector<Slot> slots_;
+};
+
+// Concurrent read() calls each take a ring of their own from a free list,
+// so FileReaders sharing the backend only contend for the list. Rings are
+// created on demand, one per concurrent caller at peak, and kept for reuse;
+// when the kernel refuses another, callers wait for a free one.
+class IoUringBackend : public ReaderBackend {
+public:
+    explicit IoUringBackend(unsigned queue_depth) : queue_depth_(queue_depth) {
+        free_.push_back(std::make_unique<Ring>(queue_depth_));  // throws if io_uring is unavailable
+    }
+
+    const char* name() const override { return "io_uring"; }
+
+    void read(int fd, const std::vector<ReadRequest>& requests) override {
+        std::unique_ptr<Ring> ring = acquire();
+        try {
+            ring->read(fd, requests);
+        } catch (...) {
+            release(std::move(ring));
+            throw;
+        }
+        release(std::move(ring));
+    }
+
+private:
+    std::unique_ptr<Ring> acquire() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (free_.empty()) {
+            lock.unlock();
+            try {
+                return std::make_unique<Ring>(queue_depth_);
+            } catch (const std::runtime_error&) {
+                lock.lock();
+            }
+            released_.wait(lock, [&] { return !free_.empty(); });
+        }
+        auto ring = std::move(free_.back());
+        free_.pop_back();
+        return ring;
+    }
+
+    void release(std::unique_ptr<Ring> ring) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(std::move(ring));
+        }
+        released_.notify_one();
+    }
+
+    unsigned queue_depth_;
+    std::mutex mutex_;
+    std::condition_variable released_;
+    std::vector<std::unique_ptr<Ring>> free_;
+};
+#endif
+}
+
+std::unique_ptr<ReaderBackend> make_pread_backend(unsigned threads) {
+    return std::make_unique<PreadBackend>(threads);
+}
+
+std::unique_ptr<ReaderBackend> make_io_uring_backend(unsigned queue_depth) {
+#ifdef GEOSLICE_HAVE_IO_URING
+    return std::make_unique<IoUringBackend>(queue_depth);
+#else
+    (void)queue_depth;
+    throw std::runtime_error("io_uring unavailable: not built with io_uring support");
+#endif
+}
+
+AlignedBufferPool::AlignedBufferPool(size_t buffer_bytes, size_t count, size_t alignment)
+    : buffer_bytes_(buffer_bytes)
+    , capacity_(count) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument("Buffer alignment must be a power of two");
+    }
+    if (buffer_bytes == 0 || buffer_bytes % alignment != 0) {
+        throw std::invalid_argument("Buffer size must be a positive multiple of the alignment");
+    }
+    if (count == 0) throw std::invalid_argument("Buffer pool needs at least one buffer");
+
+    storage_ = static_cast<uint8_t*>(std::aligned_alloc(alignment, buffer_bytes * count));
+    if (!storage_) throw std::bad_alloc();
+    free_.reserve(count);
+    for (size_t i = count; i-- > 0;) free_.push_back(storage_ + i * buffer_bytes);
+}
+
+AlignedBufferPool::~AlignedBufferPool() {
+    std::free(storage_);
+}
+
+AlignedBufferPool::Lease AlignedBufferPool::acquire(size_t count) {
+    if (count == 0 || count > capacity_) {
+        throw std::invalid_argument("Cannot lease " + std::to_string(count) + " of " +
+                                    std::to_string(capacity_) + " buffers");
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    released_.wait(lock, [&] { return free_.size() >= count; });
+    std::vector<uint8_t*> buffers(free_.end() - count, free_.end());
+    free_.resize(free_.size() - count);
+    return Lease(this, std::move(buffers));
+}
+
+void AlignedBufferPool::release(const std::vector<uint8_t*>& buffers) {
+    if (buffers.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.insert(free_.end(), buffers.begin(), buffers.end());
+    }
+    released_.notify_all();
+}
+
+size_t AlignedBufferPool::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+}
+
+std::unique_ptr<ReaderBackend> make_default_backend() {
+    try {
+        return make_io_uring_backend();
+    } catch (const std::runtime_error&) {
+        return make_pread_backend();
+    }
+}
+
+} // namespace geoslice
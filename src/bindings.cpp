@@ -2,31 +2,176 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <optional>
+
 #include "geoslice/geoslice.hpp"
 
 namespace py = pybind11;
 
+namespace {
+std::vector<geoslice::WindowRect> to_rects(const std::vector<std::array<int, 4>>& windows) {
+    std::vector<geoslice::WindowRect> rects;
+    rects.reserve(windows.size());
+    for (const auto& w : windows) rects.push_back({w[0], w[1], w[2], w[3]});
+    return rects;
+}
+
+// `with TraceScope("stage"):` in Python
+class PyTraceScope {
+public:
+    explicit PyTraceScope(const std::string& name) : name_(geoslice::intern_trace_name(name)) {}
+    void enter() { scope_.emplace(name_); }
+    void exit() { scope_.reset(); }
+
+private:
+    const char* name_;
+    std::optional<geoslice::ScopedTrace> scope_;
+};
+
+// One MMapReader.read_windows_async call. The reads run on the I/O pool
+// without the GIL; the last one to finish takes the GIL and calls
+// done(arrays, error) there. Python objects are only touched with the GIL.
+struct AsyncBatch {
+    py::object reader;  // keeps the MMapReader alive
+    py::object arrays;
+    py::object done;
+    std::atomic<size_t> remaining{0};
+    std::mutex mutex;
+    std::string error;  // first failure
+
+    void finish(std::exception_ptr failed) {
+        if (failed) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error.empty()) {
+                try {
+                    std::rethrow_exception(failed);
+                } catch (const std::exception& e) {
+                    error = e.what();
+                } catch (...) {
+                    error = "window read failed";
+                }
+            }
+        }
+        if (--remaining > 0) return;
+
+        py::gil_scoped_acquire gil;
+        try {
+            done(arrays, error.empty() ? py::object(py::none()) : py::object(py::str(error)));
+        } catch (py::error_already_set& e) {
+            e.discard_as_unraisable("read_windows_async callback");
+        }
+        done = py::object();
+        arrays = py::object();
+        reader = py::object();
+    }
+};
+}
+
 PYBIND11_MODULE(_geoslice_cpp, m) {
     m.doc() = "GeoSlice C++ backend for ultra-fast geospatial windowing";
     m.attr("__version__") = geoslice::VERSION;
 
     py::class_<geoslice::GeoMetadata>(m, "GeoMetadata")
-        .def_readonly("dtype", &geoslice::GeoMetadata::dtype)
+        .def_property_readonly("dtype", [](const geoslice::GeoMetadata& m) { return std::string(m.dtype()); })
         .def_readonly("count", &geoslice::GeoMetadata::count)
         .def_readonly("height", &geoslice::GeoMetadata::height)
         .def_readonly("width", &geoslice::GeoMetadata::width)
         .def_readonly("crs", &geoslice::GeoMetadata::crs)
+        .def_readonly("nodata", &geoslice::GeoMetadata::nodata)
         .def_property_readonly("transform", [](const geoslice::GeoMetadata& m) {
             return std::vector<double>(m.transform.begin(), m.transform.end());
         });
 
+    py::enum_<geoslice::Coverage>(m, "Coverage")
+        .value("Empty", geoslice::Coverage::Empty)
+        .value("Full", geoslice::Coverage::Full)
+        .value("Partial", geoslice::Coverage::Partial);
+
     py::class_<geoslice::MMapReader>(m, "MMapReader")
-        .def(py::init<const std::string&>(), py::arg("base_path"))
+        .def(py::init([](const std::string& base_path, size_t chunk_bytes, size_t max_chunks) {
+            geoslice::ReaderOptions options;
+            options.chunk_bytes = chunk_bytes;
+            options.max_chunks = max_chunks;
+            return std::make_unique<geoslice::MMapReader>(base_path, options);
+        }), py::arg("base_path"), py::arg("chunk_bytes") = 0, py::arg("max_chunks") = 4)
         .def_property_readonly("width", &geoslice::MMapReader::width)
         .def_property_readonly("height", &geoslice::MMapReader::height)
         .def_property_readonly("bands", &geoslice::MMapReader::bands)
         .def_property_readonly("metadata", &geoslice::MMapReader::metadata)
+        .def_property_readonly("has_mask", &geoslice::MMapReader::has_mask)
+        .def_property_readonly("data_offset", &geoslice::MMapReader::data_offset)
+        .def_property_readonly("chunked", &geoslice::MMapReader::chunked)
+        .def_property_readonly("mapped_chunks", &geoslice::MMapReader::mapped_chunks)
         .def("is_valid_window", &geoslice::MMapReader::is_valid_window)
+        .def("prefetch", &geoslice::MMapReader::prefetch,
+             py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"),
+             "Start reading a window's pages in the background (MADV_WILLNEED)")
+        .def("residency", &geoslice::MMapReader::residency,
+             py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"),
+             "Fraction of the window's pages in the page cache (mincore)")
+        .def("residency_map", [](const geoslice::MMapReader& reader, int tile_size) {
+            geoslice::ResidencyMap map;
+            {
+                py::gil_scoped_release release;
+                map = reader.residency_map(tile_size);
+            }
+            py::array_t<bool> out({map.tiles_y, map.tiles_x});
+            auto r = out.mutable_unchecked<2>();
+            for (int ty = 0; ty < map.tiles_y; ty++)
+                for (int tx = 0; tx < map.tiles_x; tx++) r(ty, tx) = map.resident(tx, ty);
+            return out;
+        }, py::arg("tile_size") = 256,
+           "(tiles_y, tiles_x) bool array: tiles whose pages are all in the page cache")
+        .def("coverage", &geoslice::MMapReader::coverage,
+             py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"))
+        .def("get_window_copy", [](const geoslice::MMapReader& reader, int x, int y, int width, int height) {
+            if (!reader.is_valid_window(x, y, width, height)) {
+                throw std::out_of_range("Window out of bounds");
+            }
+            const auto& meta = reader.metadata();
+            py::array out(py::dtype(meta.dtype()), std::vector<ssize_t>{meta.count, height, width});
+            void* dst = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                reader.read_window(x, y, width, height, dst);
+            }
+            return out;
+        }, py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"))
+        .def("read_windows_async", [](py::object self, const std::vector<std::array<int, 4>>& windows,
+                                      py::function done) {
+            const auto& reader = self.cast<const geoslice::MMapReader&>();
+            const auto rects = to_rects(windows);
+            const auto& meta = reader.metadata();
+            auto batch = std::make_shared<AsyncBatch>();
+            py::list arrays;
+            std::vector<void*> outs;
+            for (const auto& r : rects) {
+                if (!reader.is_valid_window(r.x, r.y, r.width, r.height)) {
+                    throw std::out_of_range("Window out of bounds");
+                }
+                py::array out(py::dtype(meta.dtype()), std::vector<ssize_t>{meta.count, r.height, r.width});
+                outs.push_back(out.mutable_data());
+                arrays.append(out);
+            }
+            batch->reader = self;
+            batch->arrays = arrays;
+            batch->done = done;
+            batch->remaining = rects.size() + 1;  // + this call, so done cannot run before the loop ends
+            for (size_t i = 0; i < rects.size(); i++) {
+                try {
+                    reader.read_window_async(rects[i].x, rects[i].y, rects[i].width, rects[i].height, outs[i],
+                                             [batch](std::exception_ptr error) { batch->finish(error); });
+                } catch (...) {
+                    batch->finish(std::current_exception());
+                }
+            }
+            batch->finish(nullptr);
+        }, py::arg("windows"), py::arg("done"),
+           "Copies windows on the I/O pool and returns at once; done(arrays, error) is called on an "
+           "I/O thread when all are read, error being None or a message")
         .def("get_window", [](const geoslice::MMapReader& reader, int x, int y, int width, int height) {
             auto view = reader.get_window(x, y, width, height);
             const auto& meta = reader.metadata();
@@ -39,11 +184,280 @@ PYBIND11_MODULE(_geoslice_cpp, m) {
                 static_cast<ssize_t>(view.pixel_size)
             };
 
-            py::dtype dtype(meta.dtype);
+            py::dtype dtype(meta.dtype());
             return py::array(dtype, shape, strides, view.data, py::cast(reader));
         }, py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"),
            py::return_value_policy::reference_internal);
 
+    py::class_<geoslice::ReaderPool, std::shared_ptr<geoslice::ReaderPool>>(m, "ReaderPool")
+        .def(py::init<size_t, size_t>(),
+             py::arg("max_readers") = geoslice::ReaderPool::DEFAULT_MAX_READERS, py::arg("max_mapped_bytes") = 0)
+        .def("contains", &geoslice::ReaderPool::contains, py::arg("base_path"))
+        .def("clear", &geoslice::ReaderPool::clear)
+        .def_property_readonly("size", &geoslice::ReaderPool::size)
+        .def_property_readonly("mapped_bytes", &geoslice::ReaderPool::mapped_bytes)
+        .def_property_readonly("hits", &geoslice::ReaderPool::hits)
+        .def_property_readonly("misses", &geoslice::ReaderPool::misses)
+        .def_property_readonly("evictions", &geoslice::ReaderPool::evictions);
+
+    py::class_<geoslice::MosaicReader>(m, "MosaicReader")
+        .def(py::init<const std::vector<std::string>&, std::shared_ptr<geoslice::ReaderPool>>(),
+             py::arg("base_paths"), py::arg("pool") = nullptr)
+        .def_property_readonly("width", &geoslice::MosaicReader::width)
+        .def_property_readonly("height", &geoslice::MosaicReader::height)
+        .def_property_readonly("bands", &geoslice::MosaicReader::bands)
+        .def_property_readonly("metadata", &geoslice::MosaicReader::metadata)
+        .def_property_readonly("num_sources", &geoslice::MosaicReader::num_sources)
+        .def_property_readonly("open_sources", &geoslice::MosaicReader::open_sources)
+        .def("is_valid_window", &geoslice::MosaicReader::is_valid_window)
+        .def("source_path", &geoslice::MosaicReader::source_path, py::arg("index"))
+        .def("sources_in", &geoslice::MosaicReader::sources_in,
+             py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"))
+        .def("get_window_copy", [](const geoslice::MosaicReader& mosaic, int x, int y, int width, int height) {
+            if (!mosaic.is_valid_window(x, y, width, height)) {
+                throw std::out_of_range("Window out of bounds");
+            }
+            const auto& meta = mosaic.metadata();
+            py::array out(py::dtype(meta.dtype()), std::vector<ssize_t>{meta.count, height, width});
+            void* dst = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                mosaic.read_window(x, y, width, height, dst);
+            }
+            return out;
+        }, py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"));
+
+    py::class_<geoslice::NumaNode>(m, "NumaNode")
+        .def_readonly("id", &geoslice::NumaNode::id)
+        .def_readonly("cpus", &geoslice::NumaNode::cpus);
+    m.def("numa_nodes", &geoslice::numa_nodes);
+
+    py::class_<geoslice::CopyEngine>(m, "CopyEngine")
+        .def(py::init([](unsigned threads_per_node, bool pin, size_t min_parallel_bytes) {
+            geoslice::CopyEngineOptions options;
+            options.threads_per_node = threads_per_node;
+            options.pin = pin;
+            options.min_parallel_bytes = min_parallel_bytes;
+            return std::make_unique<geoslice::CopyEngine>(options);
+        }), py::arg("threads_per_node") = 0, py::arg("pin") = true,
+           py::arg("min_parallel_bytes") = size_t{4} << 20)
+        .def("get_window_copy", [](geoslice::CopyEngine& engine, const geoslice::MMapReader& reader,
+                                   int x, int y, int width, int height) {
+            if (!reader.is_valid_window(x, y, width, height)) {
+                throw std::out_of_range("Window out of bounds");
+            }
+            const auto& meta = reader.metadata();
+            // Left untouched here: the copy's threads fault the pages in
+            py::array out(py::dtype(meta.dtype()), std::vector<ssize_t>{meta.count, height, width});
+            void* dst = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                engine.read_window(reader, x, y, width, height, dst);
+            }
+            return out;
+        }, py::arg("reader"), py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"))
+        .def_property_readonly("nodes", &geoslice::CopyEngine::nodes)
+        .def_property_readonly("threads", &geoslice::CopyEngine::threads);
+
+    py::class_<geoslice::FileReader>(m, "FileReader")
+        .def(py::init([](const std::string& base_path, const std::string& backend, unsigned threads, bool direct) {
+            std::shared_ptr<geoslice::ReaderBackend> engine;
+            if (backend == "io_uring") {
+                engine = geoslice::make_io_uring_backend();
+            } else if (backend == "pread") {
+                engine = geoslice::make_pread_backend(threads);
+            } else if (backend != "auto") {
+                throw std::invalid_argument("backend must be 'auto', 'io_uring' or 'pread'");
+            }
+            geoslice::FileReaderOptions options;
+            options.direct = direct;
+            return std::make_unique<geoslice::FileReader>(base_path, engine, options);
+        }), py::arg("base_path"), py::arg("backend") = "auto", py::arg("threads") = 0, py::arg("direct") = false)
+        .def_property_readonly("width", &geoslice::FileReader::width)
+        .def_property_readonly("height", &geoslice::FileReader::height)
+        .def_property_readonly("bands", &geoslice::FileReader::bands)
+        .def_property_readonly("metadata", &geoslice::FileReader::metadata)
+        .def_property_readonly("backend", [](const geoslice::FileReader& reader) {
+            return std::string(reader.backend().name());
+        })
+        .def_property_readonly("direct", &geoslice::FileReader::direct)
+        .def_property_readonly("bytes_read", &geoslice::FileReader::bytes_read)
+        .def("is_valid_window", &geoslice::FileReader::is_valid_window)
+        .def("get_window_copy", [](const geoslice::FileReader& reader, int x, int y, int width, int height) {
+            if (!reader.is_valid_window(x, y, width, height)) {
+                throw std::out_of_range("Window out of bounds");
+            }
+            const auto& meta = reader.metadata();
+            py::array out(py::dtype(meta.dtype()), std::vector<ssize_t>{meta.count, height, width});
+            void* dst = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                reader.read_window(x, y, width, height, dst);
+            }
+            return out;
+        }, py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"))
+        .def("read_windows", [](const geoslice::FileReader& reader, const std::vector<std::array<int, 4>>& windows) {
+            const auto rects = to_rects(windows);
+            const auto& meta = reader.metadata();
+            py::list arrays;
+            std::vector<void*> outs;
+            outs.reserve(rects.size());
+            for (const auto& r : rects) {
+                if (!reader.is_valid_window(r.x, r.y, r.width, r.height)) {
+                    throw std::out_of_range("Window out of bounds");
+                }
+                py::array out(py::dtype(meta.dtype()), std::vector<ssize_t>{meta.count, r.height, r.width});
+                outs.push_back(out.mutable_data());
+                arrays.append(out);
+            }
+            {
+                py::gil_scoped_release release;
+                reader.read_windows(rects, outs);
+            }
+            return arrays;
+        }, py::arg("windows"))
+        .def("scan_strips", [](const geoslice::FileReader& reader, int rows, const py::function& fn) {
+            // fn(y, strip) with strip a (bands, rows, width) copy
+            const auto& meta = reader.metadata();
+            reader.scan_strips(rows, [&](const geoslice::WindowRect& strip, const void* data) {
+                py::array out(py::dtype(meta.dtype()), std::vector<ssize_t>{meta.count, strip.height, strip.width});
+                std::memcpy(out.mutable_data(), data, out.nbytes());
+                fn(strip.y, out);
+            });
+        }, py::arg("rows"), py::arg("fn"));
+
+    py::class_<geoslice::TiledReader>(m, "TiledReader")
+        .def(py::init([](const std::string& base_path, size_t cache_bytes, unsigned threads) {
+            geoslice::TiledReaderOptions options;
+            options.cache_bytes = cache_bytes;
+            options.threads = threads;
+            return std::make_unique<geoslice::TiledReader>(base_path, options);
+        }), py::arg("base_path"), py::arg("cache_bytes") = geoslice::TiledReaderOptions{}.cache_bytes,
+           py::arg("threads") = 0)
+        .def_property_readonly("width", &geoslice::TiledReader::width)
+        .def_property_readonly("height", &geoslice::TiledReader::height)
+        .def_property_readonly("bands", &geoslice::TiledReader::bands)
+        .def_property_readonly("metadata", &geoslice::TiledReader::metadata)
+        .def_property_readonly("tile_size", &geoslice::TiledReader::tile_size)
+        .def_property_readonly("codec", [](const geoslice::TiledReader& reader) {
+            return std::string(geoslice::codec_name(reader.codec()));
+        })
+        .def_property_readonly("filter", [](const geoslice::TiledReader& reader) {
+            return std::string(geoslice::filter_name(reader.filter()));
+        })
+        .def_property_readonly("file_bytes", &geoslice::TiledReader::file_bytes)
+        .def_property_readonly("cached_tiles", &geoslice::TiledReader::cached_tiles)
+        .def_property_readonly("cache_hits", &geoslice::TiledReader::cache_hits)
+        .def_property_readonly("cache_misses", &geoslice::TiledReader::cache_misses)
+        .def("clear_cache", &geoslice::TiledReader::clear_cache)
+        .def("is_valid_window", &geoslice::TiledReader::is_valid_window)
+        .def("get_window_copy", [](const geoslice::TiledReader& reader, int x, int y, int width, int height) {
+            if (!reader.is_valid_window(x, y, width, height)) {
+                throw std::out_of_range("Window out of bounds");
+            }
+            const auto& meta = reader.metadata();
+            py::array out(py::dtype(meta.dtype()), std::vector<ssize_t>{meta.count, height, width});
+            void* dst = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                reader.read_window(x, y, width, height, dst);
+            }
+            return out;
+        }, py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"))
+        .def("read_windows", [](const geoslice::TiledReader& reader, const std::vector<std::array<int, 4>>& windows) {
+            const auto rects = to_rects(windows);
+            const auto& meta = reader.metadata();
+            py::list arrays;
+            std::vector<void*> outs;
+            outs.reserve(rects.size());
+            for (const auto& r : rects) {
+                if (!reader.is_valid_window(r.x, r.y, r.width, r.height)) {
+                    throw std::out_of_range("Window out of bounds");
+                }
+                py::array out(py::dtype(meta.dtype()), std::vector<ssize_t>{meta.count, r.height, r.width});
+                outs.push_back(out.mutable_data());
+                arrays.append(out);
+            }
+            {
+                py::gil_scoped_release release;
+                reader.read_windows(rects, outs);
+            }
+            return arrays;
+        }, py::arg("windows"));
+
+    m.def("configure_thread_pool", [](unsigned threads, const std::vector<int>& cpus) {
+        geoslice::configure_thread_pool({threads, cpus});
+    }, py::arg("threads") = 0, py::arg("cpus") = std::vector<int>{},
+       "Replace the pool shared by all parallel operations (0 threads = one per core)");
+    m.def("thread_pool_size", [] { return geoslice::default_executor()->concurrency(); });
+
+    m.def("simd_level", &geoslice::simd_level,
+          "ISA level the pixel kernels were dispatched to on this CPU");
+
+    m.def("metrics_enabled", &geoslice::metrics_enabled,
+          "True if the extension was built with GEOSLICE_METRICS");
+    m.def("metrics_snapshot", [] {
+        const auto s = geoslice::metrics_snapshot();
+        py::dict counters;
+        for (size_t i = 0; i < s.counters.size(); i++) {
+            counters[geoslice::counter_name(static_cast<geoslice::Counter>(i))] = s.counters[i];
+        }
+        py::dict latency;
+        for (size_t i = 0; i < s.latencies.size(); i++) {
+            const auto& l = s.latencies[i];
+            py::dict d;
+            d["count"] = l.count;
+            d["mean_us"] = l.mean_ns / 1000.0;
+            d["p50_us"] = l.p50_ns / 1000.0;
+            d["p90_us"] = l.p90_ns / 1000.0;
+            d["p99_us"] = l.p99_ns / 1000.0;
+            d["p999_us"] = l.p999_ns / 1000.0;
+            d["max_us"] = l.max_ns / 1000.0;
+            latency[geoslice::op_name(static_cast<geoslice::Op>(i))] = d;
+        }
+        py::dict out;
+        out["enabled"] = s.enabled;
+        out["counters"] = counters;
+        out["latency"] = latency;
+        return out;
+    }, "Counters and latency percentiles (us) of reader operations since start or reset_metrics()");
+    m.def("reset_metrics", &geoslice::reset_metrics);
+
+    m.def("start_tracing", &geoslice::start_tracing, py::arg("events_per_thread") = 1 << 16,
+          "Discard earlier trace events and start recording");
+    m.def("stop_tracing", &geoslice::stop_tracing);
+    m.def("tracing_active", &geoslice::tracing_active);
+    m.def("trace_points_enabled", &geoslice::trace_points_enabled,
+          "True if the extension was built with GEOSLICE_TRACE");
+    m.def("dump_trace", [](const std::string& path) {
+        py::gil_scoped_release release;
+        return geoslice::dump_trace(path);
+    }, py::arg("path"), "Write recorded events as Chrome trace JSON; returns how many");
+    py::class_<PyTraceScope>(m, "TraceScope")
+        .def(py::init<const std::string&>(), py::arg("name"))
+        .def("__enter__", [](PyTraceScope& scope) -> PyTraceScope& {
+            scope.enter();
+            return scope;
+        }, py::return_value_policy::reference)
+        .def("__exit__", [](PyTraceScope& scope, py::args) { scope.exit(); });
+
+    m.def("compress_raster", [](const std::string& base_path, const std::string& output_base,
+                                const std::string& codec, const std::string& filter, int tile_size,
+                                unsigned threads, bool overwrite) {
+        geoslice::TiledOptions options;
+        options.codec = geoslice::parse_codec(codec.c_str());
+        options.filter = filter == "auto" ? geoslice::default_filter(geoslice::read_metadata(base_path).dtype_id)
+                                          : geoslice::parse_filter(filter.c_str());
+        options.tile_size = tile_size;
+        options.threads = threads;
+        options.overwrite = overwrite;
+        py::gil_scoped_release release;
+        return geoslice::write_tiled_raster(base_path, output_base, options);
+    }, py::arg("base_path"), py::arg("output_base"), py::arg("codec") = "lz4", py::arg("filter") = "auto",
+       py::arg("tile_size") = 256,
+       py::arg("threads") = 0, py::arg("overwrite") = false,
+       "Write <output_base>.gsz, a compressed tiled copy of a raw raster; returns its metadata");
+
     py::class_<geoslice::GeoTransform>(m, "GeoTransform")
         .def(py::init<const std::array<double, 6>&, int>(),
              py::arg("transform"), py::arg("utm_zone") = 36)
@@ -60,4 +474,85 @@ PYBIND11_MODULE(_geoslice_cpp, m) {
         .def_property_readonly("hits", &geoslice::WindowCache::hits)
         .def_property_readonly("misses", &geoslice::WindowCache::misses)
         .def("clear", &geoslice::WindowCache::clear);
+
+    py::class_<geoslice::BandStats>(m, "BandStats")
+        .def_readonly("min", &geoslice::BandStats::min)
+        .def_readonly("max", &geoslice::BandStats::max)
+        .def_readonly("mean", &geoslice::BandStats::mean)
+        .def_readonly("std", &geoslice::BandStats::std)
+        .def_readonly("valid_count", &geoslice::BandStats::valid_count);
+
+    m.def("window_stats", [](const geoslice::MMapReader& reader, int x, int y, int width, int height,
+                             std::optional<double> nodata) {
+        return geoslice::window_stats(reader.get_window(x, y, width, height), nodata);
+    }, py::arg("reader"), py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"),
+       py::arg("nodata") = py::none(), py::call_guard<py::gil_scoped_release>());
+
+    m.def("window_stats_batch", [](const geoslice::MMapReader& reader,
+                                   const std::vector<std::array<int, 4>>& windows,
+                                   std::optional<double> nodata, unsigned threads) {
+        auto rects = to_rects(windows);
+        py::gil_scoped_release release;
+        return geoslice::window_stats_batch(reader, rects, nodata, threads);
+    }, py::arg("reader"), py::arg("windows"), py::arg("nodata") = py::none(), py::arg("threads") = 0);
+
+    m.def("window_histogram", [](const geoslice::MMapReader& reader, int x, int y, int width, int height,
+                                 int bins, std::optional<double> min, std::optional<double> max,
+                                 std::optional<double> nodata, unsigned threads) {
+        geoslice::HistogramOptions options;
+        options.bins = bins;
+        options.min = min;
+        options.max = max;
+        options.nodata = nodata;
+
+        std::vector<geoslice::BandHistogram> hists;
+        {
+            py::gil_scoped_release release;
+            auto view = reader.get_window(x, y, width, height);
+            hists = threads == 1 ? geoslice::window_histogram(view, options)
+                                 : geoslice::window_histogram_parallel(view, options, threads);
+        }
+
+        // counts: (bands, bins) uint64, ranges: (bands, 2) float64 [min, max]
+        const ssize_t n_bands = static_cast<ssize_t>(hists.size());
+        py::array_t<uint64_t> counts({n_bands, static_cast<ssize_t>(bins)});
+        py::array_t<double> ranges({n_bands, static_cast<ssize_t>(2)});
+        auto c = counts.mutable_unchecked<2>();
+        auto r = ranges.mutable_unchecked<2>();
+        for (ssize_t b = 0; b < n_bands; b++) {
+            for (ssize_t i = 0; i < bins; i++) c(b, i) = hists[b].counts[i];
+            r(b, 0) = hists[b].min;
+            r(b, 1) = hists[b].max;
+        }
+        return py::make_tuple(counts, ranges);
+    }, py::arg("reader"), py::arg("x"), py::arg("y"), py::arg("width"), py::arg("height"),
+       py::arg("bins") = 256, py::arg("min") = py::none(), py::arg("max") = py::none(),
+       py::arg("nodata") = py::none(), py::arg("threads") = 1);
+
+    m.def("build_occupancy_index", [](const std::string& base_path, int tile_size) {
+        py::gil_scoped_release release;
+        geoslice::MMapReader reader(base_path);
+        auto index = geoslice::OccupancyIndex::build(reader, tile_size);
+        index.save(base_path + ".occ");
+        return index.empty_tiles();
+    }, py::arg("base_path"), py::arg("tile_size") = geoslice::OccupancyIndex::DEFAULT_TILE_SIZE,
+       "Scan an existing raster and write its <base>.occ tile occupancy index");
+
+    m.def("convert_tiff", [](const std::string& tiff_path, const std::string& output_base, bool overwrite,
+                             bool write_mask, bool write_occupancy, int tile_size, bool write_header,
+                             unsigned threads) {
+        geoslice::ConvertOptions options;
+        options.threads = threads;
+        options.overwrite = overwrite;
+        options.write_mask = write_mask;
+        options.write_occupancy = write_occupancy;
+        options.tile_size = tile_size;
+        options.write_header = write_header;
+        py::gil_scoped_release release;
+        return geoslice::convert_tiff(tiff_path, output_base, options);
+    }, py::arg("tiff_path"), py::arg("output_base"), py::arg("overwrite") = false,
+       py::arg("write_mask") = false, py::arg("write_occupancy") = false,
+       py::arg("tile_size") = geoslice::OccupancyIndex::DEFAULT_TILE_SIZE, py::arg("write_header") = false,
+       py::arg("threads") = 0,
+       "Convert a GeoTIFF to <base>.bin/<base>.json natively (no GDAL); returns its metadata");
 }
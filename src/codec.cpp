@@ -0,0 +1,424 @@
+#include "geoslice/codec.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef GEOSLICE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace geoslice {
+
+namespace {
+// LZ4 block format limits
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;  // the block always ends with literals
+constexpr size_t MF_LIMIT = 12;      // no match starts in the last 12 bytes
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_LOG = 14;
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t hash4(uint32_t v) { return (v * 2654435761u) >> (32 - HASH_LOG); }
+
+void put_length(uint8_t*& op, size_t len) {
+    for (; len >= 255; len -= 255) *op++ = 255;
+    *op++ = static_cast<uint8_t>(len);
+}
+
+// Appends one sequence: literals, then a match unless match_len is 0 (the
+// last sequence). Returns false if it does not fit before oend.
+bool emit(uint8_t*& op, const uint8_t* oend, const uint8_t* literals, size_t lit_len,
+          size_t offset, size_t match_len) {
+    const size_t worst = 1 + lit_len / 255 + 1 + lit_len + (match_len ? 2 + match_len / 255 + 1 : 0);
+    if (worst > static_cast<size_t>(oend - op)) return false;
+
+    uint8_t* token = op++;
+    const size_t lit_code = lit_len < 15 ? lit_len : 15;
+    if (lit_len >= 15) put_length(op, lit_len - 15);
+    std::memcpy(op, literals, lit_len);
+    op += lit_len;
+
+    size_t match_code = 0;
+    if (match_len) {
+        *op++ = static_cast<uint8_t>(offset);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+        const size_t ml = match_len - MIN_MATCH;
+        match_code = ml < 15 ? ml : 15;
+        if (ml >= 15) put_length(op, ml - 15);
+    }
+    *token = static_cast<uint8_t>((lit_code << 4) | match_code);
+    return true;
+}
+
+#if defined(__SSE2__)
+// Inclusive prefix sum of the S-byte lanes of v (log-step shifted adds)
+template<size_t S>
+__m128i lane_prefix(__m128i v) {
+    if constexpr (S == 1) {
+        v = _mm_add_epi8(v, _mm_slli_si128(v, 1));
+        v = _mm_add_epi8(v, _mm_slli_si128(v, 2));
+        v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+        return _mm_add_epi8(v, _mm_slli_si128(v, 8));
+    } else if constexpr (S == 2) {
+        v = _mm_add_epi16(v, _mm_slli_si128(v, 2));
+        v = _mm_add_epi16(v, _mm_slli_si128(v, 4));
+        return _mm_add_epi16(v, _mm_slli_si128(v, 8));
+    } else if constexpr (S == 4) {
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        return _mm_add_epi32(v, _mm_slli_si128(v, 8));
+    } else {
+        return _mm_add_epi64(v, _mm_slli_si128(v, 8));
+    }
+}
+
+template<size_t S>
+__m128i lane_add(__m128i a, __m128i b) {
+    if constexpr (S == 1) return _mm_add_epi8(a, b);
+    else if constexpr (S == 2) return _mm_add_epi16(a, b);
+    else if constexpr (S == 4) return _mm_add_epi32(a, b);
+    else return _mm_add_epi64(a, b);
+}
+
+// The last S-byte lane of v in every lane
+template<size_t S>
+__m128i broadcast_last(__m128i v) {
+    if constexpr (S == 1) {
+        const __m128i t = _mm_shufflehi_epi16(_mm_unpackhi_epi8(v, v), 0xFF);
+        return _mm_unpackhi_epi64(t, t);
+    } else if constexpr (S == 2) {
+        const __m128i t = _mm_shufflehi_epi16(v, 0xFF);
+        return _mm_unpackhi_epi64(t, t);
+    } else if constexpr (S == 4) {
+        return _mm_shuffle_epi32(v, 0xFF);
+    } else {
+        return _mm_unpackhi_epi64(v, v);
+    }
+}
+#endif
+
+// In-place running sum of n wrapping T samples: undoes delta_row
+template<typename T>
+void prefix_sum_row(uint8_t* row, size_t n) {
+    size_t i = 0;
+    T acc = 0;
+#if defined(__SSE2__)
+    constexpr size_t lanes = 16 / sizeof(T);
+    __m128i carry = _mm_setzero_si128();
+    for (; i + lanes <= n; i += lanes) {
+        __m128i* p = reinterpret_cast<__m128i*>(row + i * sizeof(T));
+        const __m128i v = lane_add<sizeof(T)>(lane_prefix<sizeof(T)>(_mm_loadu_si128(p)), carry);
+        _mm_storeu_si128(p, v);
+        carry = broadcast_last<sizeof(T)>(v);
+    }
+    if (i > 0) std::memcpy(&acc, row + (i - 1) * sizeof(T), sizeof(T));
+#endif
+    for (; i < n; i++) {
+        T v;
+        std::memcpy(&v, row + i * sizeof(T), sizeof(T));
+        acc = static_cast<T>(acc + v);
+        std::memcpy(row + i * sizeof(T), &acc, sizeof(T));
+    }
+}
+
+template<typename T>
+void delta_row(const uint8_t* src, uint8_t* dst, size_t n) {
+    T prev = 0;
+    for (size_t i = 0; i < n; i++) {
+        T v;
+        std::memcpy(&v, src + i * sizeof(T), sizeof(T));
+        const T d = static_cast<T>(v - prev);
+        std::memcpy(dst + i * sizeof(T), &d, sizeof(T));
+        prev = v;
+    }
+}
+
+void delta_rows(const uint8_t* src, uint8_t* dst, size_t rows, size_t n, size_t sample_size) {
+    const size_t row_bytes = n * sample_size;
+    for (size_t r = 0; r < rows; r++) {
+        const uint8_t* s = src + r * row_bytes;
+        uint8_t* d = dst + r * row_bytes;
+        switch (sample_size) {
+            case 1: delta_row<uint8_t>(s, d, n); break;
+            case 2: delta_row<uint16_t>(s, d, n); break;
+            case 4: delta_row<uint32_t>(s, d, n); break;
+            default: delta_row<uint64_t>(s, d, n); break;
+        }
+    }
+}
+
+void prefix_sum_rows(uint8_t* data, size_t rows, size_t n, size_t sample_size) {
+    const size_t row_bytes = n * sample_size;
+    for (size_t r = 0; r < rows; r++) {
+        uint8_t* row = data + r * row_bytes;
+        switch (sample_size) {
+            case 1: prefix_sum_row<uint8_t>(row, n); break;
+            case 2: prefix_sum_row<uint16_t>(row, n); break;
+            case 4: prefix_sum_row<uint32_t>(row, n); break;
+            default: prefix_sum_row<uint64_t>(row, n); break;
+        }
+    }
+}
+
+// Reads an LZ4 length continuation; false if it runs past the input
+bool get_length(const uint8_t*& ip, const uint8_t* iend, size_t& len) {
+    uint8_t b;
+    do {
+        if (ip >= iend) return false;
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+}
+
+TileCodec parse_codec(const char* name) {
+    const std::string s(name);
+    if (s == "none") return TileCodec::None;
+    if (s == "lz4") return TileCodec::LZ4;
+    if (s == "deflate") return TileCodec::Deflate;
+    throw std::invalid_argument("Unknown codec: " + s);
+}
+
+const char* codec_name(TileCodec codec) {
+    switch (codec) {
+        case TileCodec::None: return "none";
+        case TileCodec::LZ4: return "lz4";
+        case TileCodec::Deflate: return "deflate";
+    }
+    return "unknown";
+}
+
+bool codec_available(TileCodec codec) {
+    switch (codec) {
+        case TileCodec::None:
+        case TileCodec::LZ4: return true;
+        case TileCodec::Deflate:
+#ifdef GEOSLICE_HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+TileFilter parse_filter(const char* name) {
+    const std::string s(name);
+    if (s == "none") return TileFilter::None;
+    if (s == "delta") return TileFilter::Delta;
+    if (s == "float_shuffle") return TileFilter::FloatShuffle;
+    throw std::invalid_argument("Unknown filter: " + s);
+}
+
+const char* filter_name(TileFilter filter) {
+    switch (filter) {
+        case TileFilter::None: return "none";
+        case TileFilter::Delta: return "delta";
+        case TileFilter::FloatShuffle: return "float_shuffle";
+    }
+    return "unknown";
+}
+
+TileFilter default_filter(DType dtype) {
+    if (dtype == DType::Float32 || dtype == DType::Float64) return TileFilter::FloatShuffle;
+    return dtype_size(dtype) > 1 ? TileFilter::Delta : TileFilter::None;
+}
+
+void apply_filter(TileFilter filter, const uint8_t* src, uint8_t* dst, size_t rows, size_t row_values,
+                  size_t sample_size) {
+    const size_t row_bytes = row_values * sample_size;
+    switch (filter) {
+        case TileFilter::None:
+            std::memcpy(dst, src, rows * row_bytes);
+            return;
+        case TileFilter::Delta:
+            delta_rows(src, dst, rows, row_values, sample_size);
+            return;
+        case TileFilter::FloatShuffle: {
+            // Byte planes, most significant first, so sign and exponent bytes
+            // (nearly constant across a row) end up next to each other
+            thread_local std::vector<uint8_t> planes;
+            planes.resize(row_bytes);
+            for (size_t r = 0; r < rows; r++) {
+                const uint8_t* s = src + r * row_bytes;
+                for (size_t k = 0; k < sample_size; k++) {
+                    uint8_t* plane = planes.data() + k * row_values;
+                    for (size_t i = 0; i < row_values; i++) plane[i] = s[i * sample_size + sample_size - 1 - k];
+                }
+                delta_rows(planes.data(), dst + r * row_bytes, 1, row_bytes, 1);
+            }
+            return;
+        }
+    }
+    throw std::invalid_argument("Unknown filter");
+}
+
+void undo_filter(TileFilter filter, uint8_t* data, size_t rows, size_t row_values, size_t sample_size) {
+    const size_t row_bytes = row_values * sample_size;
+    switch (filter) {
+        case TileFilter::None:
+            return;
+        case TileFilter::Delta:
+            prefix_sum_rows(data, rows, row_values, sample_size);
+            return;
+        case TileFilter::FloatShuffle: {
+            thread_local std::vector<uint8_t> planes;
+            planes.resize(row_bytes);
+            prefix_sum_rows(data, rows, row_bytes, 1);
+            for (size_t r = 0; r < rows; r++) {
+                uint8_t* row = data + r * row_bytes;
+                std::memcpy(planes.data(), row, row_bytes);
+                for (size_t k = 0; k < sample_size; k++) {
+                    const uint8_t* plane = planes.data() + k * row_values;
+                    for (size_t i = 0; i < row_values; i++) row[i * sample_size + sample_size - 1 - k] = plane[i];
+                }
+            }
+            return;
+        }
+    }
+    throw std::invalid_argument("Unknown filter");
+}
+
+size_t lz4_bound(size_t n) {
+    return n + n / 255 + 16;
+}
+
+size_t lz4_compress(const uint8_t* src, size_t n, uint8_t* dst, size_t capacity) {
+    uint8_t* op = dst;
+    const uint8_t* oend = dst + capacity;
+    size_t anchor = 0;
+
+    if (n >= MF_LIMIT + 1) {
+        thread_local std::vector<uint32_t> table;
+        table.assign(size_t(1) << HASH_LOG, UINT32_MAX);
+
+        const size_t match_start_limit = n - MF_LIMIT;  // a match may start before this
+        const size_t match_end_limit = n - LAST_LITERALS;
+        size_t ip = 0;
+        while (ip < match_start_limit) {
+            const uint32_t seq = read32(src + ip);
+            const uint32_t h = hash4(seq);
+            const uint32_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+
+            if (ref == UINT32_MAX || ip - ref > MAX_OFFSET || read32(src + ref) != seq) {
+                // Skip faster through incompressible data
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            size_t len = MIN_MATCH;
+            while (ip + len < match_end_limit && src[ref + len] == src[ip + len]) len++;
+            if (!emit(op, oend, src + anchor, ip - anchor, ip - ref, len)) return 0;
+            ip += len;
+            anchor = ip;
+            if (ip < match_start_limit) table[hash4(read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+        }
+    }
+
+    if (!emit(op, oend, src + anchor, n - anchor, 0, 0)) return 0;
+    return static_cast<size_t>(op - dst);
+}
+
+void lz4_decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t out_size) {
+    const uint8_t* ip = src;
+    const uint8_t* iend = src + n;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + out_size;
+    auto corrupt = []() { throw std::runtime_error("Corrupt LZ4 block"); };
+
+    for (;;) {
+        if (ip >= iend) corrupt();
+        const uint8_t token = *ip++;
+
+        size_t lit_len = token >> 4;
+        if (lit_len == 15 && !get_length(ip, iend, lit_len)) corrupt();
+        if (lit_len > static_cast<size_t>(iend - ip) || lit_len > static_cast<size_t>(oend - op)) corrupt();
+        std::memcpy(op, ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+        if (ip == iend) break;  // last sequence has no match
+
+        if (iend - ip < 2) corrupt();
+        const size_t offset = ip[0] | (size_t(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) corrupt();
+
+        size_t match_len = token & 15;
+        if (match_len == 15 && !get_length(ip, iend, match_len)) corrupt();
+        match_len += MIN_MATCH;
+        if (match_len > static_cast<size_t>(oend - op)) corrupt();
+
+        const uint8_t* match = op - offset;
+        if (offset >= match_len) {
+            std::memcpy(op, match, match_len);
+        } else {
+            for (size_t i = 0; i < match_len; i++) op[i] = match[i];  // overlapping run
+        }
+        op += match_len;
+    }
+    if (op != oend) corrupt();
+}
+
+bool compress_block(TileCodec codec, const uint8_t* src, size_t n, std::vector<uint8_t>& out) {
+    switch (codec) {
+        case TileCodec::None:
+            return false;
+        case TileCodec::LZ4: {
+            out.resize(lz4_bound(n));
+            const size_t size = lz4_compress(src, n, out.data(), n > 0 ? n - 1 : 0);
+            out.resize(size);
+            return size > 0;
+        }
+        case TileCodec::Deflate: {
+#ifdef GEOSLICE_HAVE_ZLIB
+            uLongf size = compressBound(static_cast<uLong>(n));
+            out.resize(size);
+            if (compress2(out.data(), &size, src, static_cast<uLong>(n), Z_DEFAULT_COMPRESSION) != Z_OK) {
+                throw std::runtime_error("Deflate compression failed");
+            }
+            out.resize(size);
+            return size < n;
+#else
+            break;
+#endif
+        }
+    }
+    throw std::runtime_error(std::string("Codec not available: ") + codec_name(codec));
+}
+
+void decompress_block(TileCodec codec, const uint8_t* src, size_t n, uint8_t* dst, size_t out_size) {
+    switch (codec) {
+        case TileCodec::None:
+            if (n != out_size) throw std::runtime_error("Stored block has the wrong size");
+            std::memcpy(dst, src, n);
+            return;
+        case TileCodec::LZ4:
+            lz4_decompress(src, n, dst, out_size);
+            return;
+        case TileCodec::Deflate: {
+#ifdef GEOSLICE_HAVE_ZLIB
+            uLongf size = static_cast<uLongf>(out_size);
+            if (uncompress(dst, &size, src, static_cast<uLong>(n)) != Z_OK || size != out_size) {
+                throw std::runtime_error("Corrupt Deflate block");
+            }
+            return;
+#else
+            break;
+#endif
+        }
+    }
+    throw std::runtime_error(std::string("Codec not available: ") + codec_name(codec));
+}
+
+} // namespace geoslice
@@ -0,0 +1,780 @@
+#include "geoslice/converter.hpp"
+#include "geoslice/mask.hpp"
+#include "geoslice/parallel.hpp"
+#include "geoslice/raster_header.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#ifdef GEOSLICE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace geoslice {
+
+namespace {
+
+enum : uint16_t {
+    TAG_IMAGE_WIDTH = 256,
+    TAG_IMAGE_LENGTH = 257,
+    TAG_BITS_PER_SAMPLE = 258,
+    TAG_COMPRESSION = 259,
+    TAG_STRIP_OFFSETS = 273,
+    TAG_SAMPLES_PER_PIXEL = 277,
+    TAG_ROWS_PER_STRIP = 278,
+    TAG_STRIP_BYTE_COUNTS = 279,
+    TAG_PLANAR_CONFIG = 284,
+    TAG_PREDICTOR = 317,
+    TAG_TILE_WIDTH = 322,
+    TAG_TILE_LENGTH = 323,
+    TAG_TILE_OFFSETS = 324,
+    TAG_TILE_BYTE_COUNTS = 325,
+    TAG_SAMPLE_FORMAT = 339,
+    TAG_MODEL_PIXEL_SCALE = 33550,
+    TAG_MODEL_TIEPOINT = 33922,
+    TAG_MODEL_TRANSFORMATION = 34264,
+    TAG_GEO_KEY_DIRECTORY = 34735,
+    TAG_GDAL_NODATA = 42113,
+};
+
+enum : int {
+    COMPRESSION_NONE = 1,
+    COMPRESSION_LZW = 5,
+    COMPRESSION_DEFLATE = 8,
+    COMPRESSION_PACKBITS = 32773,
+    COMPRESSION_DEFLATE_OLD = 32946,
+};
+
+enum : uint16_t {
+    GEOKEY_RASTER_TYPE = 1025,
+    GEOKEY_GEOGRAPHIC_TYPE = 2048,
+    GEOKEY_PROJECTED_CS_TYPE = 3072,
+    RASTER_PIXEL_IS_POINT = 2,
+    GEOKEY_USER_DEFINED = 32767,
+};
+
+// Read-only mapping of the whole input file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path);
+        struct stat st;
+        fstat(fd, &st);
+        size_ = st.st_size;
+        data_ = size_ ? mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (data_ == MAP_FAILED) throw std::runtime_error("mmap failed: " + path);
+        madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+    ~MappedFile() { munmap(data_, size_); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return static_cast<const uint8_t*>(data_); }
+    size_t size() const { return size_; }
+
+private:
+    void* data_;
+    size_t size_;
+};
+
+struct Entry {
+    uint16_t type = 0;
+    uint64_t count = 0;
+    uint64_t offset = 0;  // file offset of the values (inline or external)
+};
+
+// One decoded strip/tile is held per thread; larger chunks are rejected
+constexpr size_t MAX_CHUNK_BYTES = size_t(1) << 32;
+
+struct Layout {
+    int width = 0;
+    int height = 0;
+    int samples = 1;
+    int bits = 8;
+    int sample_format = 1;
+    int compression = COMPRESSION_NONE;
+    int planar = 1;
+    int predictor = 1;
+    bool tiled = false;
+    int chunk_width = 0;   // tile width, or image width for strips
+    int chunk_height = 0;  // tile length, or rows per strip
+    std::vector<uint64_t> offsets;
+    std::vector<uint64_t> byte_counts;
+
+    int bytes() const { return bits / 8; }
+    int chunk_samples() const { return planar == 2 ? 1 : samples; }
+    int chunks_across() const { return (width - 1) / chunk_width + 1; }
+    int chunks_down() const { return (height - 1) / chunk_height + 1; }
+    size_t chunks_per_plane() const { return static_cast<size_t>(chunks_across()) * chunks_down(); }
+};
+
+class TiffFile {
+public:
+    explicit TiffFile(const MappedFile& file) : data_(file.data()), size_(file.size()) {
+        need(0, 8);
+        if (data_[0] == 'I' && data_[1] == 'I') {
+            swap_ = false;
+        } else if (data_[0] == 'M' && data_[1] == 'M') {
+            swap_ = true;
+        } else {
+            throw std::runtime_error("Not a TIFF file");
+        }
+
+        const uint16_t version = u16(2);
+        if (version == 42) {
+            big_ = false;
+            first_ifd_ = u32(4);
+        } else if (version == 43) {
+            big_ = true;
+            need(0, 16);
+            first_ifd_ = u64(8);
+        } else {
+            throw std::runtime_error("Unsupported TIFF version");
+        }
+        read_ifd(first_ifd_);
+    }
+
+    bool swap() const { return swap_; }
+    bool has(uint16_t tag) const { return find(tag) != nullptr; }
+
+    uint64_t integer(uint16_t tag, uint64_t fallback) const {
+        const Entry* e = find(tag);
+        if (!e) return fallback;
+        auto v = integers(tag);
+        return v.empty() ? fallback : v[0];
+    }
+
+    std::vector<uint64_t> integers(uint16_t tag) const {
+        std::vector<uint64_t> out;
+        const Entry* e = find(tag);
+        if (!e) return out;
+        const size_t size = type_size(e->type);
+        need_array(e->offset, e->count, size);
+        out.reserve(e->count);
+        for (uint64_t i = 0; i < e->count; i++) {
+            const uint64_t at = e->offset + i * size;
+            switch (e->type) {
+                case 1: case 6: case 7: out.push_back(data_[at]); break;
+                case 3: case 8: out.push_back(u16(at)); break;
+                case 4: case 9: out.push_back(u32(at)); break;
+                case 16: case 17: case 18: out.push_back(u64(at)); break;
+                default: throw std::runtime_error("Unexpected type for integer tag " + std::to_string(tag));
+            }
+        }
+        return out;
+    }
+
+    std::vector<double> doubles(uint16_t tag) const {
+        std::vector<double> out;
+        const Entry* e = find(tag);
+        if (!e) return out;
+        if (e->type != 12) {
+            for (uint64_t v : integers(tag)) out.push_back(static_cast<double>(v));
+            return out;
+        }
+        need_array(e->offset, e->count, 8);
+        for (uint64_t i = 0; i < e->count; i++) {
+            const uint64_t bits = u64(e->offset + i * 8);
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            out.push_back(d);
+        }
+        return out;
+    }
+
+    std::string ascii(uint16_t tag) const {
+        const Entry* e = find(tag);
+        if (!e || e->type != 2) return "";
+        need(e->offset, e->count);
+        std::string s(reinterpret_cast<const char*>(data_ + e->offset), e->count);
+        return s.substr(0, s.find('\0'));
+    }
+
+    void need(uint64_t offset, uint64_t bytes) const {
+        if (offset > size_ || bytes > size_ - offset) throw std::runtime_error("Truncated TIFF file");
+    }
+    // count values of size bytes; BigTIFF counts come from the file and
+    // count * size may not fit in 64 bits
+    void need_array(uint64_t offset, uint64_t count, size_t size) const {
+        if (offset > size_ || (size && count > (size_ - offset) / size)) {
+            throw std::runtime_error("Truncated TIFF file");
+        }
+    }
+
+    const uint8_t* data() const { return data_; }
+
+private:
+    static size_t type_size(uint16_t type) {
+        switch (type) {
+            case 1: case 2: case 6: case 7: return 1;
+            case 3: case 8: return 2;
+            case 4: case 9: case 11: return 4;
+            case 5: case 10: case 12: case 16: case 17: case 18: return 8;
+        }
+        return 0;
+    }
+
+    uint16_t u16(uint64_t at) const {
+        uint16_t v;
+        std::memcpy(&v, data_ + at, sizeof(v));
+        return swap_ ? __builtin_bswap16(v) : v;
+    }
+    uint32_t u32(uint64_t at) const {
+        uint32_t v;
+        std::memcpy(&v, data_ + at, sizeof(v));
+        return swap_ ? __builtin_bswap32(v) : v;
+    }
+    uint64_t u64(uint64_t at) const {
+        uint64_t v;
+        std::memcpy(&v, data_ + at, sizeof(v));
+        return swap_ ? __builtin_bswap64(v) : v;
+    }
+
+    void read_ifd(uint64_t offset) {
+        const size_t count_size = big_ ? 8 : 2;
+        const size_t entry_size = big_ ? 20 : 12;
+        const size_t inline_size = big_ ? 8 : 4;
+
+        need(offset, count_size);
+        const uint64_t n = big_ ? u64(offset) : u16(offset);
+        need_array(offset + count_size, n, entry_size);
+
+        for (uint64_t i = 0; i < n; i++) {
+            const uint64_t at = offset + count_size + i * entry_size;
+            Entry e;
+            const uint16_t tag = u16(at);
+            e.type = u16(at + 2);
+            e.count = big_ ? u64(at + 4) : u32(at + 4);
+            const uint64_t value_at = at + (big_ ? 12 : 8);
+            const size_t size = type_size(e.type);
+            if (size == 0) continue;  // unknown type, skip the tag
+            if (e.count <= inline_size / size) {
+                e.offset = value_at;
+            } else {
+                e.offset = big_ ? u64(value_at) : u32(value_at);
+            }
+            entries_.emplace_back(tag, e);
+        }
+    }
+
+    const Entry* find(uint16_t tag) const {
+        for (const auto& [t, e] : entries_) {
+            if (t == tag) return &e;
+        }
+        return nullptr;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    bool swap_ = false;
+    bool big_ = false;
+    uint64_t first_ifd_ = 0;
+    std::vector<std::pair<uint16_t, Entry>> entries_;
+};
+
+// --- Decompressors: fill exactly out_size bytes (short input leaves zeros) ---
+
+void decode_lzw(const uint8_t* src, size_t n, uint8_t* dst, size_t out_size) {
+    constexpr int CLEAR = 256;
+    constexpr int EOI = 257;
+    constexpr int MAX_CODES = 4096;
+
+    if (n >= 2 && src[0] == 0 && (src[1] & 0x01)) {
+        throw std::runtime_error("Old-style (pre-6.0) LZW is not supported");
+    }
+
+    uint16_t prefix[MAX_CODES];
+    uint8_t suffix[MAX_CODES];
+    uint8_t first[MAX_CODES];
+    uint16_t length[MAX_CODES];
+    for (int i = 0; i < 256; i++) {
+        prefix[i] = 0;
+        suffix[i] = first[i] = static_cast<uint8_t>(i);
+        length[i] = 1;
+    }
+
+    uint32_t buffer = 0;
+    int buffered = 0;
+    size_t pos = 0;
+    int width = 9;
+    int next = 258;
+    int prev = -1;
+    size_t out = 0;
+
+    auto read_code = [&]() -> int {
+        while (buffered < width) {
+            if (pos >= n) return EOI;
+            buffer = (buffer << 8) | src[pos++];
+            buffered += 8;
+        }
+        buffered -= width;
+        return static_cast<int>((buffer >> buffered) & ((1u << width) - 1));
+    };
+
+    auto emit = [&](int code) {
+        const int len = length[code];
+        for (int i = len - 1, c = code; i >= 0; i--, c = prefix[c]) {
+            if (out + i < out_size) dst[out + i] = suffix[c];
+        }
+        out += len;
+    };
+
+    while (out < out_size) {
+        int code = read_code();
+        if (code == EOI) break;
+        if (code == CLEAR) {
+            width = 9;
+            next = 258;
+            code = read_code();
+            if (code == EOI) break;
+            if (code > 255) throw std::runtime_error("Corrupt LZW data");
+            emit(code);
+            prev = code;
+            continue;
+        }
+        if (prev < 0) {
+            if (code > 255) throw std::runtime_error("Corrupt LZW data");
+            emit(code);
+            prev = code;
+            continue;
+        }
+
+        if (code > next || (code == next && next >= MAX_CODES)) throw std::runtime_error("Corrupt LZW data");
+        if (next < MAX_CODES) {
+            // New entry: previous string + first byte of the current one (KwKwK when code == next)
+            prefix[next] = static_cast<uint16_t>(prev);
+            first[next] = first[prev];
+            suffix[next] = code == next ? first[prev] : first[code];
+            length[next] = static_cast<uint16_t>(length[prev] + 1);
+            next++;
+        }
+        emit(code);
+        prev = code;
+
+        // TIFF's "early change": widen one code before the table fills
+        if (next + 1 >= (1 << width) && width < 12) width++;
+    }
+}
+
+void decode_packbits(const uint8_t* src, size_t n, uint8_t* dst, size_t out_size) {
+    size_t i = 0;
+    size_t out = 0;
+    while (i < n && out < out_size) {
+        const int8_t header = static_cast<int8_t>(src[i++]);
+        if (header >= 0) {
+            const size_t run = std::min<size_t>({static_cast<size_t>(header) + 1, n - i, out_size - out});
+            std::memcpy(dst + out, src + i, run);
+            i += header + 1;
+            out += run;
+        } else if (header != -128 && i < n) {
+            const size_t run = std::min<size_t>(1 - header, out_size - out);
+            std::memset(dst + out, src[i++], run);
+            out += run;
+        }
+    }
+}
+
+void decode_deflate(const uint8_t* src, size_t n, uint8_t* dst, size_t out_size) {
+#ifdef GEOSLICE_HAVE_ZLIB
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK) throw std::runtime_error("inflateInit failed");
+    zs.next_in = const_cast<Bytef*>(src);
+    zs.next_out = dst;
+    // avail_in/avail_out are 32-bit: feed chunks over 4 GiB in slices
+    constexpr size_t max_slice = std::numeric_limits<uInt>::max();
+    int rc = Z_OK;
+    while (rc == Z_OK) {
+        if (zs.avail_in == 0) {
+            zs.avail_in = static_cast<uInt>(std::min(n, max_slice));
+            n -= zs.avail_in;
+        }
+        if (zs.avail_out == 0) {
+            zs.avail_out = static_cast<uInt>(std::min(out_size, max_slice));
+            out_size -= zs.avail_out;
+        }
+        rc = inflate(&zs, Z_NO_FLUSH);
+        // No progress possible: input ran out or the output is full
+        if (rc == Z_BUF_ERROR && ((zs.avail_in == 0 && n > 0) || (zs.avail_out == 0 && out_size > 0))) rc = Z_OK;
+    }
+    inflateEnd(&zs);
+    if (rc != Z_STREAM_END) throw std::runtime_error("Corrupt Deflate data");
+#else
+    (void)src; (void)n; (void)dst; (void)out_size;
+    throw std::runtime_error("Deflate-compressed TIFF needs geoslice built with zlib");
+#endif
+}
+
+// --- Predictors, applied per row of `values` samples ---
+
+template<typename U>
+void undo_horizontal(uint8_t* row, size_t values, int stride) {
+    U* v = reinterpret_cast<U*>(row);
+    for (size_t i = stride; i < values; i++) v[i] = static_cast<U>(v[i] + v[i - stride]);
+}
+
+// Floating-point predictor: bytes were split into planes (most significant
+// first) and byte-differenced; undo both into little-endian values.
+void undo_floating_point(uint8_t* row, size_t values, int stride, int bytes, std::vector<uint8_t>& tmp) {
+    const size_t row_bytes = values * bytes;
+    for (size_t i = stride; i < row_bytes; i++) row[i] = static_cast<uint8_t>(row[i] + row[i - stride]);
+    tmp.assign(row, row + row_bytes);
+    for (size_t i = 0; i < values; i++) {
+        for (int b = 0; b < bytes; b++) row[i * bytes + b] = tmp[(bytes - 1 - b) * values + i];
+    }
+}
+
+void byte_swap(uint8_t* data, size_t values, int bytes) {
+    for (size_t i = 0; i < values; i++) std::reverse(data + i * bytes, data + (i + 1) * bytes);
+}
+
+// Copies sample s of each chunky pixel into a contiguous band row
+template<typename U>
+void deinterleave(const uint8_t* src, uint8_t* dst, int pixels, int samples, int s) {
+    const U* in = reinterpret_cast<const U*>(src) + s;
+    U* out = reinterpret_cast<U*>(dst);
+    for (int x = 0; x < pixels; x++) out[x] = in[x * samples];
+}
+
+// Tag values stored as int; larger ones would wrap (2^32 + 5 -> 5)
+int to_int(uint64_t value) {
+    if (value > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("TIFF value out of range: " + std::to_string(value));
+    }
+    return static_cast<int>(value);
+}
+
+std::string dtype_for(int bits, int format) {
+    if (format == 3 && bits == 32) return "float32";
+    if (format == 3 && bits == 64) return "float64";
+    if (format == 1 || format == 4) {
+        if (bits == 8) return "uint8";
+        if (bits == 16) return "uint16";
+        if (bits == 32) return "uint32";
+    }
+    if (format == 2) {
+        if (bits == 8) return "int8";
+        if (bits == 16) return "int16";
+        if (bits == 32) return "int32";
+    }
+    throw std::runtime_error("Unsupported TIFF sample type: " + std::to_string(bits) +
+                             " bits, format " + std::to_string(format));
+}
+
+Layout read_layout(const TiffFile& tiff) {
+    Layout l;
+    l.width = to_int(tiff.integer(TAG_IMAGE_WIDTH, 0));
+    l.height = to_int(tiff.integer(TAG_IMAGE_LENGTH, 0));
+    l.samples = to_int(tiff.integer(TAG_SAMPLES_PER_PIXEL, 1));
+    l.compression = to_int(tiff.integer(TAG_COMPRESSION, COMPRESSION_NONE));
+    l.planar = to_int(tiff.integer(TAG_PLANAR_CONFIG, 1));
+    l.predictor = to_int(tiff.integer(TAG_PREDICTOR, 1));
+
+    auto bits = tiff.integers(TAG_BITS_PER_SAMPLE);
+    auto formats = tiff.integers(TAG_SAMPLE_FORMAT);
+    l.bits = bits.empty() ? 1 : to_int(bits[0]);
+    l.sample_format = formats.empty() ? 1 : to_int(formats[0]);
+    for (auto b : bits) {
+        if (b != bits[0]) throw std::runtime_error("Mixed bits per sample are not supported");
+    }
+
+    if (l.width <= 0 || l.height <= 0 || l.samples <= 0) throw std::runtime_error("Invalid TIFF dimensions");
+    dtype_for(l.bits, l.sample_format);  // validates
+    if (l.planar != 1 && l.planar != 2) throw std::runtime_error("Invalid planar configuration");
+    if (l.predictor < 1 || l.predictor > 3 || (l.predictor == 3 && l.sample_format != 3)) {
+        throw std::runtime_error("Unsupported TIFF predictor");
+    }
+    switch (l.compression) {
+        case COMPRESSION_NONE:
+        case COMPRESSION_LZW:
+        case COMPRESSION_DEFLATE:
+        case COMPRESSION_DEFLATE_OLD:
+        case COMPRESSION_PACKBITS:
+            break;
+        default:
+            throw std::runtime_error("Unsupported TIFF compression: " + std::to_string(l.compression));
+    }
+
+    l.tiled = tiff.has(TAG_TILE_WIDTH);
+    if (l.tiled) {
+        l.chunk_width = to_int(tiff.integer(TAG_TILE_WIDTH, 0));
+        l.chunk_height = to_int(tiff.integer(TAG_TILE_LENGTH, 0));
+        l.offsets = tiff.integers(TAG_TILE_OFFSETS);
+        l.byte_counts = tiff.integers(TAG_TILE_BYTE_COUNTS);
+    } else {
+        l.chunk_width = l.width;
+        l.chunk_height = static_cast<int>(std::min<uint64_t>(tiff.integer(TAG_ROWS_PER_STRIP, l.height), l.height));
+        l.offsets = tiff.integers(TAG_STRIP_OFFSETS);
+        l.byte_counts = tiff.integers(TAG_STRIP_BYTE_COUNTS);
+    }
+    if (l.chunk_width <= 0 || l.chunk_height <= 0) throw std::runtime_error("Invalid TIFF strip/tile size");
+
+    // Every size below is derived from these, so none of them may wrap
+    size_t image_bytes = l.bytes();
+    if (__builtin_mul_overflow(image_bytes, l.samples, &image_bytes) ||
+        __builtin_mul_overflow(image_bytes, l.width, &image_bytes) ||
+        __builtin_mul_overflow(image_bytes, l.height, &image_bytes) ||
+        image_bytes > static_cast<size_t>(std::numeric_limits<off_t>::max()) - HEADER_DATA_OFFSET) {
+        throw std::runtime_error("TIFF image is too large");
+    }
+    size_t chunk_bytes = l.bytes();
+    if (__builtin_mul_overflow(chunk_bytes, l.chunk_samples(), &chunk_bytes) ||
+        __builtin_mul_overflow(chunk_bytes, l.chunk_width, &chunk_bytes) ||
+        __builtin_mul_overflow(chunk_bytes, l.chunk_height, &chunk_bytes) || chunk_bytes > MAX_CHUNK_BYTES) {
+        throw std::runtime_error("TIFF strip/tile is too large");
+    }
+
+    const size_t chunks = l.chunks_per_plane() * (l.planar == 2 ? l.samples : 1);
+    if (l.offsets.size() < chunks || l.byte_counts.size() < chunks) {
+        throw std::runtime_error("TIFF strip/tile offsets are incomplete");
+    }
+    for (size_t i = 0; i < chunks; i++) tiff.need(l.offsets[i], l.byte_counts[i]);
+    return l;
+}
+
+std::array<double, 6> read_transform(const TiffFile& tiff) {
+    auto matrix = tiff.doubles(TAG_MODEL_TRANSFORMATION);
+    if (matrix.size() >= 16) {
+        return {matrix[0], matrix[1], matrix[3], matrix[4], matrix[5], matrix[7]};
+    }
+
+    auto scale = tiff.doubles(TAG_MODEL_PIXEL_SCALE);
+    auto tiepoint = tiff.doubles(TAG_MODEL_TIEPOINT);
+    if (scale.size() < 2 || tiepoint.size() < 6) return {1.0, 0.0, 0.0, 0.0, 1.0, 0.0};
+
+    std::array<double, 6> t = {
+        scale[0], 0.0, tiepoint[3] - tiepoint[0] * scale[0],
+        0.0, -scale[1], tiepoint[4] + tiepoint[1] * scale[1]
+    };
+
+    // PixelIsPoint tiepoints refer to pixel centers; shift to the corner like GDAL
+    auto keys = tiff.integers(TAG_GEO_KEY_DIRECTORY);
+    for (size_t k = 4; k + 3 < keys.size(); k += 4) {
+        if (keys[k] == GEOKEY_RASTER_TYPE && keys[k + 1] == 0 && keys[k + 3] == RASTER_PIXEL_IS_POINT) {
+            t[2] -= 0.5 * t[0];
+            t[5] -= 0.5 * t[4];
+        }
+    }
+    return t;
+}
+
+std::string read_crs(const TiffFile& tiff) {
+    auto keys = tiff.integers(TAG_GEO_KEY_DIRECTORY);
+    uint64_t projected = 0;
+    uint64_t geographic = 0;
+    for (size_t k = 4; k + 3 < keys.size(); k += 4) {
+        if (keys[k + 1] != 0) continue;  // value stored elsewhere: not an EPSG code
+        if (keys[k] == GEOKEY_PROJECTED_CS_TYPE) projected = keys[k + 3];
+        if (keys[k] == GEOKEY_GEOGRAPHIC_TYPE) geographic = keys[k + 3];
+    }
+    const uint64_t code = projected ? projected : geographic;
+    if (code == 0 || code == GEOKEY_USER_DEFINED) return "";
+    return "EPSG:" + std::to_string(code);
+}
+
+std::optional<double> read_nodata(const TiffFile& tiff) {
+    std::string text = tiff.ascii(TAG_GDAL_NODATA);
+    // from_chars ignores the locale (stod would read "1.5" as 1 under
+    // de_DE) but takes no leading whitespace or '+'
+    const size_t start = text.find_first_not_of(" \t\n\r");
+    if (start == std::string::npos) return std::nullopt;
+    text.erase(0, start);
+    if (text[0] == '+') text.erase(0, 1);
+    double value;
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);  // "nan", "-inf" too
+    if (result.ec != std::errc()) return std::nullopt;
+    return value;
+}
+
+void write_json(const std::string& path, const GeoMetadata& meta) {
+    std::ostringstream json;
+    json.precision(17);
+    json << "{\n"
+         << "  \"dtype\": \"" << meta.dtype() << "\",\n"
+         << "  \"count\": " << meta.count << ",\n"
+         << "  \"height\": " << meta.height << ",\n"
+         << "  \"width\": " << meta.width << ",\n"
+         << "  \"transform\": [";
+    for (size_t i = 0; i < meta.transform.size(); i++) {
+        json << (i ? ", " : "") << meta.transform[i];
+    }
+    json << "],\n  \"crs\": ";
+    if (meta.crs.empty()) json << "null"; else json << '"' << meta.crs << '"';
+    json << ",\n  \"nodata\": ";
+    if (!meta.nodata) {
+        json << "null";
+    } else if (std::isnan(*meta.nodata)) {
+        json << "NaN";  // what Python's json module writes
+    } else if (std::isinf(*meta.nodata)) {
+        json << (*meta.nodata < 0 ? "-Infinity" : "Infinity");
+    } else {
+        json << *meta.nodata;
+    }
+    json << "\n}\n";
+
+    std::ofstream file(path);
+    if (!file) throw std::runtime_error("Cannot write " + path);
+    file << json.str();
+}
+
+void decode_chunk(const TiffFile& tiff, const Layout& l, size_t index, uint8_t* out,
+                  std::vector<uint8_t>& buffer, std::vector<uint8_t>& scratch) {
+    const size_t per_plane = l.chunks_per_plane();
+    const int plane = static_cast<int>(index / per_plane);
+    const size_t in_plane = index % per_plane;
+    const int cy = static_cast<int>(in_plane / l.chunks_across());
+    const int cx = static_cast<int>(in_plane % l.chunks_across());
+
+    const int x0 = cx * l.chunk_width;
+    const int y0 = cy * l.chunk_height;
+    const int cols = std::min(l.chunk_width, l.width - x0);
+    const int rows = std::min(l.chunk_height, l.height - y0);
+    // Tiles are always full size in the file; the last strip is not
+    const int stored_rows = l.tiled ? l.chunk_height : rows;
+    const int samples = l.chunk_samples();
+    const int bytes = l.bytes();
+    const size_t row_values = static_cast<size_t>(l.chunk_width) * samples;
+    const size_t row_bytes = row_values * bytes;
+    const size_t chunk_bytes = row_bytes * stored_rows;
+
+    const size_t n = l.byte_counts[index];
+    if (n == 0) return;  // sparse chunk: the output is already zero-filled
+    buffer.assign(chunk_bytes, 0);
+    const uint8_t* src = tiff.data() + l.offsets[index];
+    switch (l.compression) {
+        case COMPRESSION_NONE: std::memcpy(buffer.data(), src, std::min(n, chunk_bytes)); break;
+        case COMPRESSION_LZW: decode_lzw(src, n, buffer.data(), chunk_bytes); break;
+        case COMPRESSION_PACKBITS: decode_packbits(src, n, buffer.data(), chunk_bytes); break;
+        default: decode_deflate(src, n, buffer.data(), chunk_bytes); break;
+    }
+
+    for (int r = 0; r < stored_rows; r++) {
+        uint8_t* row = buffer.data() + r * row_bytes;
+        if (l.predictor == 3) {
+            undo_floating_point(row, row_values, samples, bytes, scratch);
+            continue;
+        }
+        if (tiff.swap() && bytes > 1) byte_swap(row, row_values, bytes);
+        if (l.predictor == 2) {
+            switch (bytes) {
+                case 1: undo_horizontal<uint8_t>(row, row_values, samples); break;
+                case 2: undo_horizontal<uint16_t>(row, row_values, samples); break;
+                case 4: undo_horizontal<uint32_t>(row, row_values, samples); break;
+                default: undo_horizontal<uint64_t>(row, row_values, samples); break;
+            }
+        }
+    }
+
+    // Scatter into the BSQ output
+    const size_t band_bytes = static_cast<size_t>(l.width) * l.height * bytes;
+    for (int r = 0; r < rows; r++) {
+        const uint8_t* row = buffer.data() + r * row_bytes;
+        const size_t dst_offset = (static_cast<size_t>(y0 + r) * l.width + x0) * bytes;
+        if (samples == 1) {
+            std::memcpy(out + plane * band_bytes + dst_offset, row, static_cast<size_t>(cols) * bytes);
+            continue;
+        }
+        for (int s = 0; s < samples; s++) {
+            uint8_t* dst = out + s * band_bytes + dst_offset;
+            switch (bytes) {
+                case 1: deinterleave<uint8_t>(row, dst, cols, samples, s); break;
+                case 2: deinterleave<uint16_t>(row, dst, cols, samples, s); break;
+                case 4: deinterleave<uint32_t>(row, dst, cols, samples, s); break;
+                default: deinterleave<uint64_t>(row, dst, cols, samples, s); break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+GeoMetadata convert_tiff(const std::string& tiff_path, const std::string& output_base,
+                         const ConvertOptions& options) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+    // The decoders write pixels in host order and assume it is little-endian
+    (void)tiff_path, (void)output_base, (void)options;
+    throw std::runtime_error("convert_tiff needs a little-endian host");
+#else
+    const std::string bin_path = output_base + ".bin";
+    const std::string json_path = output_base + ".json";
+    if (!options.overwrite && (access(bin_path.c_str(), F_OK) == 0 || access(json_path.c_str(), F_OK) == 0)) {
+        throw std::runtime_error("Output files already exist: " + output_base + ".*");
+    }
+
+    MappedFile file(tiff_path);
+    TiffFile tiff(file);
+    Layout layout = read_layout(tiff);
+
+    GeoMetadata meta;
+    meta.dtype_id = parse_dtype(dtype_for(layout.bits, layout.sample_format));
+    meta.count = layout.samples;
+    meta.height = layout.height;
+    meta.width = layout.width;
+    meta.transform = read_transform(tiff);
+    meta.crs = read_crs(tiff);
+    meta.nodata = read_nodata(tiff);
+
+    // Decode straight into the mapped output file
+    RasterHeader header{};
+    if (options.write_header) header = make_header(meta);
+    const size_t data_offset = options.write_header ? HEADER_DATA_OFFSET : 0;
+    const size_t total = data_offset + meta.total_bytes();
+    int fd = open(bin_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("Cannot write " + bin_path);
+    // Reserve the blocks up front: a write fault on a full disk would be
+    // SIGBUS on the mapping rather than an exception
+    if (posix_fallocate(fd, 0, static_cast<off_t>(total)) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot size " + bin_path);
+    }
+    void* mapped = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) throw std::runtime_error("mmap failed: " + bin_path);
+
+    uint8_t* pixels = static_cast<uint8_t*>(mapped) + data_offset;
+    if (options.write_header) std::memcpy(mapped, &header, sizeof(header));
+
+    const size_t chunks = layout.chunks_per_plane() * (layout.planar == 2 ? layout.samples : 1);
+    // Decode buffers belong to this call, one pair per worker, so the pool
+    // threads keep nothing once it returns
+    const unsigned workers = resolve_threads(options.threads, chunks);
+    std::vector<std::vector<uint8_t>> buffers(workers), scratch(workers);
+    try {
+        parallel_for_workers(chunks, options.threads, [&](size_t worker, size_t i) {
+            decode_chunk(tiff, layout, i, pixels, buffers[worker], scratch[worker]);
+        });
+    } catch (...) {
+        munmap(mapped, total);
+        std::remove(bin_path.c_str());
+        throw;
+    }
+    munmap(mapped, total);
+
+    write_json(json_path, meta);
+
+    if (options.write_mask || options.write_occupancy) {
+        MMapReader reader(output_base);
+        if (options.write_mask) NodataMask::from_nodata(reader).save(output_base + ".mask");
+        if (options.write_occupancy) {
+            OccupancyIndex::build(reader, options.tile_size).save(output_base + ".occ");
+        }
+    }
+    return meta;
+#endif
+}
+
+} // namespace geoslice
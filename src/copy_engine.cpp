@@ -0,0 +1,195 @@
+#include "geoslice/copy_engine.hpp"
+#include "geoslice/metrics.hpp"
+#include "geoslice/thread_pool.hpp"
+#include "geoslice/trace.hpp"
+
+#include <dirent.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace geoslice {
+
+namespace {
+const char* NODE_DIR = "/sys/devices/system/node";
+
+std::string read_line(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+// Moves the calling thread onto cpus (within its current affinity) until
+// destroyed; best effort, like pin_thread
+class ScopedAffinity {
+public:
+    explicit ScopedAffinity(const cpu_set_t* cpus) {
+        if (!cpus || sched_getaffinity(0, sizeof(saved_), &saved_) != 0) return;
+        cpu_set_t set;
+        CPU_AND(&set, cpus, &saved_);
+        active_ = CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+    ~ScopedAffinity() {
+        if (active_) sched_setaffinity(0, sizeof(saved_), &saved_);
+    }
+
+    ScopedAffinity(const ScopedAffinity&) = delete;
+    ScopedAffinity& operator=(const ScopedAffinity&) = delete;
+
+private:
+    cpu_set_t saved_;
+    bool active_ = false;
+};
+
+std::vector<int> allowed_cpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> cpus;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) {
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+}
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        const std::string item = list.substr(pos, end - pos);
+        pos = end + 1;
+        if (item.empty() || item == "\n") continue;
+
+        char* rest = nullptr;
+        const long first = std::strtol(item.c_str(), &rest, 10);
+        long last = first;
+        if (*rest == '-') last = std::strtol(rest + 1, &rest, 10);
+        if (rest == item.c_str() || (*rest != '\0' && *rest != '\n') || first < 0 || last < first) {
+            throw std::invalid_argument("Bad CPU list: " + list);
+        }
+        for (long cpu = first; cpu <= last; cpu++) cpus.push_back(static_cast<int>(cpu));
+    }
+    return cpus;
+}
+
+std::vector<NumaNode> numa_nodes() {
+    const std::vector<int> allowed = allowed_cpus();
+    std::vector<NumaNode> nodes;
+
+    if (DIR* dir = opendir(NODE_DIR)) {
+        while (const dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                continue;
+            }
+            NumaNode node{std::stoi(name.substr(4)), {}};
+            try {
+                for (int cpu : parse_cpu_list(read_line(std::string(NODE_DIR) + "/" + name + "/cpulist"))) {
+                    if (std::binary_search(allowed.begin(), allowed.end(), cpu)) node.cpus.push_back(cpu);
+                }
+            } catch (const std::invalid_argument&) {
+                continue;
+            }
+            // Memory-only nodes and nodes outside our cpuset run nothing
+            if (!node.cpus.empty()) nodes.push_back(std::move(node));
+        }
+        closedir(dir);
+    }
+
+    if (nodes.empty()) nodes.push_back({0, allowed});
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return nodes;
+}
+
+CopyEngine::CopyEngine(const CopyEngineOptions& options)
+    : nodes_(numa_nodes())
+    , options_(options) {
+    if (options_.task_bytes == 0) throw std::invalid_argument("CopyEngine task_bytes must be positive");
+
+    for (size_t n = 0; n < nodes_.size(); n++) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : nodes_[n].cpus) {
+            if (cpu >= static_cast<int>(node_of_cpu_.size())) node_of_cpu_.resize(cpu + 1, -1);
+            node_of_cpu_[cpu] = static_cast<int>(n);
+            if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        node_sets_.push_back(set);
+    }
+}
+
+size_t CopyEngine::threads_on(size_t node, const Executor& executor) const {
+    const size_t wanted = options_.threads_per_node ? options_.threads_per_node : nodes_[node].cpus.size();
+    return std::min(wanted, executor.concurrency() + 1);
+}
+
+size_t CopyEngine::threads() const {
+    const auto executor = default_executor();
+    size_t n = 0;
+    for (size_t node = 0; node < nodes_.size(); node++) n = std::max(n, threads_on(node, *executor));
+    return n;
+}
+
+void CopyEngine::read_window(const MMapReader& reader, int x, int y, int width, int height, void* out) const {
+    GEOSLICE_TRACE_SCOPE("copy_engine.read_window");
+    if (!reader.is_valid_window(x, y, width, height)) {
+        throw std::out_of_range("Window out of bounds");
+    }
+    const size_t row_bytes = static_cast<size_t>(width) * reader.metadata().pixel_size();
+    const size_t band_bytes = row_bytes * height;
+    const int bands = reader.bands();
+    if (band_bytes * bands < options_.min_parallel_bytes) {
+        reader.read_window(x, y, width, height, out);
+        return;
+    }
+    GEOSLICE_COUNT(WindowCopies, 1);
+    GEOSLICE_COUNT(BytesCopied, band_bytes * bands);
+
+    // Stripes of whole rows of one band
+    const int rows = static_cast<int>(std::clamp<size_t>(options_.task_bytes / row_bytes, 1, height));
+    const int stripes_per_band = (height + rows - 1) / rows;
+    auto job = std::make_shared<detail::ParallelJob>();
+    job->count = static_cast<size_t>(stripes_per_band) * bands;
+    job->fn = [&, rows, stripes_per_band](size_t i) {
+        const int b = static_cast<int>(i / stripes_per_band);
+        const int row0 = static_cast<int>(i % stripes_per_band) * rows;
+        const int n = std::min(rows, height - row0);
+        reader.read_band(b, x, y + row0, width, n, static_cast<uint8_t*>(out) + b * band_bytes + row0 * row_bytes);
+    };
+
+    // Helpers on the caller's node do the first touch of out
+    const int cpu = sched_getcpu();
+    const int index = cpu >= 0 && cpu < static_cast<int>(node_of_cpu_.size()) ? node_of_cpu_[cpu] : -1;
+    const size_t node = index >= 0 ? static_cast<size_t>(index) : 0;
+    auto executor = default_executor();
+    const size_t helpers = std::min(threads_on(node, *executor) - 1, job->count - 1);
+    for (size_t h = 0; h < helpers; h++) {
+        executor->submit([job, pin = options_.pin, cpus = node_sets_[node]] {
+            ScopedAffinity on_node(pin ? &cpus : nullptr);
+            job->work();
+        });
+    }
+
+    job->work();
+    job->wait();
+    if (job->error) std::rethrow_exception(job->error);
+}
+
+} // namespace geoslice
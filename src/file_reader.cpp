@@ -0,0 +1,294 @@
+#include "geoslice/file_reader.hpp"
+#include "geoslice/metrics.hpp"
+#include "geoslice/thread_pool.hpp"
+#include "geoslice/trace.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+
+namespace geoslice {
+
+namespace {
+constexpr uint64_t ALIGN = DIRECT_IO_ALIGNMENT;
+
+uint64_t align_down(uint64_t v) { return v & ~(ALIGN - 1); }
+uint64_t align_up(uint64_t v) { return (v + ALIGN - 1) & ~(ALIGN - 1); }
+
+bool by_offset(const ReadRequest& a, const ReadRequest& b) { return a.offset < b.offset; }
+}
+
+FileReader::FileReader(const std::string& base_path, std::shared_ptr<ReaderBackend> backend,
+                       const FileReaderOptions& options)
+    : backend_(backend ? std::move(backend) : std::shared_ptr<ReaderBackend>(make_default_backend())) {
+    meta_ = read_metadata(base_path, &data_offset_);
+    if (options.direct) {
+        // Room for a request plus its widening to block boundaries
+        if (options.buffer_bytes < 4 * ALIGN || options.buffer_bytes % ALIGN != 0) {
+            throw std::invalid_argument("Direct I/O buffers must be a multiple of 4096 bytes, at least 16 KiB");
+        }
+        buffers_ = std::make_unique<AlignedBufferPool>(options.buffer_bytes, options.max_buffers);
+    }
+
+    const std::string bin_path = base_path + ".bin";
+    fd_ = open(bin_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) throw std::runtime_error("Cannot open " + bin_path);
+
+    struct stat st;
+    fstat(fd_, &st);
+    file_size_ = static_cast<size_t>(st.st_size);
+    if (data_offset_ > file_size_ || meta_.total_bytes() > file_size_ - data_offset_) {
+        close(fd_);
+        throw std::runtime_error("Raster data is larger than " + bin_path);
+    }
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_RANDOM);
+
+    if (options.direct) {
+        direct_fd_ = open(bin_path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        drop_after_read_ = direct_fd_ < 0;  // e.g. tmpfs has no O_DIRECT
+    }
+}
+
+FileReader::~FileReader() {
+    if (direct_fd_ >= 0) close(direct_fd_);
+    if (fd_ >= 0) close(fd_);
+}
+
+bool FileReader::is_valid_window(int x, int y, int width, int height) const {
+    return x >= 0 && y >= 0 &&
+           x + width <= meta_.width &&
+           y + height <= meta_.height &&
+           width > 0 && height > 0;
+}
+
+void FileReader::add_requests(const WindowRect& window, void* out, std::vector<ReadRequest>& requests) const {
+    if (!is_valid_window(window.x, window.y, window.width, window.height)) {
+        throw std::out_of_range("Window out of bounds");
+    }
+
+    const size_t psize = meta_.pixel_size();
+    const size_t row_bytes = static_cast<size_t>(meta_.width) * psize;
+    const size_t band_bytes = row_bytes * meta_.height;
+    const size_t span = static_cast<size_t>(window.width) * psize;
+    uint8_t* dst = static_cast<uint8_t*>(out);
+    GEOSLICE_COUNT(WindowCopies, 1);
+    GEOSLICE_COUNT(BytesCopied, span * window.height * meta_.count);
+
+    for (int b = 0; b < meta_.count; b++) {
+        for (int row = 0; row < window.height; row++) {
+            const uint64_t offset = data_offset_ + b * band_bytes +
+                                    static_cast<size_t>(window.y + row) * row_bytes + window.x * psize;
+            requests.push_back({offset, span, dst});
+            dst += span;
+        }
+    }
+}
+
+void FileReader::submit(std::vector<ReadRequest>& requests) const {
+    GEOSLICE_TIME(FileRead);
+    GEOSLICE_TRACE_SCOPE("file_read");
+    if (direct_fd_ >= 0) {
+        read_direct(requests);
+    } else {
+        read_buffered(requests);
+    }
+}
+
+void FileReader::read_buffered(std::vector<ReadRequest>& requests) const {
+    // Runs of overlapping or abutting requests (overlapping windows of a
+    // batch, neighbouring windows, the rows of full-width windows) become one
+    // read of their union. A run that is contiguous in the output too, such
+    // as a single request, is read straight into it; any other run is read
+    // into scratch and scattered afterwards.
+    std::sort(requests.begin(), requests.end(), by_offset);
+    struct Run {
+        size_t first, last;
+        uint64_t end;
+        bool direct;
+    };
+    std::vector<Run> runs;
+    for (size_t i = 0; i < requests.size(); i++) {
+        const uint64_t end = requests[i].offset + requests[i].length;
+        if (!runs.empty() && requests[i].offset <= runs.back().end) {
+            Run& run = runs.back();
+            const ReadRequest& prev = requests[i - 1];
+            run.direct = run.direct && requests[i].offset == run.end &&
+                         requests[i].dst == static_cast<uint8_t*>(prev.dst) + prev.length;
+            run.end = std::max(run.end, end);
+            run.last = i + 1;
+        } else {
+            runs.push_back({i, i + 1, end, true});
+        }
+    }
+
+    size_t scratch_bytes = 0;
+    for (const Run& run : runs) {
+        if (!run.direct) scratch_bytes += run.end - requests[run.first].offset;
+    }
+    std::vector<uint8_t> scratch(scratch_bytes);
+    std::vector<ReadRequest> reads;
+    reads.reserve(runs.size());
+    uint8_t* next = scratch.data();
+    for (const Run& run : runs) {
+        const uint64_t start = requests[run.first].offset;
+        if (run.direct) {
+            reads.push_back({start, static_cast<size_t>(run.end - start), requests[run.first].dst});
+        } else {
+            reads.push_back({start, static_cast<size_t>(run.end - start), next});
+            next += run.end - start;
+        }
+    }
+
+    uint64_t total = 0;
+    for (const auto& r : reads) total += r.length;
+    backend_->read(fd_, reads);
+    bytes_read_ += total;
+    GEOSLICE_COUNT(FileBytesRead, total);
+
+    for (size_t k = 0; k < runs.size(); k++) {
+        const Run& run = runs[k];
+        if (run.direct) continue;
+        const uint8_t* src = static_cast<const uint8_t*>(reads[k].dst);
+        for (size_t i = run.first; i < run.last; i++) {
+            std::memcpy(requests[i].dst, src + (requests[i].offset - reads[k].offset), requests[i].length);
+        }
+    }
+    if (drop_after_read_) drop_cached(reads);
+}
+
+void FileReader::read_direct(std::vector<ReadRequest>& requests) const {
+    // Split requests so that each one, widened to block boundaries, fits a
+    // buffer. The partial block at the end of the file cannot be read with
+    // O_DIRECT; requests reaching into it are read buffered.
+    const size_t max_piece = buffers_->buffer_bytes() - 2 * ALIGN;
+    const uint64_t direct_end = align_down(file_size_);
+    std::vector<ReadRequest> pieces;
+    std::vector<ReadRequest> tail;
+    pieces.reserve(requests.size());
+    for (const auto& r : requests) {
+        for (size_t done = 0; done < r.length; done += max_piece) {
+            const ReadRequest piece{r.offset + done, std::min(max_piece, r.length - done),
+                                    static_cast<uint8_t*>(r.dst) + done};
+            (align_up(piece.offset + piece.length) > direct_end ? tail : pieces).push_back(piece);
+        }
+    }
+    std::sort(pieces.begin(), pieces.end(), by_offset);
+
+    // Coalesce: a segment is one aligned read covering pieces [first, last)
+    struct Segment {
+        uint64_t offset;
+        size_t length;
+        size_t first, last;
+    };
+    std::vector<Segment> segments;
+    for (size_t i = 0; i < pieces.size(); i++) {
+        const uint64_t start = align_down(pieces[i].offset);
+        const uint64_t end = align_up(pieces[i].offset + pieces[i].length);
+        if (!segments.empty()) {
+            Segment& s = segments.back();
+            if (start <= s.offset + s.length && end - s.offset <= buffers_->buffer_bytes()) {
+                s.length = std::max<size_t>(s.length, end - s.offset);
+                s.last = i + 1;
+                continue;
+            }
+        }
+        segments.push_back({start, static_cast<size_t>(end - start), i, i + 1});
+    }
+
+    for (size_t g = 0; g < segments.size(); g += buffers_->capacity()) {
+        const size_t n = std::min(buffers_->capacity(), segments.size() - g);
+        const auto lease = buffers_->acquire(n);
+        std::vector<ReadRequest> reads;
+        reads.reserve(n);
+        for (size_t k = 0; k < n; k++) reads.push_back({segments[g + k].offset, segments[g + k].length, lease[k]});
+        backend_->read(direct_fd_, reads);
+        for (const auto& r : reads) {
+            bytes_read_ += r.length;
+            GEOSLICE_COUNT(FileBytesRead, r.length);
+        }
+
+        for (size_t k = 0; k < n; k++) {
+            const Segment& s = segments[g + k];
+            for (size_t i = s.first; i < s.last; i++) {
+                std::memcpy(pieces[i].dst, lease[k] + (pieces[i].offset - s.offset), pieces[i].length);
+            }
+        }
+    }
+
+    if (!tail.empty()) {
+        read_buffered(tail);
+        drop_cached(tail);
+    }
+}
+
+void FileReader::drop_cached(std::vector<ReadRequest>& requests) const {
+    // One fadvise per run of touching requests, not per row
+    std::sort(requests.begin(), requests.end(), by_offset);
+    uint64_t start = requests.front().offset;
+    uint64_t end = start;
+    for (const auto& r : requests) {
+        if (r.offset > end) {
+            posix_fadvise(fd_, static_cast<off_t>(start), static_cast<off_t>(end - start), POSIX_FADV_DONTNEED);
+            start = r.offset;
+        }
+        end = std::max<uint64_t>(end, r.offset + r.length);
+    }
+    posix_fadvise(fd_, static_cast<off_t>(start), static_cast<off_t>(end - start), POSIX_FADV_DONTNEED);
+}
+
+void FileReader::read_window(int x, int y, int width, int height, void* out) const {
+    std::vector<ReadRequest> requests;
+    requests.reserve(static_cast<size_t>(meta_.count) * std::max(height, 0));
+    add_requests({x, y, width, height}, out, requests);
+    submit(requests);
+}
+
+void FileReader::read_windows(const std::vector<WindowRect>& windows, const std::vector<void*>& outs) const {
+    if (windows.size() != outs.size()) {
+        throw std::invalid_argument("read_windows needs one output per window");
+    }
+    std::vector<ReadRequest> requests;
+    for (size_t i = 0; i < windows.size(); i++) add_requests(windows[i], outs[i], requests);
+    if (requests.empty()) return;
+    submit(requests);
+}
+
+void FileReader::scan_strips(int rows, const std::function<void(const WindowRect&, const void*)>& fn) const {
+    if (rows <= 0) throw std::invalid_argument("Strip height must be positive");
+    rows = std::min(rows, meta_.height);
+
+    const auto strip_at = [&](int y) { return WindowRect{0, y, meta_.width, std::min(rows, meta_.height - y)}; };
+    const size_t strip_bytes = static_cast<size_t>(meta_.count) * rows * meta_.width * meta_.pixel_size();
+    std::vector<uint8_t> current(strip_bytes);
+    std::vector<uint8_t> next(strip_bytes);
+
+    WindowRect strip = strip_at(0);
+    read_window(strip.x, strip.y, strip.width, strip.height, current.data());
+    for (int y = 0; y < meta_.height; y += rows) {
+        strip = strip_at(y);
+        // The read-ahead runs on the shared I/O threads, not a thread per strip
+        std::future<void> pending;
+        if (y + rows < meta_.height) {
+            auto read = std::make_shared<std::packaged_task<void()>>([this, &next, s = strip_at(y + rows)] {
+                read_window(s.x, s.y, s.width, s.height, next.data());
+            });
+            pending = read->get_future();
+            io_executor()->submit([read] { (*read)(); });
+        }
+        try {
+            fn(strip, current.data());
+        } catch (...) {
+            if (pending.valid()) pending.wait();
+            throw;
+        }
+        if (pending.valid()) pending.get();
+        std::swap(current, next);
+    }
+}
+
+} // namespace geoslice
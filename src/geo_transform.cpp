@@ -1,4 +1,5 @@
 #include "geoslice/geo_transform.hpp"
+#include "geoslice/trace.hpp"
 #include <cmath>
 
 namespace geoslice {
@@ -69,6 +70,7 @@ std::pair<double, double> GeoTransform::utm_to_latlon(double x, double y) const
 }
 
 std::pair<int, int> GeoTransform::latlon_to_pixel(double lat, double lon) const {
+    GEOSLICE_TRACE_SCOPE("transform.latlon_to_pixel");
     auto [utm_x, utm_y] = latlon_to_utm(lat, lon);
     int px = static_cast<int>((utm_x - origin_x_) / pixel_size_x_);
     int py = static_cast<int>((origin_y_ - utm_y) / pixel_size_y_);
@@ -76,12 +78,14 @@ std::pair<int, int> GeoTransform::latlon_to_pixel(double lat, double lon) const
 }
 
 std::pair<double, double> GeoTransform::pixel_to_latlon(int px, int py) const {
+    GEOSLICE_TRACE_SCOPE("transform.pixel_to_latlon");
     double utm_x = origin_x_ + px * pixel_size_x_;
     double utm_y = origin_y_ - py * pixel_size_y_;
     return utm_to_latlon(utm_x, utm_y);
 }
 
 std::pair<int, int> GeoTransform::fov_to_pixels(double altitude_m, double fov_deg) const {
+    GEOSLICE_TRACE_SCOPE("transform.fov_to_pixels");
     double ground_width = 2 * altitude_m * std::tan(deg2rad(fov_deg / 2));
     int px_width = static_cast<int>(ground_width / pixel_size_x_);
     int px_height = static_cast<int>(ground_width / pixel_size_y_);
@@ -0,0 +1,200 @@
+#include "geoslice/histogram.hpp"
+#include "geoslice/parallel.hpp"
+#include "geoslice/simd.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace geoslice {
+
+namespace {
+
+constexpr int SUB_HISTOGRAMS = 4;
+
+template<typename T>
+struct BandPass {
+    bool has_nodata;
+    T nodata;
+
+    bool valid(T v) const {
+        return (!has_nodata || v != nodata) && !is_nan(v);
+    }
+};
+
+template<typename T>
+GEOSLICE_MULTIVERSION
+std::pair<double, double> data_range(const TypedWindowView<T>& view, int b, int y0, int y1,
+                                     const BandPass<T>& pass) {
+    // Independent lanes vectorize the float min/max without -ffast-math
+    T lo[SUB_HISTOGRAMS], hi[SUB_HISTOGRAMS];
+    std::fill(lo, lo + SUB_HISTOGRAMS, std::numeric_limits<T>::max());
+    std::fill(hi, hi + SUB_HISTOGRAMS, std::numeric_limits<T>::lowest());
+    auto add = [&](int k, T v) {
+        // Infinite pixels are valid data but would make the range unbinnable
+        const bool ok = pass.valid(v) && is_finite(v);
+        lo[k] = (ok && v < lo[k]) ? v : lo[k];
+        hi[k] = (ok && v > hi[k]) ? v : hi[k];
+    };
+    for (int y = y0; y < y1; y++) {
+        const T* row = view.row(b, y);
+        int x = 0;
+        for (; x + SUB_HISTOGRAMS <= view.width; x += SUB_HISTOGRAMS) {
+            for (int k = 0; k < SUB_HISTOGRAMS; k++) add(k, row[x + k]);
+        }
+        for (; x < view.width; x++) add(0, row[x]);
+    }
+    for (int k = 1; k < SUB_HISTOGRAMS; k++) {
+        lo[0] = std::min(lo[0], lo[k]);
+        hi[0] = std::max(hi[0], hi[k]);
+    }
+    return {static_cast<double>(lo[0]), static_cast<double>(hi[0])};
+}
+
+// 8-bit values index the bins directly; nodata is zeroed after the fact
+// instead of being tested per pixel.
+template<typename T>
+GEOSLICE_MULTIVERSION
+void count_direct(const TypedWindowView<T>& view, int b, int y0, int y1, uint64_t* sub) {
+    constexpr int offset = std::is_signed_v<T> ? 128 : 0;
+    for (int y = y0; y < y1; y++) {
+        const T* row = view.row(b, y);
+        int x = 0;
+        for (; x + SUB_HISTOGRAMS <= view.width; x += SUB_HISTOGRAMS) {
+            sub[0 * 256 + row[x + 0] + offset]++;
+            sub[1 * 256 + row[x + 1] + offset]++;
+            sub[2 * 256 + row[x + 2] + offset]++;
+            sub[3 * 256 + row[x + 3] + offset]++;
+        }
+        for (; x < view.width; x++) sub[row[x] + offset]++;
+    }
+}
+
+template<typename T>
+GEOSLICE_MULTIVERSION
+void count_binned(const TypedWindowView<T>& view, int b, int y0, int y1, const BandPass<T>& pass,
+                  double lo, double hi, int bins, uint64_t* sub) {
+    const double width = hi - lo;
+    const double scale = width > 0 ? bins / width : 0.0;
+    // A subnormal width overflows the scale; divide by the width instead
+    const bool divide = !is_finite(scale);
+    const double last = static_cast<double>(bins - 1);
+    auto bin_of = [&](T v, int& bin) {
+        const double d = static_cast<double>(v);
+        if (!pass.valid(v) || d < lo || d > hi) return false;
+        // Clamped in double before the cast: converting inf or NaN to int is
+        // undefined, and a bad index here would write out of bounds
+        const double pos = divide ? (d - lo) / width * bins : (d - lo) * scale;
+        bin = pos > 0 ? static_cast<int>(std::min(last, pos)) : 0;
+        return true;
+    };
+
+    for (int y = y0; y < y1; y++) {
+        const T* row = view.row(b, y);
+        int x = 0;
+        for (; x + SUB_HISTOGRAMS <= view.width; x += SUB_HISTOGRAMS) {
+            for (int k = 0; k < SUB_HISTOGRAMS; k++) {
+                int bin;
+                if (bin_of(row[x + k], bin)) sub[k * bins + bin]++;
+            }
+        }
+        for (; x < view.width; x++) {
+            int bin;
+            if (bin_of(row[x], bin)) sub[bin]++;
+        }
+    }
+}
+
+void validate(const HistogramOptions& options) {
+    if (options.bins <= 0) throw std::invalid_argument("Histogram needs at least one bin");
+    if ((options.min && !is_finite(*options.min)) || (options.max && !is_finite(*options.max))) {
+        throw std::invalid_argument("Histogram min and max must be finite");
+    }
+    if (options.min && options.max && *options.min > *options.max) {
+        throw std::invalid_argument("Histogram min is greater than max");
+    }
+}
+
+template<typename T>
+std::vector<BandHistogram> histogram(const TypedWindowView<T>& view, const HistogramOptions& options,
+                                     unsigned threads) {
+    constexpr bool eight_bit = sizeof(T) == 1;
+    constexpr double type_lo = static_cast<double>(std::numeric_limits<T>::lowest());
+
+    BandPass<T> pass{false, T{}};
+    pass.has_nodata = nodata_as(options.nodata, pass.nodata);
+
+    // Each task owns a contiguous block of rows and its own sub-histograms
+    const int tasks = static_cast<int>(resolve_threads(threads, view.height));
+    const int rows_per_task = (view.height + tasks - 1) / tasks;
+
+    std::vector<BandHistogram> result;
+    result.reserve(view.bands);
+    for (int b = 0; b < view.bands; b++) {
+        double lo, hi;
+        if (options.min && options.max) {
+            lo = *options.min;
+            hi = *options.max;
+        } else if (eight_bit) {
+            lo = options.min.value_or(type_lo);
+            hi = options.max.value_or(static_cast<double>(std::numeric_limits<T>::max()));
+        } else {
+            std::vector<std::pair<double, double>> ranges(tasks);
+            parallel_for(tasks, tasks, [&](size_t t) {
+                const int y0 = static_cast<int>(t) * rows_per_task;
+                ranges[t] = data_range(view, b, y0, std::min(y0 + rows_per_task, view.height), pass);
+            });
+            lo = std::numeric_limits<double>::max();
+            hi = std::numeric_limits<double>::lowest();
+            for (const auto& r : ranges) {
+                lo = std::min(lo, r.first);
+                hi = std::max(hi, r.second);
+            }
+            if (lo > hi) lo = hi = 0.0;  // no valid pixels
+            if (options.min) lo = *options.min;
+            if (options.max) hi = *options.max;
+        }
+
+        const bool direct = eight_bit && options.bins == 256 && lo == type_lo && hi == lo + 255;
+        const int bins = options.bins;
+        std::vector<std::vector<uint64_t>> subs(tasks, std::vector<uint64_t>(SUB_HISTOGRAMS * bins, 0));
+
+        parallel_for(tasks, tasks, [&](size_t t) {
+            const int y0 = static_cast<int>(t) * rows_per_task;
+            const int y1 = std::min(y0 + rows_per_task, view.height);
+            if constexpr (eight_bit) {
+                if (direct) return count_direct(view, b, y0, y1, subs[t].data());
+            }
+            count_binned(view, b, y0, y1, pass, lo, hi, bins, subs[t].data());
+        });
+
+        BandHistogram hist{lo, hi, std::vector<uint64_t>(bins, 0)};
+        for (const auto& sub : subs) {
+            for (int k = 0; k < SUB_HISTOGRAMS; k++) {
+                for (int i = 0; i < bins; i++) hist.counts[i] += sub[k * bins + i];
+            }
+        }
+        if (direct && pass.has_nodata) {
+            hist.counts[static_cast<int>(pass.nodata) - static_cast<int>(type_lo)] = 0;
+        }
+        result.push_back(std::move(hist));
+    }
+    return result;
+}
+
+} // namespace
+
+std::vector<BandHistogram> window_histogram(const WindowView& view, const HistogramOptions& options) {
+    validate(options);
+    return visit_window(view, [&](auto typed) { return histogram(typed, options, 1); });
+}
+
+std::vector<BandHistogram> window_histogram_parallel(const WindowView& view,
+                                                     const HistogramOptions& options,
+                                                     unsigned threads) {
+    validate(options);
+    return visit_window(view, [&](auto typed) { return histogram(typed, options, threads); });
+}
+
+} // namespace geoslice
@@ -0,0 +1,110 @@
+#include "geoslice/mask.hpp"
+#include "geoslice/mmap_reader.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace geoslice {
+
+NodataMask::NodataMask(int width, int height, std::vector<uint8_t> bits)
+    : width_(width)
+    , height_(height)
+    , bits_(std::move(bits))
+    , tiles_(summarize(*this)) {}
+
+OccupancyIndex NodataMask::summarize(const NodataMask& mask) {
+    if (mask.bits_.size() != mask.row_bytes() * mask.height_) {
+        throw std::invalid_argument("Mask size does not match raster dimensions");
+    }
+
+    const int tiles_x = (mask.width_ + TILE_SIZE - 1) / TILE_SIZE;
+    const int tiles_y = (mask.height_ + TILE_SIZE - 1) / TILE_SIZE;
+    std::vector<Coverage> tiles(static_cast<size_t>(tiles_x) * tiles_y);
+    for (int ty = 0; ty < tiles_y; ty++) {
+        for (int tx = 0; tx < tiles_x; tx++) {
+            const int x0 = tx * TILE_SIZE;
+            const int y0 = ty * TILE_SIZE;
+            tiles[ty * tiles_x + tx] = mask.scan(x0, y0, std::min(x0 + TILE_SIZE, mask.width_),
+                                                 std::min(y0 + TILE_SIZE, mask.height_));
+        }
+    }
+    return OccupancyIndex(mask.width_, mask.height_, TILE_SIZE, std::move(tiles));
+}
+
+NodataMask NodataMask::load(const std::string& path, int width, int height) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) throw std::runtime_error("Cannot open " + path);
+
+    std::vector<uint8_t> bits(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bits.data()), bits.size());
+    return NodataMask(width, height, std::move(bits));
+}
+
+NodataMask NodataMask::from_nodata(const MMapReader& reader) {
+    const int width = reader.width();
+    const int height = reader.height();
+    const size_t row_bytes = (static_cast<size_t>(width) + 7) / 8;
+    std::vector<uint8_t> bits(row_bytes * height, 0);
+
+    std::vector<uint8_t> valid(width);
+    for (int y = 0; y < height; y++) {
+        pixel_validity(reader, y, valid.data());
+        uint8_t* out = bits.data() + y * row_bytes;
+        for (int x = 0; x < width; x++) {
+            out[x >> 3] |= static_cast<uint8_t>(valid[x] << (7 - (x & 7)));
+        }
+    }
+    return NodataMask(width, height, std::move(bits));
+}
+
+void NodataMask::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Cannot write " + path);
+    file.write(reinterpret_cast<const char*>(bits_.data()), bits_.size());
+}
+
+Coverage NodataMask::scan(int x0, int y0, int x1, int y1) const {
+    bool any_valid = false;
+    bool any_invalid = false;
+    const int first = x0 >> 3;
+    const int last = (x1 - 1) >> 3;
+
+    for (int y = y0; y < y1; y++) {
+        const uint8_t* r = row(y);
+        for (int b = first; b <= last; b++) {
+            const int lo = b == first ? (x0 & 7) : 0;
+            const int hi = b == last ? ((x1 - 1) & 7) : 7;
+            const uint8_t m = static_cast<uint8_t>((0xFF >> lo) & (0xFF << (7 - hi)));
+            const uint8_t v = r[b] & m;
+            any_valid |= v != 0;
+            any_invalid |= v != m;
+        }
+        if (any_valid && any_invalid) return Coverage::Partial;
+    }
+    return any_valid ? Coverage::Full : Coverage::Empty;
+}
+
+Coverage NodataMask::coverage(int x, int y, int width, int height) const {
+    bool any_valid = false;
+    bool any_invalid = false;
+
+    for (int ty = y / TILE_SIZE; ty <= (y + height - 1) / TILE_SIZE; ty++) {
+        for (int tx = x / TILE_SIZE; tx <= (x + width - 1) / TILE_SIZE; tx++) {
+            Coverage c = tile(tx, ty);
+            if (c == Coverage::Partial) {
+                // Only the part of the tile inside the window matters
+                c = scan(std::max(x, tx * TILE_SIZE), std::max(y, ty * TILE_SIZE),
+                         std::min(x + width, (tx + 1) * TILE_SIZE),
+                         std::min(y + height, (ty + 1) * TILE_SIZE));
+            }
+            any_valid |= c != Coverage::Empty;
+            any_invalid |= c != Coverage::Full;
+            if (any_valid && any_invalid) return Coverage::Partial;
+        }
+    }
+    return any_valid ? Coverage::Full : Coverage::Empty;
+}
+
+} // namespace geoslice
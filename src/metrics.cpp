@@ -0,0 +1,153 @@
+#include "geoslice/metrics.hpp"
+
+#include <algorithm>
+
+namespace geoslice {
+
+namespace {
+struct Registry {
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::Count)> counters{};
+    std::array<LatencyHistogram, static_cast<size_t>(Op::Count)> latencies;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+int highest_bit(uint64_t v) { return 63 - __builtin_clzll(v); }
+
+// Upper bound of the bucket holding the q-quantile, capped at the maximum
+uint64_t quantile(const std::array<uint64_t, LatencyHistogram::BUCKETS>& counts, uint64_t total,
+                  uint64_t max_ns, double q) {
+    const uint64_t rank = static_cast<uint64_t>(q * total + 0.5);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank && seen > 0) return std::min(LatencyHistogram::bucket_upper(i), max_ns);
+    }
+    return max_ns;
+}
+}
+
+const char* counter_name(Counter counter) {
+    switch (counter) {
+        case Counter::WindowViews: return "window_views";
+        case Counter::WindowCopies: return "window_copies";
+        case Counter::BytesCopied: return "bytes_copied";
+        case Counter::FileBytesRead: return "file_bytes_read";
+        case Counter::WindowCacheHits: return "window_cache_hits";
+        case Counter::WindowCacheMisses: return "window_cache_misses";
+        case Counter::WindowCacheEvictions: return "window_cache_evictions";
+        case Counter::TileCacheHits: return "tile_cache_hits";
+        case Counter::TileCacheMisses: return "tile_cache_misses";
+        case Counter::TileCacheEvictions: return "tile_cache_evictions";
+        case Counter::PoolHits: return "pool_hits";
+        case Counter::PoolMisses: return "pool_misses";
+        case Counter::PoolEvictions: return "pool_evictions";
+        case Counter::PrefetchIssued: return "prefetch_issued";
+        case Counter::PrefetchFailed: return "prefetch_failed";
+        case Counter::PrefetchBytes: return "prefetch_bytes";
+        case Counter::Count: break;
+    }
+    return "unknown";
+}
+
+const char* op_name(Op op) {
+    switch (op) {
+        case Op::GetWindow: return "get_window";
+        case Op::ReadWindow: return "read_window";
+        case Op::ReadWindows: return "read_windows";
+        case Op::FileRead: return "file_read";
+        case Op::TiledRead: return "tiled_read";
+        case Op::TileDecode: return "tile_decode";
+        case Op::Prefetch: return "prefetch";
+        case Op::Count: break;
+    }
+    return "unknown";
+}
+
+bool metrics_enabled() {
+#ifdef GEOSLICE_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t LatencyHistogram::bucket(uint64_t ns) {
+    constexpr uint64_t sub = uint64_t(1) << SUB_BITS;
+    if (ns < sub) return static_cast<size_t>(ns);
+    const int shift = highest_bit(ns) - SUB_BITS;
+    return (static_cast<size_t>(shift + 1) << SUB_BITS) + static_cast<size_t>((ns >> shift) & (sub - 1));
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t bucket) {
+    constexpr uint64_t sub = uint64_t(1) << SUB_BITS;
+    if (bucket < sub) return bucket;
+    const int shift = static_cast<int>(bucket >> SUB_BITS) - 1;
+    const uint64_t lower = (sub + (bucket & (sub - 1))) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    buckets_[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (ns > prev && !max_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+std::array<uint64_t, LatencyHistogram::BUCKETS> LatencyHistogram::counts() const {
+    std::array<uint64_t, BUCKETS> out;
+    for (size_t i = 0; i < BUCKETS; i++) out[i] = buckets_[i].load(std::memory_order_relaxed);
+    return out;
+}
+
+MetricsSnapshot metrics_snapshot() {
+    MetricsSnapshot s;
+    s.enabled = metrics_enabled();
+    Registry& r = registry();
+    for (size_t i = 0; i < s.counters.size(); i++) s.counters[i] = r.counters[i].load(std::memory_order_relaxed);
+    for (size_t i = 0; i < s.latencies.size(); i++) {
+        const LatencyHistogram& h = r.latencies[i];
+        const auto counts = h.counts();
+        // Recording is not stopped: take the total from the buckets read
+        uint64_t total = 0;
+        for (uint64_t c : counts) total += c;
+        LatencySummary& l = s.latencies[i];
+        l.count = total;
+        if (total == 0) continue;
+        l.max_ns = h.max_ns();
+        l.mean_ns = static_cast<double>(h.sum_ns()) / total;
+        l.p50_ns = quantile(counts, total, l.max_ns, 0.50);
+        l.p90_ns = quantile(counts, total, l.max_ns, 0.90);
+        l.p99_ns = quantile(counts, total, l.max_ns, 0.99);
+        l.p999_ns = quantile(counts, total, l.max_ns, 0.999);
+    }
+    return s;
+}
+
+void reset_metrics() {
+    Registry& r = registry();
+    for (auto& c : r.counters) c.store(0, std::memory_order_relaxed);
+    for (auto& h : r.latencies) h.reset();
+}
+
+void count_metric(Counter counter, uint64_t n) {
+    registry().counters[static_cast<size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+}
+
+void record_latency(Op op, uint64_t ns) {
+    registry().latencies[static_cast<size_t>(op)].record(ns);
+}
+
+} // namespace geoslice
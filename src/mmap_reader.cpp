@@ -1,121 +1,379 @@
 #include "geoslice/mmap_reader.hpp"
+#include "geoslice/metrics.hpp"
+#include "geoslice/trace.hpp"
+#include "geoslice/parallel.hpp"
+#include "geoslice/thread_pool.hpp"
+#include "geoslice/raster_header.hpp"
 
+#include <cctype>
+#include <cstdlib>
 #include <fstream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <type_traits>
 
-// Minimal JSON parsing (no deps)
+// Minimal JSON parsing (no deps). Keys may come in any order; only flat
+// metadata objects as written by the converters are supported.
 namespace {
-std::string extract_string(const std::string& json, const std::string& key) {
-    auto pos = json.find("\"" + key + "\"");
-    if (pos == std::string::npos) return "";
-    pos = json.find(':', pos);
-    auto start = json.find('"', pos) + 1;
-    auto end = json.find('"', start);
-    return json.substr(start, end - start);
+size_t skip_space(const std::string& json, size_t pos) {
+    while (pos < json.size() && std::isspace(static_cast<unsigned char>(json[pos]))) pos++;
+    return pos;
 }
 
-int extract_int(const std::string& json, const std::string& key) {
-    auto pos = json.find("\"" + key + "\"");
+// Position of the value for "key", or npos. Ignores matches inside values.
+size_t find_value(const std::string& json, const char* key) {
+    const size_t len = std::strlen(key);
+    for (size_t pos = json.find(key); pos != std::string::npos; pos = json.find(key, pos + len)) {
+        const size_t end = pos + len;
+        if (pos == 0 || json[pos - 1] != '"' || end >= json.size() || json[end] != '"') continue;
+        const size_t colon = skip_space(json, end + 1);
+        if (colon < json.size() && json[colon] == ':') return skip_space(json, colon + 1);
+    }
+    return std::string::npos;
+}
+
+double parse_number(const std::string& json, size_t& pos, const char* key) {
+    const char* start = json.c_str() + pos;
+    char* end = nullptr;
+    const double value = std::strtod(start, &end);  // also takes NaN / Infinity
+    if (end == start) throw std::runtime_error(std::string("Invalid number for \"") + key + "\" in metadata");
+    pos += end - start;
+    return value;
+}
+
+// "" when the key is missing or null
+std::string extract_string(const std::string& json, const char* key) {
+    const size_t pos = find_value(json, key);
+    if (pos == std::string::npos || json[pos] != '"') return "";
+    const size_t end = json.find('"', pos + 1);
+    if (end == std::string::npos) throw std::runtime_error("Unterminated string in metadata");
+    return json.substr(pos + 1, end - pos - 1);
+}
+
+int extract_int(const std::string& json, const char* key) {
+    size_t pos = find_value(json, key);
     if (pos == std::string::npos) return 0;
-    pos = json.find(':', pos) + 1;
-    while (json[pos] == ' ') pos++;
-    return std::stoi(json.substr(pos));
+    const double value = parse_number(json, pos, key);
+    // Casting a double outside the int range (or NaN) is undefined
+    if (!(value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()) ||
+        static_cast<int>(value) != value) {
+        throw std::runtime_error(std::string("Invalid integer for \"") + key + "\" in metadata");
+    }
+    return static_cast<int>(value);
+}
+
+std::optional<double> extract_optional_double(const std::string& json, const char* key) {
+    size_t pos = find_value(json, key);
+    if (pos == std::string::npos || json.compare(pos, 4, "null") == 0) return std::nullopt;
+    return parse_number(json, pos, key);
 }
 
 std::array<double, 6> extract_transform(const std::string& json) {
     std::array<double, 6> result{};
-    auto pos = json.find("\"transform\"");
-    if (pos == std::string::npos) return result;
-    pos = json.find('[', pos);
+    size_t pos = find_value(json, "transform");
+    if (pos == std::string::npos || json[pos] != '[') return result;
     for (int i = 0; i < 6; i++) {
-        pos++;
-        while (json[pos] == ' ' || json[pos] == '\n') pos++;
-        result[i] = std::stod(json.substr(pos));
-        pos = json.find_first_of(",]", pos);
+        pos = skip_space(json, pos + 1);
+        result[i] = parse_number(json, pos, "transform");
+        pos = skip_space(json, pos);
     }
     return result;
 }
+
+geoslice::GeoMetadata read_json(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) throw std::runtime_error("Cannot open " + path);
+    std::string json(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(json.data(), json.size());
+
+    geoslice::GeoMetadata meta;
+    meta.dtype_id = geoslice::parse_dtype(extract_string(json, "dtype"));
+    meta.count = extract_int(json, "count");
+    meta.height = extract_int(json, "height");
+    meta.width = extract_int(json, "width");
+    meta.transform = extract_transform(json);
+    meta.crs = extract_string(json, "crs");
+    meta.nodata = extract_optional_double(json, "nodata");
+
+    // A missing key reads as 0; the data size must also fit a size_t
+    if (meta.count <= 0 || meta.height <= 0 || meta.width <= 0 ||
+        static_cast<size_t>(meta.count) * meta.height >
+            std::numeric_limits<size_t>::max() / meta.width / meta.pixel_size()) {
+        throw std::runtime_error("Invalid raster dimensions in " + path);
+    }
+    return meta;
+}
 }
 
 namespace geoslice {
 
-size_t GeoMetadata::pixel_size() const {
-    if (dtype == "uint8") return 1;
-    if (dtype == "uint16" || dtype == "int16") return 2;
-    if (dtype == "uint32" || dtype == "int32" || dtype == "float32") return 4;
-    if (dtype == "float64") return 8;
-    return 1;
-}
+// Maps a raster band by band in chunks of whole rows, keeping the most
+// recently used ones. Chunks are handed out as shared_ptrs so a reader
+// copying from one keeps it mapped even if another thread evicts it.
+class ChunkedMapping {
+public:
+    struct Chunk {
+        void* map = nullptr;
+        size_t map_size = 0;
+        const uint8_t* rows = nullptr;  // first row of the chunk
+
+        ~Chunk() { if (map) munmap(map, map_size); }
+    };
+
+    ChunkedMapping(int fd, const GeoMetadata& meta, size_t data_offset, const ReaderOptions& options)
+        : fd_(fd)
+        , data_offset_(data_offset)
+        , row_bytes_(static_cast<size_t>(meta.width) * meta.pixel_size())
+        , height_(meta.height)
+        , rows_per_chunk_(static_cast<int>(std::clamp<size_t>(options.chunk_bytes / row_bytes_, 1, meta.height)))
+        , chunks_per_band_((meta.height + rows_per_chunk_ - 1) / rows_per_chunk_)
+        , max_chunks_(std::max<size_t>(options.max_chunks, 1)) {}
+
+    ~ChunkedMapping() { close(fd_); }
+
+    int rows_per_chunk() const { return rows_per_chunk_; }
+    size_t max_chunks() const { return max_chunks_; }
+
+    // Largest mapping a chunk needs, page alignment included
+    size_t chunk_map_bytes() const {
+        return static_cast<size_t>(rows_per_chunk_) * row_bytes_ + page_size();
+    }
+
+    size_t mapped_chunks() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lru_.size();
+    }
+
+    std::shared_ptr<const Chunk> acquire(int band, int index) const {
+        const size_t key = static_cast<size_t>(band) * chunks_per_band_ + index;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = lookup_.find(key);
+        if (it != lookup_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->second;
+        }
+
+        const int row0 = index * rows_per_chunk_;
+        const int rows = std::min(rows_per_chunk_, height_ - row0);
+        const size_t band_bytes = row_bytes_ * height_;
+        const size_t offset = data_offset_ + band * band_bytes + row0 * row_bytes_;
+        const size_t aligned = offset - offset % page_size();
+
+        auto chunk = std::make_shared<Chunk>();
+        chunk->map_size = offset - aligned + rows * row_bytes_;
+        chunk->map = mmap(nullptr, chunk->map_size, PROT_READ, MAP_PRIVATE, fd_, static_cast<off_t>(aligned));
+        if (chunk->map == MAP_FAILED) {
+            chunk->map = nullptr;
+            throw std::runtime_error("mmap of raster chunk failed");
+        }
+        madvise(chunk->map, chunk->map_size, MADV_RANDOM);
+        chunk->rows = static_cast<const uint8_t*>(chunk->map) + (offset - aligned);
+
+        while (lru_.size() >= max_chunks_) {
+            lookup_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+        lru_.emplace_front(key, chunk);
+        lookup_[key] = lru_.begin();
+        return chunk;
+    }
+
+private:
+    static size_t page_size() {
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    int fd_;
+    size_t data_offset_;
+    size_t row_bytes_;
+    int height_;
+    int rows_per_chunk_;
+    int chunks_per_band_;
+    size_t max_chunks_;
+
+    using Entry = std::pair<size_t, std::shared_ptr<const Chunk>>;
+    mutable std::list<Entry> lru_;
+    mutable std::unordered_map<size_t, std::list<Entry>::iterator> lookup_;
+    mutable std::mutex mutex_;
+};
 
 size_t GeoMetadata::total_bytes() const {
     return static_cast<size_t>(count) * height * width * pixel_size();
 }
 
-MMapReader::MMapReader(const std::string& base_path) {
-    // Load JSON metadata
-    std::ifstream json_file(base_path + ".json");
-    if (!json_file) throw std::runtime_error("Cannot open " + base_path + ".json");
+size_t ResidencyMap::resident_tiles() const {
+    size_t n = 0;
+    for (uint64_t word : bits) n += static_cast<size_t>(__builtin_popcountll(word));
+    return n;
+}
+
+namespace {
+uintptr_t page_size() {
+    static const uintptr_t size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+}
+
+void fill_nodata(const GeoMetadata& meta, void* out, size_t pixels) {
+    dispatch_dtype(meta.dtype_id, [&](auto tag) {
+        using T = decltype(tag);
+        T value{};
+        if (!nodata_as(meta.nodata, value)) {
+            // NaN nodata only exists for float rasters; anything else fills 0
+            if constexpr (std::is_floating_point_v<T>) {
+                if (meta.nodata) value = std::numeric_limits<T>::quiet_NaN();
+            }
+        }
+        std::fill_n(static_cast<T*>(out), pixels, value);
+    });
+}
+
+GeoMetadata read_metadata(const std::string& base_path, size_t* data_offset) {
+    const std::string bin_path = base_path + ".bin";
+    const int fd = open(bin_path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + bin_path);
 
-    std::string json((std::istreambuf_iterator<char>(json_file)), std::istreambuf_iterator<char>());
+    struct stat st;
+    fstat(fd, &st);
+    RasterHeader header;
+    const ssize_t n = pread(fd, &header, sizeof(header), 0);
+    close(fd);
 
-    meta_.dtype = extract_string(json, "dtype");
-    meta_.count = extract_int(json, "count");
-    meta_.height = extract_int(json, "height");
-    meta_.width = extract_int(json, "width");
-    meta_.transform = extract_transform(json);
-    meta_.crs = extract_string(json, "crs");
+    GeoMetadata meta;
+    size_t offset = 0;
+    if (n == static_cast<ssize_t>(sizeof(header)) &&
+        parse_header(&header, static_cast<size_t>(st.st_size), meta, offset)) {
+        if (data_offset) *data_offset = offset;
+        return meta;
+    }
+    if (data_offset) *data_offset = 0;
+    return read_json(base_path + ".json");
+}
 
-    // Memory map binary file
+MMapReader::MMapReader(const std::string& base_path, const ReaderOptions& options) {
+    // Memory map binary file. The mapping keeps the file alive, so the fd is
+    // closed right away: open readers cost a mapping, not a descriptor.
     std::string bin_path = base_path + ".bin";
-    fd_ = open(bin_path.c_str(), O_RDONLY);
-    if (fd_ < 0) throw std::runtime_error("Cannot open " + bin_path);
+    const int fd = open(bin_path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + bin_path);
 
     struct stat st;
-    fstat(fd_, &st);
-    mapped_size_ = st.st_size;
+    fstat(fd, &st);
+    const size_t file_size = st.st_size;
 
-    mapped_data_ = mmap(nullptr, mapped_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (options.chunk_bytes > 0 && options.chunk_bytes < file_size) {
+        try {
+            open_chunked(base_path, fd, file_size, options);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        return;
+    }
+
+    mapped_size_ = file_size;
+
+    mapped_data_ = mmap(nullptr, mapped_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
     if (mapped_data_ == MAP_FAILED) {
-        close(fd_);
+        mapped_data_ = nullptr;
         throw std::runtime_error("mmap failed");
     }
 
+    try {
+        // Metadata: the binary header if the file has one, else the .json
+        size_t offset = 0;
+        if (!parse_header(mapped_data_, mapped_size_, meta_, offset)) {
+            meta_ = read_json(base_path + ".json");
+        }
+        if (meta_.total_bytes() > mapped_size_ - offset) {
+            throw std::runtime_error("Raster data shorter than its metadata describes: " + base_path);
+        }
+        data_offset_ = offset;
+        data_ = static_cast<const uint8_t*>(mapped_data_) + offset;
+        load_sidecars(base_path);
+    } catch (...) {
+        munmap(mapped_data_, mapped_size_);
+        throw;
+    }
+
     // Advise kernel for random access
     madvise(mapped_data_, mapped_size_, MADV_RANDOM);
 }
 
-MMapReader::~MMapReader() {
-    if (mapped_data_ && mapped_data_ != MAP_FAILED) {
-        munmap(mapped_data_, mapped_size_);
+void MMapReader::open_chunked(const std::string& base_path, int fd, size_t file_size,
+                              const ReaderOptions& options) {
+    RasterHeader header;
+    const ssize_t n = pread(fd, &header, sizeof(header), 0);
+    if (n != static_cast<ssize_t>(sizeof(header)) || !parse_header(&header, file_size, meta_, data_offset_)) {
+        meta_ = read_json(base_path + ".json");
+        data_offset_ = 0;
+    }
+    if (meta_.total_bytes() > file_size - std::min(data_offset_, file_size)) {
+        throw std::runtime_error("Raster data shorter than its metadata describes: " + base_path);
+    }
+    load_sidecars(base_path);
+    chunks_ = std::make_unique<ChunkedMapping>(fd, meta_, data_offset_, options);
+}
+
+void MMapReader::load_sidecars(const std::string& base_path) {
+    // Optional validity mask sidecar
+    std::string mask_path = base_path + ".mask";
+    if (access(mask_path.c_str(), R_OK) == 0) {
+        mask_.emplace(NodataMask::load(mask_path, meta_.width, meta_.height));
     }
-    if (fd_ >= 0) close(fd_);
+
+    // Tile occupancy: the .occ index from conversion, else the mask's summary
+    std::string occ_path = base_path + ".occ";
+    if (access(occ_path.c_str(), R_OK) == 0) {
+        occupancy_.emplace(OccupancyIndex::load(occ_path, meta_.width, meta_.height));
+    } else if (mask_) {
+        occupancy_.emplace(mask_->tiles());
+    }
+}
+
+MMapReader::~MMapReader() {
+    if (mapped_data_) munmap(mapped_data_, mapped_size_);
 }
 
 MMapReader::MMapReader(MMapReader&& other) noexcept
     : meta_(std::move(other.meta_))
+    , mask_(std::move(other.mask_))
+    , occupancy_(std::move(other.occupancy_))
     , mapped_data_(other.mapped_data_)
+    , data_(other.data_)
     , mapped_size_(other.mapped_size_)
-    , fd_(other.fd_) {
+    , data_offset_(other.data_offset_)
+    , chunks_(std::move(other.chunks_)) {
     other.mapped_data_ = nullptr;
-    other.fd_ = -1;
+    other.data_ = nullptr;
 }
 
 MMapReader& MMapReader::operator=(MMapReader&& other) noexcept {
     if (this != &other) {
-        if (mapped_data_ && mapped_data_ != MAP_FAILED) munmap(mapped_data_, mapped_size_);
-        if (fd_ >= 0) close(fd_);
+        if (mapped_data_) munmap(mapped_data_, mapped_size_);
 
         meta_ = std::move(other.meta_);
+        mask_ = std::move(other.mask_);
+        occupancy_ = std::move(other.occupancy_);
         mapped_data_ = other.mapped_data_;
+        data_ = other.data_;
         mapped_size_ = other.mapped_size_;
-        fd_ = other.fd_;
+        data_offset_ = other.data_offset_;
+        chunks_ = std::move(other.chunks_);
 
         other.mapped_data_ = nullptr;
-        other.fd_ = -1;
+        other.data_ = nullptr;
     }
     return *this;
 }
@@ -128,16 +386,19 @@ bool MMapReader::is_valid_window(int x, int y, int width, int height) const {
 }
 
 WindowView MMapReader::get_window(int x, int y, int width, int height) const {
+    GEOSLICE_TIME(GetWindow);
+    GEOSLICE_TRACE_SCOPE("get_window");
     if (!is_valid_window(x, y, width, height)) {
         throw std::out_of_range("Window out of bounds");
     }
+    if (chunks_) throw std::logic_error("get_window needs a fully mapped raster; use read_window");
 
     size_t psize = meta_.pixel_size();
     size_t band_stride = static_cast<size_t>(meta_.height) * meta_.width * psize;
     size_t row_stride = static_cast<size_t>(meta_.width) * psize;
 
-    const uint8_t* base = static_cast<const uint8_t*>(mapped_data_);
-    const uint8_t* window_start = base + y * row_stride + x * psize;
+    const uint8_t* window_start = data_ + y * row_stride + x * psize;
+    GEOSLICE_COUNT(WindowViews, 1);
 
     return WindowView{
         window_start,
@@ -146,8 +407,300 @@ WindowView MMapReader::get_window(int x, int y, int width, int height) const {
         width,
         band_stride,
         row_stride,
-        psize
+        psize,
+        meta_.dtype_id
     };
 }
 
+Coverage MMapReader::coverage(int x, int y, int width, int height) const {
+    if (!is_valid_window(x, y, width, height)) {
+        throw std::out_of_range("Window out of bounds");
+    }
+    if (mask_) return mask_->coverage(x, y, width, height);
+    if (occupancy_) return occupancy_->coverage(x, y, width, height);
+    return Coverage::Partial;
+}
+
+template<typename F>
+void MMapReader::for_each_page_run(int x, int y, int width, int height, F&& fn) const {
+    // A band of a narrow window in a wide raster is one run per row, of a
+    // full-width window one run
+    const uintptr_t page = page_size();
+    const size_t psize = meta_.pixel_size();
+    const size_t row_stride = static_cast<size_t>(meta_.width) * psize;
+    const size_t band_stride = row_stride * meta_.height;
+    uintptr_t start = 0, end = 0;
+    for (int b = 0; b < meta_.count; b++) {
+        for (int row = y; row < y + height; row++) {
+            const auto first = reinterpret_cast<uintptr_t>(data_ + b * band_stride + row * row_stride + x * psize);
+            const uintptr_t lo = first & ~(page - 1);
+            const uintptr_t hi = (first + width * psize + page - 1) & ~(page - 1);
+            if (lo > end) {
+                if (end > start) fn(start, end);
+                start = lo;
+            }
+            end = std::max(end, hi);
+        }
+    }
+    if (end > start) fn(start, end);
+}
+
+bool MMapReader::prefetch(int x, int y, int width, int height) const {
+    GEOSLICE_TIME(Prefetch);
+    GEOSLICE_TRACE_SCOPE("prefetch");
+    if (!is_valid_window(x, y, width, height)) {
+        throw std::out_of_range("Window out of bounds");
+    }
+    if (chunks_) {
+        GEOSLICE_COUNT(PrefetchFailed, 1);
+        return false;
+    }
+
+    size_t bytes = 0;
+    bool ok = true;
+    for_each_page_run(x, y, width, height, [&](uintptr_t start, uintptr_t end) {
+        ok = madvise(reinterpret_cast<void*>(start), end - start, MADV_WILLNEED) == 0 && ok;
+        bytes += end - start;
+    });
+
+    GEOSLICE_COUNT(PrefetchBytes, ok ? bytes : 0);
+    if (!ok) GEOSLICE_COUNT(PrefetchFailed, 1);
+    else GEOSLICE_COUNT(PrefetchIssued, 1);
+    return ok;
+}
+
+double MMapReader::residency(int x, int y, int width, int height) const {
+    if (!is_valid_window(x, y, width, height)) {
+        throw std::out_of_range("Window out of bounds");
+    }
+    if (chunks_) throw std::logic_error("residency needs a fully mapped raster");
+
+    const uintptr_t page = page_size();
+    std::vector<unsigned char> vec;
+    size_t resident = 0, total = 0;
+    for_each_page_run(x, y, width, height, [&](uintptr_t start, uintptr_t end) {
+        vec.resize((end - start) / page);
+        if (mincore(reinterpret_cast<void*>(start), end - start, vec.data()) != 0) {
+            throw std::runtime_error("mincore failed");
+        }
+        for (unsigned char v : vec) resident += v & 1;
+        total += vec.size();
+    });
+    return static_cast<double>(resident) / total;
+}
+
+ResidencyMap MMapReader::residency_map(int tile_size) const {
+    if (tile_size <= 0) throw std::invalid_argument("Tile size must be positive");
+    if (chunks_) throw std::logic_error("residency needs a fully mapped raster");
+
+    // One mincore over the whole mapping, then tiles check their row spans
+    const uintptr_t page = page_size();
+    const auto base = reinterpret_cast<uintptr_t>(mapped_data_);
+    std::vector<unsigned char> pages((mapped_size_ + page - 1) / page);
+    if (mincore(mapped_data_, mapped_size_, pages.data()) != 0) throw std::runtime_error("mincore failed");
+
+    ResidencyMap map;
+    map.tile_size = tile_size;
+    map.tiles_x = (meta_.width + tile_size - 1) / tile_size;
+    map.tiles_y = (meta_.height + tile_size - 1) / tile_size;
+    map.bits.assign((static_cast<size_t>(map.tiles_x) * map.tiles_y + 63) / 64, 0);
+    for (int ty = 0; ty < map.tiles_y; ty++) {
+        for (int tx = 0; tx < map.tiles_x; tx++) {
+            const int x = tx * tile_size;
+            const int y = ty * tile_size;
+            bool resident = true;
+            for_each_page_run(x, y, std::min(tile_size, meta_.width - x), std::min(tile_size, meta_.height - y),
+                              [&](uintptr_t start, uintptr_t end) {
+                for (uintptr_t p = start; p < end && resident; p += page) resident = pages[(p - base) / page] & 1;
+            });
+            if (resident) {
+                const size_t i = static_cast<size_t>(ty) * map.tiles_x + tx;
+                map.bits[i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+    }
+    return map;
+}
+
+size_t MMapReader::mapped_bytes() const {
+    return chunks_ ? chunks_->chunk_map_bytes() * chunks_->max_chunks() : mapped_size_;
+}
+
+size_t MMapReader::mapped_chunks() const {
+    return chunks_ ? chunks_->mapped_chunks() : 0;
+}
+
+template<typename F>
+void MMapReader::for_each_row(int b, int y0, int y1, F&& fn) const {
+    const size_t row_bytes = static_cast<size_t>(meta_.width) * meta_.pixel_size();
+    if (!chunks_) {
+        const uint8_t* band = data_ + b * row_bytes * meta_.height;
+        for (int y = y0; y < y1; y++) fn(y, band + y * row_bytes);
+        return;
+    }
+
+    const int rows_per_chunk = chunks_->rows_per_chunk();
+    for (int y = y0; y < y1;) {
+        const int index = y / rows_per_chunk;
+        const int end = std::min(y1, (index + 1) * rows_per_chunk);
+        const auto chunk = chunks_->acquire(b, index);
+        for (; y < end; y++) fn(y, chunk->rows + (y - index * rows_per_chunk) * row_bytes);
+    }
+}
+
+void MMapReader::read_window(int x, int y, int width, int height, void* out) const {
+    GEOSLICE_TIME(ReadWindow);
+    GEOSLICE_TRACE_SCOPE("read_window");  // the copy, page faults included
+    const Coverage cov = coverage(x, y, width, height);
+    GEOSLICE_COUNT(WindowCopies, 1);
+    GEOSLICE_COUNT(BytesCopied, static_cast<uint64_t>(meta_.count) * height * width * meta_.pixel_size());
+    const size_t band_bytes = static_cast<size_t>(height) * width * meta_.pixel_size();
+    for (int b = 0; b < meta_.count; b++) {
+        copy_band(b, x, y, width, height, cov, static_cast<uint8_t*>(out) + b * band_bytes);
+    }
+}
+
+std::future<void> MMapReader::read_window_async(int x, int y, int width, int height, void* out) const {
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    read_window_async(x, y, width, height, out, [promise](std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value();
+        }
+    });
+    return future;
+}
+
+void MMapReader::read_window_async(int x, int y, int width, int height, void* out,
+                                   std::function<void(std::exception_ptr)> done) const {
+    if (!is_valid_window(x, y, width, height)) {
+        throw std::out_of_range("Window out of bounds");
+    }
+    io_executor()->submit([this, x, y, width, height, out, done = std::move(done)] {
+        std::exception_ptr error;
+        try {
+            read_window(x, y, width, height, out);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        done(error);
+    });
+}
+
+void MMapReader::read_band(int band, int x, int y, int width, int height, void* out) const {
+    if (band < 0 || band >= meta_.count) throw std::out_of_range("Band out of range");
+    copy_band(band, x, y, width, height, coverage(x, y, width, height), static_cast<uint8_t*>(out));
+}
+
+void MMapReader::copy_band(int b, int x, int y, int width, int height, Coverage cov, uint8_t* dst) const {
+    if (cov == Coverage::Empty) {
+        fill_nodata(meta_, dst, static_cast<size_t>(height) * width);
+        return;
+    }
+
+    const size_t psize = meta_.pixel_size();
+    const size_t row_bytes = static_cast<size_t>(width) * psize;
+    const size_t x_offset = static_cast<size_t>(x) * psize;
+
+    if (cov == Coverage::Full || !occupancy_) {
+        for_each_row(b, y, y + height, [&](int, const uint8_t* row) {
+            std::memcpy(dst, row + x_offset, row_bytes);
+            dst += row_bytes;
+        });
+        return;
+    }
+
+    // Mixed window: copy occupied tiles, synthesize empty ones from a fill row
+    std::vector<uint8_t> fill_row(row_bytes);
+    fill_nodata(meta_, fill_row.data(), width);
+
+    struct Segment { int x0, x1; bool empty; };  // window-relative columns
+    std::vector<Segment> segments;
+    const int ts = occupancy_->tile_size();
+
+    for (int ty = y / ts; ty <= (y + height - 1) / ts; ty++) {
+        const int row0 = std::max(y, ty * ts) - y;
+        const int row1 = std::min(y + height, (ty + 1) * ts) - y;
+
+        segments.clear();
+        for (int tx = x / ts; tx <= (x + width - 1) / ts; tx++) {
+            const int x0 = std::max(x, tx * ts) - x;
+            const int x1 = std::min(x + width, (tx + 1) * ts) - x;
+            const bool empty = occupancy_->tile(tx, ty) == Coverage::Empty;
+            if (!segments.empty() && segments.back().empty == empty) {
+                segments.back().x1 = x1;
+            } else {
+                segments.push_back({x0, x1, empty});
+            }
+        }
+
+        if (segments.size() == 1 && segments[0].empty) {
+            for (int row = row0; row < row1; row++) {
+                std::memcpy(dst + row * row_bytes, fill_row.data(), row_bytes);
+            }
+            continue;
+        }
+        for_each_row(b, y + row0, y + row1, [&](int yy, const uint8_t* raster_row) {
+            uint8_t* d = dst + (yy - y) * row_bytes;
+            const uint8_t* src = raster_row + x_offset;
+            for (const auto& seg : segments) {
+                const size_t offset = seg.x0 * psize;
+                const size_t bytes = (seg.x1 - seg.x0) * psize;
+                std::memcpy(d + offset, (seg.empty ? fill_row.data() : src) + offset, bytes);
+            }
+        });
+    }
+}
+
+void MMapReader::read_windows(const std::vector<WindowRect>& windows, const std::vector<void*>& outs,
+                              unsigned threads) const {
+    GEOSLICE_TIME(ReadWindows);
+    GEOSLICE_TRACE_SCOPE("read_windows");
+    if (windows.size() != outs.size()) {
+        throw std::invalid_argument("read_windows needs one output per window");
+    }
+    for (const auto& w : windows) {
+        if (!is_valid_window(w.x, w.y, w.width, w.height)) {
+            throw std::out_of_range("Window out of bounds");
+        }
+    }
+    parallel_for(windows.size(), threads, [&](size_t i) {
+        const auto& w = windows[i];
+        read_window(w.x, w.y, w.width, w.height, outs[i]);
+    });
+}
+
+void MMapReader::scan_tiles(const std::function<void(const WindowRect&, const WindowView*)>& fn) const {
+    const int ts = occupancy_ ? occupancy_->tile_size() : OccupancyIndex::DEFAULT_TILE_SIZE;
+    std::vector<uint8_t> copy;
+
+    for (int ty = 0; ty * ts < meta_.height; ty++) {
+        for (int tx = 0; tx * ts < meta_.width; tx++) {
+            const WindowRect tile{
+                tx * ts,
+                ty * ts,
+                std::min(ts, meta_.width - tx * ts),
+                std::min(ts, meta_.height - ty * ts)
+            };
+            if (occupancy_ && occupancy_->tile(tx, ty) == Coverage::Empty) {
+                fn(tile, nullptr);
+            } else if (chunks_) {
+                // No zero-copy views in chunked mode: hand out a tile copy
+                const size_t psize = meta_.pixel_size();
+                const size_t row_bytes = static_cast<size_t>(tile.width) * psize;
+                copy.resize(row_bytes * tile.height * meta_.count);
+                read_window(tile.x, tile.y, tile.width, tile.height, copy.data());
+                const WindowView view{copy.data(), meta_.count, tile.height, tile.width,
+                                      row_bytes * tile.height, row_bytes, psize, meta_.dtype_id};
+                fn(tile, &view);
+            } else {
+                const WindowView view = get_window(tile.x, tile.y, tile.width, tile.height);
+                fn(tile, &view);
+            }
+        }
+    }
+}
+
 } // namespace geoslice
@@ -0,0 +1,220 @@
+#include "geoslice/mosaic.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace geoslice {
+
+namespace {
+// Sources must line up with the mosaic grid to within this fraction of a pixel
+constexpr double GRID_TOLERANCE = 1e-3;
+
+bool intersect(const WindowRect& a, const WindowRect& b, WindowRect& out) {
+    const int x0 = std::max(a.x, b.x);
+    const int y0 = std::max(a.y, b.y);
+    const int x1 = std::min(a.x + a.width, b.x + b.width);
+    const int y1 = std::min(a.y + a.height, b.y + b.height);
+    if (x0 >= x1 || y0 >= y1) return false;
+    out = {x0, y0, x1 - x0, y1 - y0};
+    return true;
+}
+
+bool same_size(double a, double b) {
+    return std::abs(a - b) <= 1e-9 * std::max(std::abs(a), std::abs(b));
+}
+
+bool same_nodata(const std::optional<double>& a, const std::optional<double>& b) {
+    if (!a || !b) return !a && !b;
+    return *a == *b || (is_nan(*a) && is_nan(*b));
+}
+
+// Copies the pixels of src that are not nodata over dst, so a source's
+// nodata never hides what an earlier source already put there
+template<typename T>
+void merge_row(T* dst, const T* src, size_t n, const std::optional<double>& nodata) {
+    T nd{};
+    const bool has_nd = nodata_as(nodata, nd);
+    const bool nan_nd = nodata && is_nan(*nodata);
+    for (size_t i = 0; i < n; i++) {
+        if ((has_nd && src[i] == nd) || (nan_nd && is_nan(src[i]))) continue;
+        dst[i] = src[i];
+    }
+}
+}
+
+MosaicReader::MosaicReader(const std::vector<std::string>& base_paths, std::shared_ptr<ReaderPool> pool)
+    : paths_(base_paths)
+    , pool_(pool ? std::move(pool) : std::make_shared<ReaderPool>()) {
+    if (paths_.empty()) throw std::invalid_argument("Mosaic needs at least one source");
+
+    std::vector<GeoMetadata> metas;
+    metas.reserve(paths_.size());
+    for (const auto& path : paths_) metas.push_back(read_metadata(path));
+
+    const GeoMetadata& first = metas.front();
+    const double px = first.transform[0];
+    const double py = -first.transform[4];
+    double origin_x = std::numeric_limits<double>::infinity();
+    double origin_y = -std::numeric_limits<double>::infinity();
+
+    for (size_t i = 0; i < metas.size(); i++) {
+        const auto& m = metas[i];
+        const auto& t = m.transform;
+        if (t[1] != 0.0 || t[3] != 0.0 || t[0] <= 0.0 || t[4] >= 0.0) {
+            throw std::invalid_argument("Mosaic sources must be north-up: " + paths_[i]);
+        }
+        if (m.dtype_id != first.dtype_id || m.count != first.count || m.crs != first.crs) {
+            throw std::invalid_argument("Mosaic source dtype, bands or CRS differ: " + paths_[i]);
+        }
+        if (!same_nodata(m.nodata, first.nodata)) {
+            throw std::invalid_argument("Mosaic source nodata differs: " + paths_[i]);
+        }
+        if (!same_size(t[0], px) || !same_size(-t[4], py)) {
+            throw std::invalid_argument("Mosaic source pixel size differs: " + paths_[i]);
+        }
+        origin_x = std::min(origin_x, t[2]);
+        origin_y = std::max(origin_y, t[5]);
+    }
+
+    int64_t width = 0;
+    int64_t height = 0;
+    int max_dim = 1;
+    extents_.reserve(metas.size());
+    for (size_t i = 0; i < metas.size(); i++) {
+        const auto& m = metas[i];
+        const double col = (m.transform[2] - origin_x) / px;
+        const double row = (origin_y - m.transform[5]) / py;
+        if (std::abs(col - std::round(col)) > GRID_TOLERANCE || std::abs(row - std::round(row)) > GRID_TOLERANCE) {
+            throw std::invalid_argument("Mosaic source is not on the common pixel grid: " + paths_[i]);
+        }
+        const int64_t x = std::llround(col);
+        const int64_t y = std::llround(row);
+        width = std::max<int64_t>(width, x + m.width);
+        height = std::max<int64_t>(height, y + m.height);
+        if (width > std::numeric_limits<int>::max() || height > std::numeric_limits<int>::max()) {
+            throw std::invalid_argument("Mosaic is too large");
+        }
+        extents_.push_back({static_cast<int>(x), static_cast<int>(y), m.width, m.height});
+        max_dim = std::max({max_dim, m.width, m.height});
+    }
+
+    meta_ = first;
+    meta_.width = static_cast<int>(width);
+    meta_.height = static_cast<int>(height);
+    meta_.transform = {px, 0.0, origin_x, 0.0, -py, origin_y};
+
+    // One cell per largest source: each source lands in at most four cells
+    cell_size_ = max_dim;
+    cells_x_ = (meta_.width + cell_size_ - 1) / cell_size_;
+    cells_y_ = (meta_.height + cell_size_ - 1) / cell_size_;
+    cells_.resize(static_cast<size_t>(cells_x_) * cells_y_);
+    for (size_t i = 0; i < extents_.size(); i++) {
+        const auto& e = extents_[i];
+        for (int cy = e.y / cell_size_; cy <= (e.y + e.height - 1) / cell_size_; cy++) {
+            for (int cx = e.x / cell_size_; cx <= (e.x + e.width - 1) / cell_size_; cx++) {
+                cells_[cy * cells_x_ + cx].push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+}
+
+bool MosaicReader::is_valid_window(int x, int y, int width, int height) const {
+    return x >= 0 && y >= 0 &&
+           x + width <= meta_.width &&
+           y + height <= meta_.height &&
+           width > 0 && height > 0;
+}
+
+std::vector<size_t> MosaicReader::sources_in(int x, int y, int width, int height) const {
+    std::vector<size_t> found;
+    if (!is_valid_window(x, y, width, height)) return found;
+
+    const WindowRect window{x, y, width, height};
+    WindowRect overlap{};
+    for (int cy = y / cell_size_; cy <= (y + height - 1) / cell_size_; cy++) {
+        for (int cx = x / cell_size_; cx <= (x + width - 1) / cell_size_; cx++) {
+            for (uint32_t i : cells_[cy * cells_x_ + cx]) {
+                if (intersect(window, extents_[i], overlap)) found.push_back(i);
+            }
+        }
+    }
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    return found;
+}
+
+size_t MosaicReader::open_sources() const {
+    return static_cast<size_t>(std::count_if(paths_.begin(), paths_.end(),
+                                             [&](const auto& path) { return pool_->contains(path); }));
+}
+
+std::shared_ptr<const MMapReader> MosaicReader::source(size_t i) const {
+    auto reader = pool_->acquire(paths_[i]);
+    if (reader->width() != extents_[i].width || reader->height() != extents_[i].height) {
+        throw std::runtime_error("Mosaic source changed since the catalog was opened: " + paths_[i]);
+    }
+    return reader;
+}
+
+void MosaicReader::read_window(int x, int y, int width, int height, void* out) const {
+    if (!is_valid_window(x, y, width, height)) {
+        throw std::out_of_range("Window out of bounds");
+    }
+
+    const WindowRect window{x, y, width, height};
+    const auto sources = sources_in(x, y, width, height);
+
+    // Common case: a single source holds the whole window. With nodata, an
+    // earlier source under it may still fill its nodata pixels.
+    WindowRect overlap{};
+    if (sources.size() == 1 || (!sources.empty() && !meta_.nodata)) {
+        const size_t last = sources.back();
+        if (intersect(window, extents_[last], overlap) && overlap.width == width && overlap.height == height) {
+            const auto& e = extents_[last];
+            source(last)->read_window(x - e.x, y - e.y, width, height, out);
+            return;
+        }
+    }
+
+    fill_nodata(meta_, out, static_cast<size_t>(meta_.count) * height * width);
+
+    // Each overlap is read band by band into scratch, then scattered into
+    // the window's rows. read_band works for chunked sources too, which have
+    // no zero-copy views, and fills the source's empty tiles with nodata;
+    // with a nodata value only the valid pixels are copied.
+    const size_t psize = meta_.pixel_size();
+    uint8_t* dst = static_cast<uint8_t*>(out);
+    std::vector<uint8_t> scratch;
+    for (size_t i : sources) {
+        if (!intersect(window, extents_[i], overlap)) continue;
+        const auto& e = extents_[i];
+        const auto reader = source(i);
+        const size_t row_bytes = static_cast<size_t>(overlap.width) * psize;
+        scratch.resize(row_bytes * overlap.height);
+
+        for (int b = 0; b < meta_.count; b++) {
+            reader->read_band(b, overlap.x - e.x, overlap.y - e.y, overlap.width, overlap.height, scratch.data());
+            for (int row = 0; row < overlap.height; row++) {
+                const size_t dst_row = static_cast<size_t>(b) * height + (overlap.y - y) + row;
+                uint8_t* to = dst + (dst_row * width + (overlap.x - x)) * psize;
+                const uint8_t* from = scratch.data() + row * row_bytes;
+                if (!meta_.nodata) {
+                    std::memcpy(to, from, row_bytes);
+                    continue;
+                }
+                dispatch_dtype(meta_.dtype_id, [&](auto tag) {
+                    using T = decltype(tag);
+                    merge_row(reinterpret_cast<T*>(to), reinterpret_cast<const T*>(from),
+                              static_cast<size_t>(overlap.width), meta_.nodata);
+                });
+            }
+        }
+    }
+}
+
+} // namespace geoslice
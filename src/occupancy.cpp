@@ -0,0 +1,166 @@
+#include "geoslice/occupancy.hpp"
+#include "geoslice/mmap_reader.hpp"
+#include "geoslice/simd.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace geoslice {
+
+namespace {
+constexpr char OCC_MAGIC[4] = {'G', 'S', 'O', 'C'};
+
+int tiles_for(int pixels, int tile_size) {
+    return (pixels + tile_size - 1) / tile_size;
+}
+
+template<typename T>
+GEOSLICE_MULTIVERSION
+void mark_valid(const T* row, int width, bool has_nodata, T nd, uint8_t* valid) {
+    for (int x = 0; x < width; x++) {
+        valid[x] |= (!has_nodata || row[x] != nd) && !is_nan(row[x]);
+    }
+}
+}
+
+OccupancyIndex::OccupancyIndex(int width, int height, int tile_size, std::vector<Coverage> tiles)
+    : width_(width)
+    , height_(height)
+    , tile_size_(tile_size)
+    , tiles_x_(tile_size > 0 ? tiles_for(width, tile_size) : 0)
+    , tiles_y_(tile_size > 0 ? tiles_for(height, tile_size) : 0)
+    , tiles_(std::move(tiles)) {
+    if (tile_size <= 0 || tiles_.size() != static_cast<size_t>(tiles_x_) * tiles_y_) {
+        throw std::invalid_argument("Occupancy index does not match raster dimensions");
+    }
+}
+
+OccupancyIndex OccupancyIndex::load(const std::string& path, int width, int height) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Cannot open " + path);
+
+    char magic[4];
+    uint32_t header[3];  // tile_size, tiles_x, tiles_y
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || std::memcmp(magic, OCC_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not an occupancy index: " + path);
+    }
+
+    const int tile_size = static_cast<int>(header[0]);
+    if (tile_size <= 0 || header[1] != static_cast<uint32_t>(tiles_for(width, tile_size)) ||
+        header[2] != static_cast<uint32_t>(tiles_for(height, tile_size))) {
+        throw std::runtime_error("Occupancy index does not match raster: " + path);
+    }
+
+    std::vector<Coverage> tiles(static_cast<size_t>(header[1]) * header[2]);
+    file.read(reinterpret_cast<char*>(tiles.data()), tiles.size());
+    if (!file) throw std::runtime_error("Truncated occupancy index: " + path);
+    for (Coverage c : tiles) {
+        if (c != Coverage::Empty && c != Coverage::Full && c != Coverage::Partial) {
+            throw std::runtime_error("Corrupt occupancy index: " + path);
+        }
+    }
+    return OccupancyIndex(width, height, tile_size, std::move(tiles));
+}
+
+OccupancyIndex OccupancyIndex::build(const MMapReader& reader, int tile_size) {
+    if (tile_size <= 0) throw std::invalid_argument("Tile size must be positive");
+
+    const int width = reader.width();
+    const int height = reader.height();
+    const int tiles_x = tiles_for(width, tile_size);
+    const int tiles_y = tiles_for(height, tile_size);
+    std::vector<Coverage> tiles(static_cast<size_t>(tiles_x) * tiles_y);
+
+    std::vector<uint8_t> valid(width);
+    std::vector<size_t> valid_counts(tiles_x);
+    for (int ty = 0; ty < tiles_y; ty++) {
+        const int y0 = ty * tile_size;
+        const int y1 = std::min(y0 + tile_size, height);
+        std::fill(valid_counts.begin(), valid_counts.end(), 0);
+
+        for (int y = y0; y < y1; y++) {
+            pixel_validity(reader, y, valid.data());
+            for (int tx = 0; tx < tiles_x; tx++) {
+                const int x0 = tx * tile_size;
+                const int x1 = std::min(x0 + tile_size, width);
+                size_t n = 0;
+                for (int x = x0; x < x1; x++) n += valid[x];
+                valid_counts[tx] += n;
+            }
+        }
+
+        for (int tx = 0; tx < tiles_x; tx++) {
+            const size_t pixels = static_cast<size_t>(std::min(tile_size, width - tx * tile_size)) * (y1 - y0);
+            tiles[ty * tiles_x + tx] = valid_counts[tx] == 0 ? Coverage::Empty
+                                     : valid_counts[tx] == pixels ? Coverage::Full
+                                     : Coverage::Partial;
+        }
+    }
+    return OccupancyIndex(width, height, tile_size, std::move(tiles));
+}
+
+void OccupancyIndex::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Cannot write " + path);
+
+    const uint32_t header[3] = {
+        static_cast<uint32_t>(tile_size_),
+        static_cast<uint32_t>(tiles_x_),
+        static_cast<uint32_t>(tiles_y_)
+    };
+    file.write(OCC_MAGIC, sizeof(OCC_MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(tiles_.data()), tiles_.size());
+}
+
+size_t OccupancyIndex::empty_tiles() const {
+    return static_cast<size_t>(std::count(tiles_.begin(), tiles_.end(), Coverage::Empty));
+}
+
+Coverage OccupancyIndex::coverage(int x, int y, int width, int height) const {
+    bool any_valid = false;
+    bool any_invalid = false;
+
+    for (int ty = y / tile_size_; ty <= (y + height - 1) / tile_size_; ty++) {
+        for (int tx = x / tile_size_; tx <= (x + width - 1) / tile_size_; tx++) {
+            const Coverage c = tile(tx, ty);
+            if (c == Coverage::Partial) return Coverage::Partial;
+            any_valid |= c == Coverage::Full;
+            any_invalid |= c == Coverage::Empty;
+            if (any_valid && any_invalid) return Coverage::Partial;
+        }
+    }
+    return any_valid ? Coverage::Full : Coverage::Empty;
+}
+
+void pixel_validity(const MMapReader& reader, int y, uint8_t* valid) {
+    const int width = reader.width();
+    std::fill(valid, valid + width, 0);
+
+    // Chunked readers have no zero-copy views: go through a row copy
+    std::vector<uint8_t> copy;
+    WindowView view;
+    if (reader.chunked()) {
+        const auto& meta = reader.metadata();
+        const size_t row_bytes = static_cast<size_t>(width) * meta.pixel_size();
+        copy.resize(row_bytes * meta.count);
+        reader.read_window(0, y, width, 1, copy.data());
+        view = WindowView{copy.data(), meta.count, 1, width, row_bytes, row_bytes, meta.pixel_size(), meta.dtype_id};
+    } else {
+        view = reader.get_window(0, y, width, 1);
+    }
+
+    visit_window(view, [&](auto typed) {
+        using T = typename decltype(typed)::value_type;
+        T nd{};
+        const bool has_nodata = nodata_as(reader.metadata().nodata, nd);
+
+        for (int b = 0; b < typed.bands; b++) mark_valid(typed.row(b, 0), width, has_nodata, nd, valid);
+    });
+}
+
+} // namespace geoslice
@@ -0,0 +1,79 @@
+#include "geoslice/raster_header.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace geoslice {
+
+namespace {
+// count * height * width * pixel size, or false if it overflows size_t
+bool data_bytes(const RasterHeader& h, size_t& bytes) {
+    bytes = dtype_size(static_cast<DType>(h.dtype));
+    return !__builtin_mul_overflow(bytes, h.count, &bytes) && !__builtin_mul_overflow(bytes, h.height, &bytes) &&
+           !__builtin_mul_overflow(bytes, h.width, &bytes);
+}
+}
+
+RasterHeader make_header(const GeoMetadata& meta) {
+    RasterHeader h{};
+    if (meta.crs.size() >= sizeof(h.crs)) {
+        throw std::invalid_argument("CRS too long for the raster header: " + meta.crs);
+    }
+
+    std::memcpy(h.magic, HEADER_MAGIC, sizeof(h.magic));
+    h.version = HEADER_VERSION;
+    h.dtype = static_cast<uint8_t>(meta.dtype_id);
+    h.interleave = static_cast<uint8_t>(Interleave::BSQ);
+    h.count = static_cast<uint32_t>(meta.count);
+    h.height = static_cast<uint32_t>(meta.height);
+    h.width = static_cast<uint32_t>(meta.width);
+    h.flags = meta.nodata ? HEADER_HAS_NODATA : 0;
+    h.data_offset = HEADER_DATA_OFFSET;
+    for (size_t i = 0; i < meta.transform.size(); i++) h.transform[i] = meta.transform[i];
+    h.nodata = meta.nodata.value_or(0.0);
+    std::memcpy(h.crs, meta.crs.data(), meta.crs.size());
+    return h;
+}
+
+bool parse_header(const void* data, size_t size, GeoMetadata& meta, size_t& data_offset, Interleave layout) {
+    if (size < sizeof(RasterHeader)) return false;
+    RasterHeader h;
+    std::memcpy(&h, data, sizeof(h));
+    if (std::memcmp(h.magic, HEADER_MAGIC, sizeof(h.magic)) != 0) return false;
+
+    if (h.version != HEADER_VERSION) {
+        throw std::runtime_error("Unsupported raster header version " + std::to_string(h.version));
+    }
+    if (h.interleave != static_cast<uint8_t>(layout)) {
+        throw std::runtime_error(h.interleave == static_cast<uint8_t>(Interleave::Tiled)
+                                     ? "Raster is tiled and compressed; open it with TiledReader"
+                                     : "Raster header has an unexpected layout");
+    }
+    // Dimensions become ints in GeoMetadata
+    constexpr uint32_t max_dim = std::numeric_limits<int>::max();
+    size_t bytes = 0;
+    if (h.dtype > static_cast<uint8_t>(DType::Float64) || h.count == 0 || h.height == 0 || h.width == 0 ||
+        h.count > max_dim || h.height > max_dim || h.width > max_dim || !data_bytes(h, bytes) ||
+        h.data_offset < sizeof(RasterHeader) || h.data_offset > size) {
+        throw std::runtime_error("Corrupt raster header");
+    }
+
+    meta.dtype_id = static_cast<DType>(h.dtype);
+    meta.count = static_cast<int>(h.count);
+    meta.height = static_cast<int>(h.height);
+    meta.width = static_cast<int>(h.width);
+    for (size_t i = 0; i < meta.transform.size(); i++) meta.transform[i] = h.transform[i];
+    meta.crs.assign(h.crs, strnlen(h.crs, sizeof(h.crs)));
+    meta.nodata.reset();
+    if (h.flags & HEADER_HAS_NODATA) meta.nodata = h.nodata;
+
+    // Tiled data is compressed; its tile directory is checked by the reader
+    if (layout == Interleave::BSQ && bytes > size - h.data_offset) {
+        throw std::runtime_error("Raster data shorter than its header describes");
+    }
+    data_offset = h.data_offset;
+    return true;
+}
+
+} // namespace geoslice
@@ -0,0 +1,97 @@
+#include "geoslice/reader_pool.hpp"
+#include "geoslice/metrics.hpp"
+
+#include <stdexcept>
+
+namespace geoslice {
+
+ReaderPool::ReaderPool(size_t max_readers, size_t max_mapped_bytes, const ReaderOptions& reader_options)
+    : max_readers_(max_readers)
+    , max_mapped_bytes_(max_mapped_bytes)
+    , reader_options_(reader_options) {
+    if (max_readers == 0) throw std::invalid_argument("ReaderPool needs room for at least one reader");
+}
+
+std::shared_ptr<const MMapReader> ReaderPool::acquire(const std::string& base_path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = readers_.find(base_path);
+        if (it != readers_.end()) {
+            hits_++;
+            GEOSLICE_COUNT(PoolHits, 1);
+            lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+            return it->second->second;
+        }
+        misses_++;
+        GEOSLICE_COUNT(PoolMisses, 1);
+    }
+
+    // Map outside the lock so opens of different files run in parallel
+    auto reader = std::make_shared<const MMapReader>(base_path, reader_options_);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = readers_.find(base_path);
+    if (it != readers_.end()) {
+        // Another thread opened it meanwhile: keep theirs
+        lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+        return it->second->second;
+    }
+
+    evict_if_needed(reader->mapped_bytes());
+    lru_list_.emplace_front(base_path, reader);
+    readers_[base_path] = lru_list_.begin();
+    current_bytes_ += reader->mapped_bytes();
+    return reader;
+}
+
+void ReaderPool::evict_if_needed(size_t needed_bytes) {
+    while (!lru_list_.empty() &&
+           (lru_list_.size() >= max_readers_ ||
+            (max_mapped_bytes_ && current_bytes_ + needed_bytes > max_mapped_bytes_))) {
+        auto& back = lru_list_.back();
+        current_bytes_ -= back.second->mapped_bytes();
+        readers_.erase(back.first);
+        lru_list_.pop_back();
+        evictions_++;
+        GEOSLICE_COUNT(PoolEvictions, 1);
+    }
+}
+
+bool ReaderPool::contains(const std::string& base_path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return readers_.count(base_path) != 0;
+}
+
+void ReaderPool::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    readers_.clear();
+    lru_list_.clear();
+    current_bytes_ = 0;
+}
+
+size_t ReaderPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_list_.size();
+}
+
+size_t ReaderPool::mapped_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_bytes_;
+}
+
+size_t ReaderPool::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t ReaderPool::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t ReaderPool::evictions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+} // namespace geoslice
@@ -0,0 +1,229 @@
+#include "geoslice/thread_pool.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+
+namespace geoslice {
+
+struct ThreadPool::State {
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;  // owner takes the front, thieves the back
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex injected_mutex;
+    std::deque<std::function<void()>> injected;  // submitted from outside the pool
+
+    // Tasks pushed and not yet taken. Counted without a lock; mutex and wake
+    // only put idle workers to sleep and wake them. A worker announces
+    // itself in sleeping before it checks pending, and a submitter checks
+    // sleeping after it counts its task, so one of them always sees the
+    // other (both sequentially consistent) and no wakeup is lost.
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> sleeping{0};
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stop = false;  // guarded by mutex
+
+    bool pop_local(size_t self, std::function<void()>& task) {
+        Worker& w = *workers[self];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.tasks.empty()) return false;
+        task = std::move(w.tasks.front());
+        w.tasks.pop_front();
+        return true;
+    }
+
+    bool pop_injected(std::function<void()>& task) {
+        std::lock_guard<std::mutex> lock(injected_mutex);
+        if (injected.empty()) return false;
+        task = std::move(injected.front());
+        injected.pop_front();
+        return true;
+    }
+
+    bool steal(size_t self, std::function<void()>& task) {
+        for (size_t k = 1; k < workers.size(); k++) {
+            Worker& victim = *workers[(self + k) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    void run(size_t self);
+};
+
+namespace {
+// The pool and slot of the calling thread, if it is a pool worker
+thread_local const void* current_pool = nullptr;
+thread_local size_t current_slot = 0;
+
+std::mutex default_mutex;
+std::shared_ptr<Executor> default_pool;
+std::shared_ptr<Executor> io_pool;
+
+void replace(std::shared_ptr<Executor>& slot, std::shared_ptr<Executor> executor) {
+    std::shared_ptr<Executor> old;
+    {
+        std::lock_guard<std::mutex> lock(default_mutex);
+        old = std::move(slot);
+        slot = std::move(executor);
+    }
+    // old is released here, outside the lock: a pool joins its workers
+}
+}
+
+void ThreadPool::State::run(size_t self) {
+    current_pool = this;
+    current_slot = self;
+    for (;;) {
+        std::function<void()> task;
+        if (pop_local(self, task) || pop_injected(task) || steal(self, task)) {
+            pending.fetch_sub(1);
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stop && pending.load() == 0) return;
+        // A task counted in pending but not yet taken is being pushed or was
+        // just taken by another worker: look again
+        sleeping.fetch_add(1);
+        wake.wait(lock, [&] { return stop || pending.load() > 0; });
+        sleeping.fetch_sub(1);
+    }
+}
+
+ThreadPool::ThreadPool(const ThreadPoolOptions& options)
+    : state_(std::make_shared<State>()) {
+    const unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 0; t < threads; t++) state_->workers.push_back(std::make_unique<State::Worker>());
+    for (unsigned t = 0; t < threads; t++) {
+        threads_.emplace_back([state = state_, t] { state->run(t); });
+        if (!options.cpus.empty()) pin_thread(threads_.back(), options.cpus);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stop = true;
+    }
+    state_->wake.notify_all();
+    for (auto& t : threads_) {
+        // The last reference may be dropped by a task on one of our workers
+        if (t.get_id() == std::this_thread::get_id()) {
+            t.detach();
+        } else {
+            t.join();
+        }
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    State& s = *state_;
+    const bool local = current_pool == &s;
+    // Counted before it is visible, so a thief never takes pending below zero
+    s.pending.fetch_add(1);
+    if (local) {
+        State::Worker& w = *s.workers[current_slot];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.tasks.push_front(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(s.injected_mutex);
+        s.injected.push_back(std::move(task));
+    }
+    if (s.sleeping.load() > 0) {
+        // Taking the mutex orders the notify after a sleeper's wait began
+        { std::lock_guard<std::mutex> lock(s.mutex); }
+        s.wake.notify_one();
+    }
+}
+
+size_t ThreadPool::concurrency() const {
+    return state_->workers.size();
+}
+
+std::shared_ptr<Executor> default_executor() {
+    std::lock_guard<std::mutex> lock(default_mutex);
+    if (!default_pool) default_pool = std::make_shared<ThreadPool>();
+    return default_pool;
+}
+
+void set_default_executor(std::shared_ptr<Executor> executor) {
+    replace(default_pool, std::move(executor));
+}
+
+std::shared_ptr<Executor> io_executor() {
+    std::lock_guard<std::mutex> lock(default_mutex);
+    if (!io_pool) io_pool = std::make_shared<ThreadPool>(ThreadPoolOptions{IO_THREADS, {}});
+    return io_pool;
+}
+
+void set_io_executor(std::shared_ptr<Executor> executor) {
+    replace(io_pool, std::move(executor));
+}
+
+void configure_thread_pool(const ThreadPoolOptions& options) {
+    set_default_executor(std::make_shared<ThreadPool>(options));
+}
+
+void pin_thread(std::thread& thread, const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+}
+
+namespace detail {
+void ParallelJob::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (next < count) {
+        const size_t i = next++;
+        running++;
+        lock.unlock();
+        std::exception_ptr failed;
+        try {
+            fn(i);
+        } catch (...) {
+            failed = std::current_exception();
+        }
+        lock.lock();
+        running--;
+        if (failed) {
+            if (!error) error = failed;
+            next = count;
+        }
+    }
+    if (running == 0) done.notify_all();
+}
+
+void ParallelJob::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return next >= count && running == 0; });
+}
+
+void run_parallel(Executor& executor, size_t helpers, size_t n, std::function<void(size_t)> fn) {
+    auto job = std::make_shared<ParallelJob>();
+    job->count = n;
+    job->fn = std::move(fn);
+    helpers = std::min({helpers, executor.concurrency(), n - 1});
+    for (size_t h = 0; h < helpers; h++) executor.submit([job] { job->work(); });
+
+    job->work();
+    job->wait();
+    if (job->error) std::rethrow_exception(job->error);
+}
+}
+
+} // namespace geoslice
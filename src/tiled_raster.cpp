@@ -0,0 +1,359 @@
+#include "geoslice/tiled_raster.hpp"
+#include "geoslice/metrics.hpp"
+#include "geoslice/trace.hpp"
+#include "geoslice/parallel.hpp"
+#include "geoslice/raster_header.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace geoslice {
+
+namespace {
+void write_all(int fd, const void* data, size_t size, uint64_t offset) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const ssize_t n = pwrite(fd, p, size, static_cast<off_t>(offset));
+        if (n <= 0) throw std::runtime_error("Write failed");
+        p += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+}
+
+int tile_count(int size, int tile) {
+    return (size - 1) / tile + 1;
+}
+}
+
+GeoMetadata write_tiled_raster(const std::string& base_path, const std::string& output_base,
+                               const TiledOptions& options) {
+    if (options.tile_size <= 0) throw std::invalid_argument("Tile size must be positive");
+    if (!codec_available(options.codec)) {
+        throw std::invalid_argument(std::string("Codec not available in this build: ") + codec_name(options.codec));
+    }
+    const std::string path = output_base + ".gsz";
+    if (!options.overwrite && access(path.c_str(), F_OK) == 0) {
+        throw std::runtime_error("Output file already exists: " + path);
+    }
+
+    const MMapReader source(base_path);
+    const GeoMetadata& meta = source.metadata();
+    // One tile never needs to be larger than the raster
+    const int ts = std::min(options.tile_size, std::max(meta.width, meta.height));
+    const int tiles_x = tile_count(meta.width, ts);
+    const int tiles_y = tile_count(meta.height, ts);
+    const size_t tiles = static_cast<size_t>(tiles_x) * tiles_y;
+
+    RasterHeader header = make_header(meta);
+    header.interleave = static_cast<uint8_t>(Interleave::Tiled);
+    header.data_offset = sizeof(RasterHeader);
+    TileDirectory dir{};
+    dir.tile_size = static_cast<uint32_t>(ts);
+    dir.codec = static_cast<uint8_t>(options.codec);
+    dir.filter = static_cast<uint8_t>(options.filter);
+    dir.tiles_x = static_cast<uint32_t>(tiles_x);
+    dir.tiles_y = static_cast<uint32_t>(tiles_y);
+
+    const uint64_t table_offset = sizeof(RasterHeader) + sizeof(TileDirectory);
+    std::vector<uint64_t> offsets(tiles + 1);
+    uint64_t pos = table_offset + offsets.size() * sizeof(uint64_t);
+
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("Cannot write " + path);
+    try {
+        // One row of tiles at a time: compressed in parallel, appended in order
+        const size_t psize = meta.pixel_size();
+        std::vector<std::vector<uint8_t>> blocks(tiles_x);
+        const unsigned workers = resolve_threads(options.threads, tiles_x);
+        std::vector<std::vector<uint8_t>> raws(workers), filtereds(workers);
+        for (int ty = 0; ty < tiles_y; ty++) {
+            parallel_for_workers(tiles_x, options.threads, [&](size_t worker, size_t tx) {
+                std::vector<uint8_t>& raw = raws[worker];
+                std::vector<uint8_t>& filtered = filtereds[worker];
+                const int x = static_cast<int>(tx) * ts;
+                const int y = ty * ts;
+                const int w = std::min(ts, meta.width - x);
+                const int h = std::min(ts, meta.height - y);
+                raw.resize(static_cast<size_t>(meta.count) * w * h * psize);
+                source.read_window(x, y, w, h, raw.data());
+                const uint8_t* input = raw.data();
+                if (options.filter != TileFilter::None) {
+                    filtered.resize(raw.size());
+                    apply_filter(options.filter, raw.data(), filtered.data(), static_cast<size_t>(meta.count) * h, w,
+                                 psize);
+                    input = filtered.data();
+                }
+                if (!compress_block(options.codec, input, raw.size(), blocks[tx])) {
+                    blocks[tx].assign(raw.begin(), raw.end());  // stored, unfiltered
+                }
+            });
+            for (int tx = 0; tx < tiles_x; tx++) {
+                offsets[static_cast<size_t>(ty) * tiles_x + tx] = pos;
+                write_all(fd, blocks[tx].data(), blocks[tx].size(), pos);
+                pos += blocks[tx].size();
+            }
+        }
+        offsets[tiles] = pos;
+
+        write_all(fd, &header, sizeof(header), 0);
+        write_all(fd, &dir, sizeof(dir), sizeof(header));
+        write_all(fd, offsets.data(), offsets.size() * sizeof(uint64_t), table_offset);
+    } catch (...) {
+        close(fd);
+        std::remove(path.c_str());
+        throw;
+    }
+    close(fd);
+    return meta;
+}
+
+TiledReader::TiledReader(const std::string& base_path, const TiledReaderOptions& options)
+    : threads_(options.threads)
+    , cache_capacity_(options.cache_bytes) {
+    const std::string path = base_path + ".gsz";
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path);
+
+    struct stat st;
+    fstat(fd, &st);
+    mapped_size_ = static_cast<size_t>(st.st_size);
+    mapped_data_ = mmap(nullptr, mapped_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped_data_ == MAP_FAILED) {
+        mapped_data_ = nullptr;
+        throw std::runtime_error("mmap failed: " + path);
+    }
+
+    try {
+        const uint8_t* base = static_cast<const uint8_t*>(mapped_data_);
+        size_t dir_offset = 0;
+        if (!parse_header(base, mapped_size_, meta_, dir_offset, Interleave::Tiled)) {
+            throw std::runtime_error("Not a tiled raster: " + path);
+        }
+        if (mapped_size_ - dir_offset < sizeof(TileDirectory)) throw std::runtime_error("Corrupt tile directory");
+        std::memcpy(&dir_, base + dir_offset, sizeof(dir_));
+
+        const auto codec = static_cast<TileCodec>(dir_.codec);
+        if (dir_.codec > static_cast<uint8_t>(TileCodec::Deflate) ||
+            dir_.filter > static_cast<uint8_t>(TileFilter::FloatShuffle) || dir_.tile_size == 0 ||
+            dir_.tile_size > static_cast<uint32_t>(std::max(meta_.width, meta_.height)) ||
+            dir_.tiles_x != static_cast<uint32_t>(tile_count(meta_.width, tile_size())) ||
+            dir_.tiles_y != static_cast<uint32_t>(tile_count(meta_.height, tile_size()))) {
+            throw std::runtime_error("Corrupt tile directory");
+        }
+        if (!codec_available(codec)) {
+            throw std::runtime_error(std::string("Raster needs a codec not in this build: ") + codec_name(codec));
+        }
+
+        const size_t table = dir_offset + sizeof(TileDirectory);
+        const size_t entries = num_tiles() + 1;
+        if (table % alignof(uint64_t) != 0 || (mapped_size_ - table) / sizeof(uint64_t) < entries) {
+            throw std::runtime_error("Corrupt tile offset table");
+        }
+        offsets_ = reinterpret_cast<const uint64_t*>(base + table);
+        if (offsets_[0] < table + entries * sizeof(uint64_t) || offsets_[entries - 1] > mapped_size_) {
+            throw std::runtime_error("Corrupt tile offset table");
+        }
+        for (size_t i = 1; i < entries; i++) {
+            if (offsets_[i] < offsets_[i - 1]) throw std::runtime_error("Corrupt tile offset table");
+        }
+    } catch (...) {
+        munmap(mapped_data_, mapped_size_);
+        throw;
+    }
+    madvise(mapped_data_, mapped_size_, MADV_RANDOM);
+}
+
+TiledReader::~TiledReader() {
+    if (mapped_data_) munmap(mapped_data_, mapped_size_);
+}
+
+bool TiledReader::is_valid_window(int x, int y, int width, int height) const {
+    return x >= 0 && y >= 0 &&
+           x + width <= meta_.width &&
+           y + height <= meta_.height &&
+           width > 0 && height > 0;
+}
+
+WindowRect TiledReader::tile_rect(size_t tile) const {
+    const int ts = tile_size();
+    const int x = static_cast<int>(tile % dir_.tiles_x) * ts;
+    const int y = static_cast<int>(tile / dir_.tiles_x) * ts;
+    return {x, y, std::min(ts, meta_.width - x), std::min(ts, meta_.height - y)};
+}
+
+std::vector<uint8_t> TiledReader::decode_tile(size_t tile) const {
+    GEOSLICE_TIME(TileDecode);
+    GEOSLICE_TRACE_SCOPE("tile_decode");
+    const WindowRect rect = tile_rect(tile);
+    std::vector<uint8_t> out(static_cast<size_t>(meta_.count) * rect.width * rect.height * meta_.pixel_size());
+    const uint8_t* src = static_cast<const uint8_t*>(mapped_data_) + offsets_[tile];
+    const size_t size = offsets_[tile + 1] - offsets_[tile];
+    if (size == out.size()) {
+        std::memcpy(out.data(), src, size);  // stored
+    } else {
+        decompress_block(codec(), src, size, out.data(), out.size());
+        undo_filter(filter(), out.data(), static_cast<size_t>(meta_.count) * rect.height, rect.width,
+                    meta_.pixel_size());
+    }
+    return out;
+}
+
+void TiledReader::tiles_in(const WindowRect& window, std::vector<size_t>& tiles) const {
+    const int ts = tile_size();
+    for (int ty = window.y / ts; ty <= (window.y + window.height - 1) / ts; ty++) {
+        for (int tx = window.x / ts; tx <= (window.x + window.width - 1) / ts; tx++) {
+            tiles.push_back(static_cast<size_t>(ty) * dir_.tiles_x + tx);
+        }
+    }
+}
+
+std::vector<TiledReader::Tile> TiledReader::load_tiles(const std::vector<size_t>& tiles) const {
+    std::vector<Tile> result(tiles.size());
+    std::vector<size_t> missing;
+    {
+        GEOSLICE_TRACED_LOCK(lock, mutex_, "tile_cache.lock");
+        for (size_t k = 0; k < tiles.size(); k++) {
+            auto it = cache_map_.find(tiles[k]);
+            if (it == cache_map_.end()) {
+                missing.push_back(k);
+                continue;
+            }
+            lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+            result[k] = it->second->second;
+        }
+        hits_ += tiles.size() - missing.size();
+        misses_ += missing.size();
+        GEOSLICE_COUNT(TileCacheHits, tiles.size() - missing.size());
+        GEOSLICE_COUNT(TileCacheMisses, missing.size());
+    }
+    if (missing.empty()) return result;
+
+    // Decode outside the lock; another thread may decode the same tile
+    // meanwhile, and then the first one cached wins
+    parallel_for(missing.size(), threads_, [&](size_t j) {
+        result[missing[j]] = std::make_shared<const std::vector<uint8_t>>(decode_tile(tiles[missing[j]]));
+    });
+
+    GEOSLICE_TRACED_LOCK(lock, mutex_, "tile_cache.lock");
+    for (size_t k : missing) {
+        const size_t bytes = result[k]->size();
+        if (cache_map_.count(tiles[k]) || bytes > cache_capacity_) continue;
+        while (cache_bytes_ + bytes > cache_capacity_ && !lru_list_.empty()) {
+            cache_bytes_ -= lru_list_.back().second->size();
+            cache_map_.erase(lru_list_.back().first);
+            lru_list_.pop_back();
+            GEOSLICE_COUNT(TileCacheEvictions, 1);
+        }
+        lru_list_.emplace_front(tiles[k], result[k]);
+        cache_map_[tiles[k]] = lru_list_.begin();
+        cache_bytes_ += bytes;
+    }
+    return result;
+}
+
+void TiledReader::copy_from_tiles(const WindowRect& window, const std::vector<size_t>& tiles,
+                                  const std::vector<Tile>& decoded, void* out) const {
+    const size_t psize = meta_.pixel_size();
+    uint8_t* dst = static_cast<uint8_t*>(out);
+    GEOSLICE_COUNT(WindowCopies, 1);
+    GEOSLICE_COUNT(BytesCopied, static_cast<uint64_t>(meta_.count) * window.width * window.height * psize);
+    for (size_t k = 0; k < tiles.size(); k++) {
+        const WindowRect t = tile_rect(tiles[k]);
+        const int x0 = std::max(window.x, t.x);
+        const int y0 = std::max(window.y, t.y);
+        const int x1 = std::min(window.x + window.width, t.x + t.width);
+        const int y1 = std::min(window.y + window.height, t.y + t.height);
+        if (x0 >= x1 || y0 >= y1) continue;
+
+        const size_t row_bytes = static_cast<size_t>(x1 - x0) * psize;
+        const uint8_t* src = decoded[k]->data();
+        for (int b = 0; b < meta_.count; b++) {
+            for (int y = y0; y < y1; y++) {
+                const size_t src_row = static_cast<size_t>(b) * t.height + (y - t.y);
+                const size_t dst_row = static_cast<size_t>(b) * window.height + (y - window.y);
+                std::memcpy(dst + (dst_row * window.width + (x0 - window.x)) * psize,
+                            src + (src_row * t.width + (x0 - t.x)) * psize, row_bytes);
+            }
+        }
+    }
+}
+
+void TiledReader::read_window(int x, int y, int width, int height, void* out) const {
+    GEOSLICE_TIME(TiledRead);
+    GEOSLICE_TRACE_SCOPE("tiled_read");
+    if (!is_valid_window(x, y, width, height)) {
+        throw std::out_of_range("Window out of bounds");
+    }
+    const WindowRect window{x, y, width, height};
+    std::vector<size_t> tiles;
+    tiles_in(window, tiles);
+    copy_from_tiles(window, tiles, load_tiles(tiles), out);
+}
+
+void TiledReader::read_windows(const std::vector<WindowRect>& windows, const std::vector<void*>& outs) const {
+    GEOSLICE_TIME(TiledRead);
+    GEOSLICE_TRACE_SCOPE("tiled_read");
+    if (windows.size() != outs.size()) {
+        throw std::invalid_argument("read_windows needs one output per window");
+    }
+    std::vector<size_t> tiles;
+    for (const auto& w : windows) {
+        if (!is_valid_window(w.x, w.y, w.width, w.height)) {
+            throw std::out_of_range("Window out of bounds");
+        }
+        tiles_in(w, tiles);
+    }
+    std::sort(tiles.begin(), tiles.end());
+    tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+    const auto decoded = load_tiles(tiles);
+
+    std::vector<size_t> window_tiles;
+    std::vector<Tile> window_decoded;
+    for (size_t i = 0; i < windows.size(); i++) {
+        window_tiles.clear();
+        window_decoded.clear();
+        tiles_in(windows[i], window_tiles);
+        for (size_t t : window_tiles) {
+            window_decoded.push_back(decoded[std::lower_bound(tiles.begin(), tiles.end(), t) - tiles.begin()]);
+        }
+        copy_from_tiles(windows[i], window_tiles, window_decoded, outs[i]);
+    }
+}
+
+size_t TiledReader::cached_tiles() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_list_.size();
+}
+
+size_t TiledReader::cached_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_bytes_;
+}
+
+size_t TiledReader::cache_hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t TiledReader::cache_misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+void TiledReader::clear_cache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_list_.clear();
+    cache_map_.clear();
+    cache_bytes_ = 0;
+}
+
+} // namespace geoslice
@@ -0,0 +1,143 @@
+#include "geoslice/trace.hpp"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+namespace geoslice {
+
+namespace {
+// Written by its thread only; head is published with release so the dump
+// sees complete events
+struct TraceRing {
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> head{0};
+    long tid = 0;
+    uint64_t generation = 0;
+};
+
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceRing>> rings;  // outlive their threads
+    std::atomic<uint64_t> generation{0};
+    size_t capacity = 1 << 16;
+    std::atomic<int64_t> origin_ns{0};  // steady clock at start_tracing()
+    std::unordered_set<std::string> names;
+};
+
+TraceRegistry& registry() {
+    static TraceRegistry r;
+    return r;
+}
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The calling thread's ring for the current tracing session
+TraceRing& thread_ring() {
+    thread_local std::shared_ptr<TraceRing> ring;
+    TraceRegistry& r = registry();
+    const uint64_t generation = r.generation.load(std::memory_order_acquire);
+    if (!ring || ring->generation != generation) {
+        auto fresh = std::make_shared<TraceRing>();
+        fresh->tid = static_cast<long>(syscall(SYS_gettid));
+        fresh->generation = generation;
+        std::lock_guard<std::mutex> lock(r.mutex);
+        fresh->events.resize(r.capacity);
+        r.rings.push_back(fresh);
+        ring = std::move(fresh);
+    }
+    return *ring;
+}
+
+void write_escaped(std::ofstream& out, const char* s) {
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') out << '\\';
+        if (static_cast<unsigned char>(*s) >= 0x20) out << *s;
+    }
+}
+}
+
+namespace detail {
+uint64_t trace_now_ns() {
+    return static_cast<uint64_t>(steady_ns() - registry().origin_ns.load(std::memory_order_relaxed));
+}
+
+void record_trace(const char* name, uint64_t start_ns, uint64_t duration_ns) {
+    TraceRing& ring = thread_ring();
+    const uint64_t h = ring.head.load(std::memory_order_relaxed);
+    ring.events[h % ring.events.size()] = {name, start_ns, duration_ns};
+    ring.head.store(h + 1, std::memory_order_release);
+}
+}
+
+void start_tracing(size_t events_per_thread) {
+    if (events_per_thread == 0) throw std::invalid_argument("Trace rings need room for at least one event");
+    TraceRegistry& r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.rings.clear();
+        r.capacity = events_per_thread;
+        r.origin_ns.store(steady_ns(), std::memory_order_relaxed);
+        r.generation.fetch_add(1, std::memory_order_release);
+    }
+    detail::tracing_on.store(true, std::memory_order_relaxed);
+}
+
+void stop_tracing() {
+    detail::tracing_on.store(false, std::memory_order_relaxed);
+}
+
+bool trace_points_enabled() {
+#ifdef GEOSLICE_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t dump_trace(const std::string& path) {
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        rings = registry().rings;
+    }
+
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    const long pid = static_cast<long>(getpid());
+    size_t written = 0;
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    out.precision(3);
+    out << std::fixed;
+    for (const auto& ring : rings) {
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t n = std::min<uint64_t>(head, ring->events.size());
+        for (uint64_t i = head - n; i < head; i++) {
+            const TraceEvent& e = ring->events[i % ring->events.size()];
+            out << (written++ ? ",\n" : "") << "{\"name\": \"";
+            write_escaped(out, e.name);
+            out << "\", \"cat\": \"geoslice\", \"ph\": \"X\", \"pid\": " << pid << ", \"tid\": " << ring->tid
+                << ", \"ts\": " << e.start_ns / 1000.0 << ", \"dur\": " << e.duration_ns / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    return written;
+}
+
+const char* intern_trace_name(const std::string& name) {
+    TraceRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.names.insert(name).first->c_str();
+}
+
+} // namespace geoslice
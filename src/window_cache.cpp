@@ -1,4 +1,6 @@
 #include "geoslice/window_cache.hpp"
+#include "geoslice/metrics.hpp"
+#include "geoslice/trace.hpp"
 #include <cstring>
 
 namespace geoslice {
@@ -13,16 +15,19 @@ uint64_t WindowCache::make_key(int x, int y, int width, int height) const {
 }
 
 const uint8_t* WindowCache::get(int x, int y, int width, int height) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    GEOSLICE_TRACE_SCOPE("window_cache.get");
+    GEOSLICE_TRACED_LOCK(lock, mutex_, "window_cache.lock");
     uint64_t key = make_key(x, y, width, height);
 
     auto it = cache_map_.find(key);
     if (it == cache_map_.end()) {
         misses_++;
+        GEOSLICE_COUNT(WindowCacheMisses, 1);
         return nullptr;
     }
 
     hits_++;
+    GEOSLICE_COUNT(WindowCacheHits, 1);
     // Move to front (most recently used)
     lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
     return it->second->second.data.data();
@@ -34,11 +39,13 @@ void WindowCache::evict_if_needed(size_t needed) {
         current_bytes_ -= back.second.data.size();
         cache_map_.erase(back.first);
         lru_list_.pop_back();
+        GEOSLICE_COUNT(WindowCacheEvictions, 1);
     }
 }
 
 void WindowCache::put(int x, int y, int width, int height, const uint8_t* data, size_t size) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    GEOSLICE_TRACE_SCOPE("window_cache.put");
+    GEOSLICE_TRACED_LOCK(lock, mutex_, "window_cache.lock");
     uint64_t key = make_key(x, y, width, height);
 
     // Already cached?
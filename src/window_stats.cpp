@@ -0,0 +1,164 @@
+#include "geoslice/window_stats.hpp"
+
+#include "geoslice/parallel.hpp"
+#include "geoslice/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace geoslice {
+
+namespace {
+
+template<typename T>
+using SumOf = std::conditional_t<std::is_integral_v<T> && sizeof(T) <= 2, int64_t, double>;
+
+template<typename T>
+struct RowMoments {
+    SumOf<T> sum = 0;
+    SumOf<T> sum_sq = 0;
+    size_t n = 0;
+    T lo = std::numeric_limits<T>::max();
+    T hi = std::numeric_limits<T>::lowest();
+};
+
+// One row of one band, compiled per ISA level. The body is branch-free and
+// keeps LANES independent accumulators: that vectorizes the float sums and
+// min/max without reassociating them, so every clone rounds the same way.
+// The sums are of v - shift.
+template<typename T>
+GEOSLICE_MULTIVERSION
+RowMoments<T> row_moments(const T* row, int width, bool has_nodata, T nd, SumOf<T> shift) {
+    // 8/16-bit sums are exact in int64 and keep the row loop integer-only
+    using Sum = SumOf<T>;
+    constexpr int LANES = 4;
+
+    Sum sum[LANES] = {};
+    Sum sum_sq[LANES] = {};
+    size_t n[LANES] = {};
+    T lo[LANES], hi[LANES];
+    std::fill(lo, lo + LANES, std::numeric_limits<T>::max());
+    std::fill(hi, hi + LANES, std::numeric_limits<T>::lowest());
+    auto add = [&](int k, T v) {
+        const bool ok = (!has_nodata || v != nd) && !is_nan(v);
+        const Sum s = ok ? static_cast<Sum>(v) - shift : Sum(0);
+        n[k] += ok;
+        sum[k] += s;
+        sum_sq[k] += s * s;
+        lo[k] = (ok && v < lo[k]) ? v : lo[k];
+        hi[k] = (ok && v > hi[k]) ? v : hi[k];
+    };
+
+    int x = 0;
+    for (; x + LANES <= width; x += LANES) {
+        for (int k = 0; k < LANES; k++) add(k, row[x + k]);
+    }
+    for (; x < width; x++) add(0, row[x]);
+
+    RowMoments<T> m;
+    for (int k = 0; k < LANES; k++) {
+        m.n += n[k];
+        m.sum += sum[k];
+        m.sum_sq += sum_sq[k];
+        m.lo = std::min(m.lo, lo[k]);
+        m.hi = std::max(m.hi, hi[k]);
+    }
+    return m;
+}
+
+template<typename T>
+std::optional<T> first_valid(const T* row, int width, bool has_nodata, T nd) {
+    for (int x = 0; x < width; x++) {
+        if ((!has_nodata || row[x] != nd) && !is_nan(row[x])) return row[x];
+    }
+    return std::nullopt;
+}
+
+template<typename T>
+BandStats band_stats(const TypedWindowView<T>& view, int b, std::optional<double> nodata) {
+    T nd{};
+    const bool has_nodata = nodata_as(nodata, nd);
+
+    size_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    T lo = std::numeric_limits<T>::max();
+    T hi = std::numeric_limits<T>::lowest();
+
+    for (int y = 0; y < view.height; y++) {
+        const T* row = view.row(b, y);
+        // Floating-point sums are taken around the row's first valid value:
+        // around zero, a large common offset (elevations, ...) would cancel
+        // most of the variance out of sum_sq - sum^2 / n. Integer sums are
+        // exact.
+        SumOf<T> shift = 0;
+        if constexpr (std::is_floating_point_v<SumOf<T>>) {
+            const auto first = first_valid(row, view.width, has_nodata, nd);
+            if (!first) continue;
+            shift = static_cast<double>(*first);
+        }
+        const auto [sum, sum_sq, n, row_lo, row_hi] = row_moments(row, view.width, has_nodata, nd, shift);
+        if (n == 0) continue;
+
+        // Merge this row into the running moments (Chan et al.)
+        const double row_sum = static_cast<double>(sum);
+        const double row_mean = static_cast<double>(shift) + row_sum / n;
+        const double row_m2 = std::max(0.0, static_cast<double>(sum_sq) - row_sum * row_sum / n);
+        const double delta = row_mean - mean;
+        const size_t total = count + n;
+        mean += delta * n / total;
+        m2 += row_m2 + delta * delta * (static_cast<double>(count) * n / total);
+        count = total;
+        lo = std::min(lo, row_lo);
+        hi = std::max(hi, row_hi);
+    }
+
+    if (count == 0) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        return BandStats{nan, nan, nan, nan, 0};
+    }
+    return BandStats{
+        static_cast<double>(lo),
+        static_cast<double>(hi),
+        mean,
+        std::sqrt(m2 / count),
+        count
+    };
+}
+
+} // namespace
+
+std::vector<BandStats> window_stats(const WindowView& view, std::optional<double> nodata) {
+    return visit_window(view, [&](auto typed) {
+        std::vector<BandStats> stats;
+        stats.reserve(typed.bands);
+        for (int b = 0; b < typed.bands; b++) {
+            stats.push_back(band_stats(typed, b, nodata));
+        }
+        return stats;
+    });
+}
+
+std::vector<std::vector<BandStats>> window_stats_batch(
+    const MMapReader& reader,
+    const std::vector<WindowRect>& windows,
+    std::optional<double> nodata,
+    unsigned threads) {
+    for (const auto& w : windows) {
+        if (!reader.is_valid_window(w.x, w.y, w.width, w.height)) {
+            throw std::out_of_range("Window out of bounds");
+        }
+    }
+
+    std::vector<std::vector<BandStats>> results(windows.size());
+    parallel_for(windows.size(), threads, [&](size_t i) {
+        const auto& w = windows[i];
+        results[i] = window_stats(reader.get_window(w.x, w.y, w.width, w.height), nodata);
+    });
+    return results;
+}
+
+} // namespace geoslice
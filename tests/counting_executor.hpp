@@ -0,0 +1,26 @@
+#pragma once
+
+#include "geoslice/thread_pool.hpp"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs every task on a thread of its own and counts them
+class CountingExecutor : public geoslice::Executor {
+public:
+    void submit(std::function<void()> task) override {
+        submitted++;
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.emplace_back(std::move(task));
+    }
+    size_t concurrency() const override { return 2; }
+    ~CountingExecutor() override {
+        for (auto& t : threads) t.join();
+    }
+
+    std::atomic<int> submitted{0};
+    std::mutex mutex;
+    std::vector<std::thread> threads;
+};
@@ -1,6 +1,7 @@
 """Benchmark tests for geoslice vs rasterio."""
 
 import json
+import os
 import subprocess
 import tempfile
 from pathlib import Path
@@ -8,7 +9,7 @@ from pathlib import Path
 import numpy as np
 import pytest
 
-from geoslice import FastGeoMap, GeoTransform, FlightPath
+from geoslice import FastGeoMap, GeoTransform, FlightPath, convert_tif_to_raw
 
 # Check if rasterio is available
 try:
@@ -18,6 +19,18 @@ try:
 except ImportError:
     HAS_RASTERIO = False
 
+try:
+    from geoslice._geoslice_cpp import convert_tiff  # noqa: F401
+    HAS_NATIVE_CONVERTER = True
+except ImportError:
+    HAS_NATIVE_CONVERTER = False
+
+try:
+    from geoslice._geoslice_cpp import FileReader, MMapReader
+    HAS_FILE_READER = True
+except ImportError:
+    HAS_FILE_READER = False
+
 
 @pytest.fixture(scope="module")
 def test_data_pair():
@@ -218,6 +231,80 @@ class TestFlightPathBenchmarks:
         src.close()
 
 
+@pytest.mark.skipif(not HAS_RASTERIO, reason="rasterio not installed")
+class TestConverterBenchmarks:
+    """GeoTIFF -> raw conversion: native decoder vs gdal_translate."""
+
+    @pytest.mark.skipif(not HAS_NATIVE_CONVERTER, reason="C++ extension not built")
+    def test_convert_native(self, test_data_pair, tmp_path, benchmark):
+        out = str(tmp_path / "native")
+
+        def convert():
+            convert_tif_to_raw(test_data_pair["tif_path"], out, overwrite=True, backend="native")
+
+        benchmark(convert)
+        expected = np.fromfile(f"{test_data_pair['raw_base']}.bin", dtype=np.uint8)
+        assert np.array_equal(np.fromfile(f"{out}.bin", dtype=np.uint8), expected)
+
+    def test_convert_gdal(self, test_data_pair, tmp_path, benchmark):
+        if subprocess.call(["which", "gdal_translate"], stdout=subprocess.DEVNULL) != 0:
+            pytest.skip("gdal_translate not installed")
+        out = str(tmp_path / "gdal")
+
+        def convert():
+            convert_tif_to_raw(test_data_pair["tif_path"], out, overwrite=True, backend="gdal")
+
+        benchmark(convert)
+
+
+def drop_file_cache(path):
+    """Evict a file's pages from the page cache (no root needed, unlike
+    /proc/sys/vm/drop_caches). Pages still mapped by a live mmap stay, so
+    readers must be opened after this."""
+    fd = os.open(path, os.O_RDONLY)
+    try:
+        os.fsync(fd)
+        os.posix_fadvise(fd, 0, 0, os.POSIX_FADV_DONTNEED)
+    finally:
+        os.close(fd)
+
+
+@pytest.mark.skipif(not HAS_FILE_READER, reason="C++ extension not built")
+class TestColdCacheBenchmarks:
+    """100 random 512x512 windows from a cold page cache: page faults on a
+    mapping vs all row reads of the batch submitted at once."""
+
+    @pytest.fixture
+    def windows(self):
+        rng = np.random.default_rng(42)
+        return [[int(rng.integers(0, 3000)), int(rng.integers(0, 3000)), 512, 512] for _ in range(100)]
+
+    def run_cold(self, benchmark, test_data_pair, read):
+        bin_path = f"{test_data_pair['raw_base']}.bin"
+        benchmark.pedantic(read, setup=lambda: drop_file_cache(bin_path), rounds=5)
+
+    def test_cold_mmap(self, test_data_pair, windows, benchmark):
+        def read():
+            reader = MMapReader(test_data_pair["raw_base"])
+            for x, y, w, h in windows:
+                reader.get_window_copy(x, y, w, h)
+
+        self.run_cold(benchmark, test_data_pair, read)
+
+    @pytest.mark.parametrize("backend", ["io_uring", "pread"])
+    def test_cold_file_reader(self, test_data_pair, windows, backend, benchmark):
+        try:
+            FileReader(test_data_pair["raw_base"], backend=backend)
+        except RuntimeError:
+            pytest.skip(f"{backend} not available")
+
+        def read():
+            reader = FileReader(test_data_pair["raw_base"], backend=backend)
+            reader.read_windows(windows)
+
+        self.run_cold(benchmark, test_data_pair, read)
+
+
 # Direct comparison test (not using pytest-benchmark, prints results)
 @pytest.mark.skipif(not HAS_RASTERIO, reason="rasterio not installed")
 class TestDirectComparison:
@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include "geoslice/codec.hpp"
+#include <random>
+#include <string>
+
+namespace {
+std::vector<uint8_t> roundtrip(geoslice::TileCodec codec, const std::vector<uint8_t>& data, bool& compressed) {
+    std::vector<uint8_t> packed;
+    compressed = geoslice::compress_block(codec, data.data(), data.size(), packed);
+    if (!compressed) return data;
+    std::vector<uint8_t> out(data.size());
+    geoslice::decompress_block(codec, packed.data(), packed.size(), out.data(), out.size());
+    return out;
+}
+
+// Byte stream of the C library's rand() LCG: no repeated 4-byte sequences
+// over a few hundred bytes, so LZ4 emits it as one literal run
+std::vector<uint8_t> lcg_bytes(size_t n) {
+    std::vector<uint8_t> out(n);
+    uint32_t x = 1;
+    for (auto& b : out) {
+        x = (x * 1103515245u + 12345u) & 0x7fffffffu;
+        b = static_cast<uint8_t>(x >> 16);
+    }
+    return out;
+}
+
+// Decodes an LZ4 block the way the format description spells it out and
+// checks the end-of-block rules liblz4's decoder relies on: the last
+// sequence is literals only, the last 5 bytes are literals and the last
+// match starts at least 12 bytes before the end.
+::testing::AssertionResult follows_lz4_format(const std::vector<uint8_t>& block, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> out;
+    size_t pos = 0;
+    auto length = [&](size_t len) {
+        if (len != 15) return len;
+        uint8_t more;
+        do {
+            more = pos < block.size() ? block[pos++] : 0;
+            len += more;
+        } while (more == 255);
+        return len;
+    };
+    while (pos < block.size()) {
+        const uint8_t token = block[pos++];
+        const size_t literals = length(token >> 4);
+        if (literals > block.size() - pos) return ::testing::AssertionFailure() << "literals past the end";
+        out.insert(out.end(), block.begin() + pos, block.begin() + pos + literals);
+        pos += literals;
+        if (pos == block.size()) break;  // last sequence: literals only
+
+        if (block.size() - pos < 2) return ::testing::AssertionFailure() << "truncated offset";
+        const size_t offset = block[pos] | (block[pos + 1] << 8);
+        pos += 2;
+        if (offset == 0 || offset > out.size()) return ::testing::AssertionFailure() << "bad offset " << offset;
+        if (out.size() + 12 > data.size()) return ::testing::AssertionFailure() << "match within 12 bytes of the end";
+        const size_t match = length(token & 15) + 4;
+        for (size_t i = 0; i < match; i++) out.push_back(out[out.size() - offset]);
+        if (out.size() + 5 > data.size()) return ::testing::AssertionFailure() << "match within 5 bytes of the end";
+    }
+    if (out != data) return ::testing::AssertionFailure() << "decodes to different bytes";
+    return ::testing::AssertionSuccess();
+}
+
+// Smooth uint16 terrain with some noise, typical of a DEM tile
+std::vector<uint8_t> terrain(size_t pixels) {
+    std::mt19937 rng(7);
+    std::vector<uint8_t> data(pixels * 2);
+    for (size_t i = 0; i < pixels; i++) {
+        const uint16_t v = static_cast<uint16_t>(1000 + (i % 256) / 4 + (i / 256) / 8 + rng() % 3);
+        data[2 * i] = static_cast<uint8_t>(v);
+        data[2 * i + 1] = static_cast<uint8_t>(v >> 8);
+    }
+    return data;
+}
+}
+
+TEST(CodecTest, Lz4RoundTripsAndShrinks) {
+    bool compressed = false;
+    const auto data = terrain(256 * 256);
+    EXPECT_EQ(roundtrip(geoslice::TileCodec::LZ4, data, compressed), data);
+    EXPECT_TRUE(compressed);
+
+    // Long runs: overlapping matches and multi-byte length continuations
+    std::vector<uint8_t> runs(100000, 0);
+    std::fill(runs.begin() + 5000, runs.begin() + 7000, 0xAB);
+    std::vector<uint8_t> packed;
+    ASSERT_TRUE(geoslice::compress_block(geoslice::TileCodec::LZ4, runs.data(), runs.size(), packed));
+    EXPECT_LT(packed.size(), 1000u);
+    std::vector<uint8_t> out(runs.size());
+    geoslice::lz4_decompress(packed.data(), packed.size(), out.data(), out.size());
+    EXPECT_EQ(out, runs);
+}
+
+TEST(CodecTest, Lz4EdgeSizes) {
+    std::mt19937 rng(1);
+    for (size_t n : {0u, 1u, 5u, 12u, 13u, 14u, 64u, 65536u + 17}) {
+        std::vector<uint8_t> data(n);
+        for (auto& b : data) b = static_cast<uint8_t>(rng() % 4);
+        std::vector<uint8_t> packed(geoslice::lz4_bound(n));
+        const size_t size = geoslice::lz4_compress(data.data(), n, packed.data(), packed.size());
+        ASSERT_GT(size, 0u) << n;
+        std::vector<uint8_t> out(n);
+        geoslice::lz4_decompress(packed.data(), size, out.data(), n);
+        EXPECT_EQ(out, data) << n;
+    }
+}
+
+TEST(CodecTest, Lz4DecodesLiblz4Blocks) {
+    // Produced by liblz4 1.9.4 LZ4_compress_default
+    const std::string text = "GeoSlice LZ4 known answer: abcabcabcabcabcabcabc";
+    std::vector<uint8_t> data(text.begin(), text.end());
+    for (int i = 0; i < 48; i++) data.push_back(static_cast<uint8_t>(i % 16));
+    data.insert(data.end(), 40, '0');
+    for (char c : std::string("tail!")) data.push_back(static_cast<uint8_t>(c));
+    const std::vector<uint8_t> block = {
+        0xfe, 0x0f, 0x47, 0x65, 0x6f, 0x53, 0x6c, 0x69, 0x63, 0x65, 0x20, 0x4c, 0x5a, 0x34, 0x20, 0x6b, 0x6e,
+        0x6f, 0x77, 0x6e, 0x20, 0x61, 0x6e, 0x73, 0x77, 0x65, 0x72, 0x3a, 0x20, 0x61, 0x62, 0x63, 0x03, 0x00,
+        0xff, 0x01, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+        0x0f, 0x10, 0x00, 0x0d, 0x1f, 0x30, 0x01, 0x00, 0x14, 0x50, 0x74, 0x61, 0x69, 0x6c, 0x21};
+    std::vector<uint8_t> out(data.size());
+    geoslice::lz4_decompress(block.data(), block.size(), out.data(), out.size());
+    EXPECT_EQ(out, data);
+
+    // Multi-byte lengths: 303 literals, then a 597-byte match at offset 3
+    const auto noise = lcg_bytes(300);
+    data = noise;
+    data.insert(data.end(), 600, 'z');
+    data.insert(data.end(), 8, 'e');
+    std::vector<uint8_t> long_block = {0xff, 0xff, 0x21};
+    long_block.insert(long_block.end(), noise.begin(), noise.end());
+    long_block.insert(long_block.end(), {'z', 'z', 'z', 0x03, 0x00, 0xff, 0xff, 0x44, 0x80});
+    long_block.insert(long_block.end(), 8, 'e');
+    out.assign(data.size(), 0);
+    geoslice::lz4_decompress(long_block.data(), long_block.size(), out.data(), out.size());
+    EXPECT_EQ(out, data);
+    EXPECT_TRUE(follows_lz4_format(long_block, data));
+}
+
+TEST(CodecTest, Lz4BlocksFollowTheFormat) {
+    std::vector<std::vector<uint8_t>> inputs = {terrain(4096), lcg_bytes(13), lcg_bytes(1000)};
+    std::vector<uint8_t> runs(70000, 'a');
+    std::fill(runs.begin() + 100, runs.begin() + 400, 'b');
+    inputs.push_back(runs);
+    inputs.push_back(std::vector<uint8_t>(20, 'x'));  // shortest input with a match
+    for (const auto& data : inputs) {
+        std::vector<uint8_t> block(geoslice::lz4_bound(data.size()));
+        block.resize(geoslice::lz4_compress(data.data(), data.size(), block.data(), block.size()));
+        ASSERT_FALSE(block.empty());
+        EXPECT_TRUE(follows_lz4_format(block, data)) << data.size() << " bytes";
+    }
+}
+
+TEST(CodecTest, IncompressibleDataIsNotCompressed) {
+    std::mt19937 rng(3);
+    std::vector<uint8_t> noise(4096);
+    for (auto& b : noise) b = static_cast<uint8_t>(rng());
+    std::vector<uint8_t> packed;
+    EXPECT_FALSE(geoslice::compress_block(geoslice::TileCodec::LZ4, noise.data(), noise.size(), packed));
+    EXPECT_FALSE(geoslice::compress_block(geoslice::TileCodec::None, noise.data(), noise.size(), packed));
+}
+
+TEST(CodecTest, RejectsCorruptBlocks) {
+    const auto data = terrain(4096);
+    std::vector<uint8_t> packed;
+    ASSERT_TRUE(geoslice::compress_block(geoslice::TileCodec::LZ4, data.data(), data.size(), packed));
+    std::vector<uint8_t> out(data.size());
+
+    // Truncated input, wrong output size, offset before the start
+    EXPECT_THROW(geoslice::lz4_decompress(packed.data(), packed.size() / 2, out.data(), out.size()),
+                 std::runtime_error);
+    EXPECT_THROW(geoslice::lz4_decompress(packed.data(), packed.size(), out.data(), out.size() - 1),
+                 std::runtime_error);
+    const uint8_t bad[] = {0x10, 'a', 0x05, 0x00};
+    EXPECT_THROW(geoslice::lz4_decompress(bad, sizeof(bad), out.data(), 10), std::runtime_error);
+}
+
+TEST(CodecTest, Names) {
+    EXPECT_EQ(geoslice::parse_codec("lz4"), geoslice::TileCodec::LZ4);
+    EXPECT_STREQ(geoslice::codec_name(geoslice::TileCodec::Deflate), "deflate");
+    EXPECT_THROW(geoslice::parse_codec("zstd"), std::invalid_argument);
+    EXPECT_TRUE(geoslice::codec_available(geoslice::TileCodec::LZ4));
+#ifdef GEOSLICE_HAVE_ZLIB
+    bool compressed = false;
+    const auto data = terrain(4096);
+    EXPECT_EQ(roundtrip(geoslice::TileCodec::Deflate, data, compressed), data);
+    EXPECT_TRUE(compressed);
+#endif
+}
+
+TEST(CodecTest, FiltersRoundTripAcrossVectorWidths) {
+    using geoslice::TileFilter;
+    std::mt19937 rng(5);
+    for (TileFilter filter : {TileFilter::Delta, TileFilter::FloatShuffle}) {
+        for (size_t sample : {1u, 2u, 4u, 8u}) {
+            for (size_t n = 1; n <= 40; n++) {  // partial vectors and scalar tails
+                const size_t rows = 3;
+                std::vector<uint8_t> data(rows * n * sample);
+                for (auto& b : data) b = static_cast<uint8_t>(rng());
+                std::vector<uint8_t> filtered(data.size());
+                geoslice::apply_filter(filter, data.data(), filtered.data(), rows, n, sample);
+                geoslice::undo_filter(filter, filtered.data(), rows, n, sample);
+                ASSERT_EQ(filtered, data) << geoslice::filter_name(filter) << " " << sample << "x" << n;
+            }
+        }
+    }
+}
+
+TEST(CodecTest, FiltersShrinkSmoothRasters) {
+    // Float32 DEM: slowly varying heights in metres
+    const size_t w = 256, h = 64;
+    std::vector<float> dem(w * h);
+    for (size_t y = 0; y < h; y++)
+        for (size_t x = 0; x < w; x++) dem[y * w + x] = 812.5f + 0.37f * x + 0.11f * y + 0.01f * ((x * y) % 7);
+    const auto* bytes = reinterpret_cast<const uint8_t*>(dem.data());
+    std::vector<uint8_t> filtered(dem.size() * sizeof(float));
+    geoslice::apply_filter(geoslice::TileFilter::FloatShuffle, bytes, filtered.data(), h, w, sizeof(float));
+
+    std::vector<uint8_t> plain, shuffled;
+    const bool plain_ok = geoslice::compress_block(geoslice::TileCodec::LZ4, bytes, filtered.size(), plain);
+    ASSERT_TRUE(geoslice::compress_block(geoslice::TileCodec::LZ4, filtered.data(), filtered.size(), shuffled));
+    EXPECT_LT(shuffled.size(), plain_ok ? plain.size() : filtered.size());
+
+    const auto data = terrain(256 * 64);
+    geoslice::apply_filter(geoslice::TileFilter::Delta, data.data(), filtered.data(), 64, 256, 2);
+    ASSERT_TRUE(geoslice::compress_block(geoslice::TileCodec::LZ4, data.data(), data.size(), plain));
+    ASSERT_TRUE(geoslice::compress_block(geoslice::TileCodec::LZ4, filtered.data(), data.size(), shuffled));
+    EXPECT_LT(shuffled.size(), plain.size());
+
+    EXPECT_EQ(geoslice::default_filter(geoslice::DType::UInt16), geoslice::TileFilter::Delta);
+    EXPECT_EQ(geoslice::default_filter(geoslice::DType::Float32), geoslice::TileFilter::FloatShuffle);
+    EXPECT_EQ(geoslice::default_filter(geoslice::DType::UInt8), geoslice::TileFilter::None);
+    EXPECT_EQ(geoslice::parse_filter("float_shuffle"), geoslice::TileFilter::FloatShuffle);
+    EXPECT_THROW(geoslice::parse_filter("lerc"), std::invalid_argument);
+}
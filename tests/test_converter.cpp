@@ -0,0 +1,578 @@
+#include <gtest/gtest.h>
+#include "geoslice/converter.hpp"
+#include "geoslice/raster_header.hpp"
+#include <algorithm>
+#include <array>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+
+#ifdef GEOSLICE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+// Minimal classic-TIFF writer: one IFD, chunks written after the header
+struct TiffWriter {
+    bool big_endian = false;
+    std::vector<uint8_t> out;
+    // tag -> (type, raw little-endian values)
+    std::map<uint16_t, std::pair<uint16_t, std::vector<uint64_t>>> tags;
+    std::map<uint16_t, std::vector<double>> double_tags;
+    std::string nodata;
+
+    void put(size_t at, uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            const int shift = big_endian ? (bytes - 1 - i) * 8 : i * 8;
+            out[at + i] = static_cast<uint8_t>(v >> shift);
+        }
+    }
+    size_t append(const void* data, size_t n) {
+        const size_t at = out.size();
+        out.insert(out.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + n);
+        return at;
+    }
+    size_t reserve(size_t n) {
+        const size_t at = out.size();
+        out.resize(at + n);
+        return at;
+    }
+    void set(uint16_t tag, uint16_t type, std::vector<uint64_t> values) { tags[tag] = {type, std::move(values)}; }
+
+    // Chunks are given in file byte order already
+    void write(const std::string& path, const std::vector<std::vector<uint8_t>>& chunks, bool tiled) {
+        out.clear();
+        reserve(8);
+        out[0] = out[1] = big_endian ? 'M' : 'I';
+        put(2, 42, 2);
+
+        std::vector<uint64_t> offsets, counts;
+        for (const auto& c : chunks) {
+            offsets.push_back(append(c.data(), c.size()));
+            counts.push_back(c.size());
+        }
+        set(tiled ? 324 : 273, 4, offsets);
+        set(tiled ? 325 : 279, 4, counts);
+
+        std::vector<std::pair<uint16_t, size_t>> doubles_at;
+        for (const auto& [tag, values] : double_tags) {
+            const size_t at = reserve(values.size() * 8);
+            for (size_t i = 0; i < values.size(); i++) {
+                uint64_t bits;
+                std::memcpy(&bits, &values[i], 8);
+                put(at + i * 8, bits, 8);
+            }
+            doubles_at.emplace_back(tag, at);
+        }
+        size_t nodata_at = 0;
+        if (!nodata.empty()) nodata_at = append(nodata.c_str(), nodata.size() + 1);
+
+        const size_t entries = tags.size() + double_tags.size() + (nodata.empty() ? 0 : 1);
+        if (out.size() % 2) reserve(1);
+        const size_t ifd = reserve(2 + entries * 12 + 4);
+        put(4, ifd, 4);
+        put(ifd, entries, 2);
+
+        // Entries must be sorted by tag
+        std::map<uint16_t, std::function<void(size_t)>> writers;
+        for (const auto& [tag, tv] : tags) {
+            writers[tag] = [&, tag = tag](size_t at) {
+                const auto& [type, values] = tags[tag];
+                const int size = type == 3 ? 2 : 4;
+                put(at, tag, 2);
+                put(at + 2, type, 2);
+                put(at + 4, values.size(), 4);
+                size_t dst = at + 8;
+                if (values.size() * size > 4) {
+                    dst = reserve(values.size() * size);
+                    put(at + 8, dst, 4);
+                }
+                for (size_t i = 0; i < values.size(); i++) put(dst + i * size, values[i], size);
+            };
+        }
+        for (const auto& [tag, at] : doubles_at) {
+            writers[tag] = [&, tag = tag, data_at = at](size_t e) {
+                put(e, tag, 2);
+                put(e + 2, 12, 2);
+                put(e + 4, double_tags[tag].size(), 4);
+                put(e + 8, data_at, 4);
+            };
+        }
+        if (!nodata.empty()) {
+            writers[42113] = [&](size_t e) {
+                put(e, 42113, 2);
+                put(e + 2, 2, 2);
+                put(e + 4, nodata.size() + 1, 4);
+                put(e + 8, nodata_at, 4);
+            };
+        }
+        size_t e = ifd + 2;
+        for (auto& [tag, fn] : writers) {
+            fn(e);
+            e += 12;
+        }
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    }
+};
+
+std::vector<uint8_t> to_bytes(const void* data, size_t n) {
+    return std::vector<uint8_t>(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + n);
+}
+
+// Reference TIFF LZW encoder (MSB-first codes, early change)
+std::vector<uint8_t> lzw_encode(const std::vector<uint8_t>& in) {
+    std::vector<uint8_t> out;
+    uint32_t buffer = 0;
+    int bits = 0, width = 9;
+    auto emit = [&](int code) {
+        buffer = (buffer << width) | code;
+        bits += width;
+        while (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<uint8_t>(buffer >> bits));
+        }
+    };
+
+    std::map<std::vector<uint8_t>, int> table;
+    auto reset = [&]() {
+        table.clear();
+        for (int i = 0; i < 256; i++) table[{static_cast<uint8_t>(i)}] = i;
+    };
+    reset();
+    emit(256);
+    int next = 258;
+    std::vector<uint8_t> w;
+    for (uint8_t c : in) {
+        auto wc = w;
+        wc.push_back(c);
+        if (table.count(wc)) {
+            w = wc;
+            continue;
+        }
+        emit(table[w]);
+        table[wc] = next++;
+        if (next == (1 << width) && width < 12) width++;
+        if (next == 4094) {
+            emit(256);
+            reset();
+            next = 258;
+            width = 9;
+        }
+        w = {c};
+    }
+    if (!w.empty()) {
+        emit(table[w]);
+        next++;
+        if (next == (1 << width) && width < 12) width++;
+    }
+    emit(257);
+    if (bits) out.push_back(static_cast<uint8_t>(buffer << (8 - bits)));
+    return out;
+}
+
+} // namespace
+
+class ConverterTest : public ::testing::Test {
+protected:
+    std::string tiff_path = "/tmp/test_geoslice_convert.tif";
+    std::string out_base = "/tmp/test_geoslice_convert";
+
+    void TearDown() override {
+        for (const char* ext : {".tif", ".json", ".bin", ".mask", ".occ"}) {
+            std::remove((out_base + ext).c_str());
+        }
+    }
+
+    template<typename T>
+    std::vector<T> read_bin(size_t n) {
+        std::vector<T> v(n);
+        std::ifstream bin(out_base + ".bin", std::ios::binary);
+        bin.read(reinterpret_cast<char*>(v.data()), n * sizeof(T));
+        return v;
+    }
+
+    static void set_image(TiffWriter& w, int width, int height, int samples, int bits, int format) {
+        w.set(256, 4, {static_cast<uint64_t>(width)});
+        w.set(257, 4, {static_cast<uint64_t>(height)});
+        w.set(258, 3, std::vector<uint64_t>(samples, bits));
+        w.set(277, 3, {static_cast<uint64_t>(samples)});
+        w.set(339, 3, std::vector<uint64_t>(samples, format));
+    }
+};
+
+TEST_F(ConverterTest, ChunkyStripsToBsq) {
+    // 3-band uint8, 10x7, 3 rows per strip (last strip short)
+    const int W = 10, H = 7;
+    TiffWriter w;
+    set_image(w, W, H, 3, 8, 1);
+    w.set(259, 3, {1});
+    w.set(278, 4, {3});
+    w.double_tags[33550] = {30.0, 30.0, 0.0};
+    w.double_tags[33922] = {0, 0, 0, 500000.0, 4000000.0, 0};
+    w.set(34735, 3, {1, 1, 0, 1, 3072, 0, 1, 32636});
+
+    std::vector<std::vector<uint8_t>> strips;
+    for (int y0 = 0; y0 < H; y0 += 3) {
+        std::vector<uint8_t> strip;
+        for (int y = y0; y < std::min(y0 + 3, H); y++)
+            for (int x = 0; x < W; x++)
+                for (int s = 0; s < 3; s++) strip.push_back(static_cast<uint8_t>(s * 100 + y * W + x));
+        strips.push_back(strip);
+    }
+    w.write(tiff_path, strips, false);
+
+    auto meta = geoslice::convert_tiff(tiff_path, out_base);
+    EXPECT_STREQ(meta.dtype(), "uint8");
+    EXPECT_EQ(meta.count, 3);
+    EXPECT_EQ(meta.crs, "EPSG:32636");
+    EXPECT_DOUBLE_EQ(meta.transform[0], 30.0);
+    EXPECT_DOUBLE_EQ(meta.transform[2], 500000.0);
+    EXPECT_DOUBLE_EQ(meta.transform[4], -30.0);
+    EXPECT_DOUBLE_EQ(meta.transform[5], 4000000.0);
+
+    geoslice::MMapReader reader(out_base);
+    EXPECT_EQ(reader.metadata().crs, "EPSG:32636");
+    EXPECT_DOUBLE_EQ(reader.metadata().transform[2], 500000.0);
+    auto view = reader.get_window(0, 0, W, H);
+    for (int b = 0; b < 3; b++)
+        for (int y = 0; y < H; y++)
+            for (int x = 0; x < W; x++)
+                ASSERT_EQ(view.at<uint8_t>(b, y, x), static_cast<uint8_t>(b * 100 + y * W + x));
+}
+
+TEST_F(ConverterTest, PlanarTilesWithPredictor) {
+    // 2-band uint16, 20x18 in 16x16 tiles (edge tiles padded), predictor 2
+    const int W = 20, H = 18, T = 16;
+    TiffWriter w;
+    set_image(w, W, H, 2, 16, 1);
+    w.set(259, 3, {1});
+    w.set(284, 3, {2});
+    w.set(317, 3, {2});
+    w.set(322, 3, {T});
+    w.set(323, 3, {T});
+
+    auto value = [](int b, int y, int x) { return static_cast<uint16_t>(b * 5000 + y * 300 + x * 7); };
+    std::vector<std::vector<uint8_t>> tiles;
+    for (int b = 0; b < 2; b++) {
+        for (int ty = 0; ty < 2; ty++) {
+            for (int tx = 0; tx < 2; tx++) {
+                std::vector<uint16_t> tile(T * T, 0);
+                for (int y = 0; y < T; y++) {
+                    for (int x = 0; x < T; x++) {
+                        const int gx = tx * T + x, gy = ty * T + y;
+                        if (gx < W && gy < H) tile[y * T + x] = value(b, gy, gx);
+                    }
+                    for (int x = T - 1; x > 0; x--) tile[y * T + x] -= tile[y * T + x - 1];
+                }
+                tiles.push_back(to_bytes(tile.data(), tile.size() * 2));
+            }
+        }
+    }
+    w.write(tiff_path, tiles, true);
+
+    auto meta = geoslice::convert_tiff(tiff_path, out_base, {2});
+    EXPECT_STREQ(meta.dtype(), "uint16");
+    EXPECT_TRUE(meta.crs.empty());
+    EXPECT_DOUBLE_EQ(meta.transform[0], 1.0);
+
+    auto data = read_bin<uint16_t>(2 * W * H);
+    for (int b = 0; b < 2; b++)
+        for (int y = 0; y < H; y++)
+            for (int x = 0; x < W; x++)
+                ASSERT_EQ(data[(b * H + y) * W + x], value(b, y, x)) << b << "," << y << "," << x;
+}
+
+TEST_F(ConverterTest, LzwAndBigEndian) {
+    // Big-endian int16 with LZW, one strip
+    const int W = 64, H = 40;
+    TiffWriter w;
+    w.big_endian = true;
+    set_image(w, W, H, 1, 16, 2);
+    w.set(259, 3, {5});
+    w.set(278, 4, {static_cast<uint64_t>(H)});
+
+    std::vector<int16_t> values(W * H);
+    std::vector<uint8_t> raw;
+    for (int i = 0; i < W * H; i++) {
+        values[i] = static_cast<int16_t>((i % 37) * 11 - 200 + (i / 300));
+        raw.push_back(static_cast<uint8_t>(static_cast<uint16_t>(values[i]) >> 8));
+        raw.push_back(static_cast<uint8_t>(values[i]));
+    }
+    w.write(tiff_path, {lzw_encode(raw)}, false);
+
+    auto meta = geoslice::convert_tiff(tiff_path, out_base);
+    EXPECT_STREQ(meta.dtype(), "int16");
+    EXPECT_EQ(read_bin<int16_t>(W * H), values);
+}
+
+TEST_F(ConverterTest, PackBits) {
+    TiffWriter w;
+    set_image(w, 8, 2, 1, 8, 1);
+    w.set(259, 3, {32773});
+    w.set(278, 4, {2});
+    // Row 0: run of eight 7s; row 1: literal 0..7
+    std::vector<uint8_t> packed = {static_cast<uint8_t>(-7), 7, 7, 0, 1, 2, 3, 4, 5, 6, 7};
+    w.write(tiff_path, {packed}, false);
+
+    geoslice::convert_tiff(tiff_path, out_base);
+    auto data = read_bin<uint8_t>(16);
+    EXPECT_EQ(data, (std::vector<uint8_t>{7, 7, 7, 7, 7, 7, 7, 7, 0, 1, 2, 3, 4, 5, 6, 7}));
+}
+
+#ifdef GEOSLICE_HAVE_ZLIB
+TEST_F(ConverterTest, DeflateFloatPredictorWithNodata) {
+    // float32 with the floating-point predictor, nodata -9999, mask + occupancy
+    const int W = 32, H = 8;
+    TiffWriter w;
+    set_image(w, W, H, 1, 32, 3);
+    w.set(259, 3, {8});
+    w.set(278, 4, {static_cast<uint64_t>(H)});
+    w.set(317, 3, {3});
+    w.nodata = "-9999";
+
+    std::vector<float> values(W * H);
+    for (int i = 0; i < W * H; i++) values[i] = (i % W) < 16 ? -9999.0f : 0.25f * i;
+
+    // Predictor 3: per row, split bytes into planes (MSB first), then byte delta
+    std::vector<uint8_t> encoded;
+    for (int y = 0; y < H; y++) {
+        std::vector<uint8_t> row(W * 4);
+        const uint8_t* src = reinterpret_cast<const uint8_t*>(&values[y * W]);
+        for (int x = 0; x < W; x++)
+            for (int b = 0; b < 4; b++) row[(3 - b) * W + x] = src[x * 4 + b];
+        for (int i = W * 4 - 1; i > 0; i--) row[i] -= row[i - 1];
+        encoded.insert(encoded.end(), row.begin(), row.end());
+    }
+    uLongf size = compressBound(encoded.size());
+    std::vector<uint8_t> compressed(size);
+    ASSERT_EQ(compress(compressed.data(), &size, encoded.data(), encoded.size()), Z_OK);
+    compressed.resize(size);
+    w.write(tiff_path, {compressed}, false);
+
+    geoslice::ConvertOptions options;
+    options.write_mask = true;
+    options.write_occupancy = true;
+    options.tile_size = 16;
+    auto meta = geoslice::convert_tiff(tiff_path, out_base, options);
+    ASSERT_TRUE(meta.nodata.has_value());
+    EXPECT_DOUBLE_EQ(*meta.nodata, -9999.0);
+    EXPECT_EQ(read_bin<float>(W * H), values);
+
+    geoslice::MMapReader reader(out_base);
+    ASSERT_TRUE(reader.has_mask());
+    EXPECT_EQ(reader.coverage(0, 0, 16, 8), geoslice::Coverage::Empty);
+    EXPECT_EQ(reader.coverage(16, 0, 16, 8), geoslice::Coverage::Full);
+}
+
+TEST_F(ConverterTest, RejectsCorruptDeflate) {
+    const int W = 16, H = 4;
+    std::vector<uint8_t> raw(W * H);
+    for (int i = 0; i < W * H; i++) raw[i] = static_cast<uint8_t>(i * 3);
+    uLongf size = compressBound(raw.size());
+    std::vector<uint8_t> compressed(size);
+    ASSERT_EQ(compress(compressed.data(), &size, raw.data(), raw.size()), Z_OK);
+    compressed.resize(size);
+
+    geoslice::ConvertOptions options;
+    options.overwrite = true;
+    auto convert = [&](const std::vector<uint8_t>& strip) {
+        TiffWriter w;
+        set_image(w, W, H, 1, 8, 1);
+        w.set(259, 3, {8});
+        w.set(278, 4, {static_cast<uint64_t>(H)});
+        w.write(tiff_path, {strip}, false);
+        return geoslice::convert_tiff(tiff_path, out_base, options);
+    };
+    convert(compressed);
+    EXPECT_EQ(read_bin<uint8_t>(W * H), raw);
+
+    // Truncated stream
+    EXPECT_THROW(convert({compressed.begin(), compressed.begin() + compressed.size() / 2}), std::runtime_error);
+    // Garbage after a valid zlib header
+    std::vector<uint8_t> garbage = compressed;
+    std::fill(garbage.begin() + 2, garbage.end(), 0xFF);
+    EXPECT_THROW(convert(garbage), std::runtime_error);
+    // Bad checksum
+    std::vector<uint8_t> bad_adler = compressed;
+    bad_adler.back() ^= 0x5A;
+    EXPECT_THROW(convert(bad_adler), std::runtime_error);
+}
+#endif
+
+TEST_F(ConverterTest, InfiniteNodataIsValidJson) {
+    TiffWriter w;
+    set_image(w, 2, 2, 1, 32, 3);
+    w.set(259, 3, {1});
+    w.set(278, 4, {2});
+    w.nodata = "-inf";
+    std::vector<float> values = {1.0f, -INFINITY, 2.0f, 3.0f};
+    w.write(tiff_path, {to_bytes(values.data(), values.size() * 4)}, false);
+
+    geoslice::convert_tiff(tiff_path, out_base);
+    std::ifstream file(out_base + ".json");
+    const std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(json.find("\"nodata\": -Infinity"), std::string::npos) << json;
+
+    geoslice::MMapReader reader(out_base);
+    ASSERT_TRUE(reader.metadata().nodata.has_value());
+    EXPECT_EQ(*reader.metadata().nodata, -INFINITY);
+}
+
+TEST_F(ConverterTest, NodataIgnoresLocale) {
+    const std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+    if (!std::setlocale(LC_NUMERIC, "de_DE.UTF-8") && !std::setlocale(LC_NUMERIC, "de_DE")) {
+        GTEST_SKIP() << "de_DE locale not installed";
+    }
+    TiffWriter w;
+    set_image(w, 2, 1, 1, 32, 3);
+    w.set(259, 3, {1});
+    w.set(278, 4, {1});
+    w.nodata = "-3.4028235e+38";
+    std::vector<float> values = {1.0f, 2.0f};
+    w.write(tiff_path, {to_bytes(values.data(), values.size() * 4)}, false);
+
+    auto meta = geoslice::convert_tiff(tiff_path, out_base);
+    std::setlocale(LC_NUMERIC, previous.c_str());
+    ASSERT_TRUE(meta.nodata.has_value());
+    EXPECT_DOUBLE_EQ(*meta.nodata, -3.4028235e+38);
+}
+
+TEST_F(ConverterTest, WritesBinaryHeader) {
+    TiffWriter w;
+    set_image(w, 6, 3, 1, 32, 1);
+    w.set(259, 3, {1});
+    w.set(278, 4, {3});
+    w.set(34735, 3, {1, 1, 0, 1, 2048, 0, 1, 4326});
+    std::vector<uint32_t> values(18);
+    for (int i = 0; i < 18; i++) values[i] = 1000u * i;
+    w.write(tiff_path, {to_bytes(values.data(), values.size() * 4)}, false);
+
+    geoslice::ConvertOptions options;
+    options.write_header = true;
+    geoslice::convert_tiff(tiff_path, out_base, options);
+    std::remove((out_base + ".json").c_str());
+
+    geoslice::MMapReader reader(out_base);
+    EXPECT_EQ(reader.data_offset(), geoslice::HEADER_DATA_OFFSET);
+    EXPECT_STREQ(reader.metadata().dtype(), "uint32");
+    EXPECT_EQ(reader.metadata().crs, "EPSG:4326");
+    EXPECT_EQ(reader.get_window(0, 0, 6, 3).at<uint32_t>(0, 2, 5), 17000u);
+}
+
+TEST_F(ConverterTest, RejectsOverflowingBigTiffValues) {
+    // BigTIFF with one IFD of n_entries entries (claiming n of them), all
+    // values inline, then the pixels
+    auto write = [&](uint64_t n, const std::vector<std::array<uint64_t, 4>>& entries) {
+        std::vector<uint8_t> file(16 + 8 + entries.size() * 20 + 8 + 5, 0);
+        auto put = [&](size_t at, uint64_t v, int bytes) {
+            for (int i = 0; i < bytes; i++) file[at + i] = static_cast<uint8_t>(v >> (i * 8));
+        };
+        file[0] = file[1] = 'I';
+        put(2, 43, 2);
+        put(4, 8, 2);
+        put(8, 16, 8);
+        put(16, n, 8);
+        for (size_t i = 0; i < entries.size(); i++) {
+            const auto& [tag, type, count, value] = entries[i];
+            put(24 + i * 20, tag, 2);
+            put(26 + i * 20, type, 2);
+            put(28 + i * 20, count, 8);
+            put(36 + i * 20, value, 8);
+        }
+        for (int i = 0; i < 5; i++) file[file.size() - 5 + i] = static_cast<uint8_t>(i + 1);
+        std::ofstream(tiff_path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+    };
+    const uint64_t pixels_at = 16 + 8 + 7 * 20 + 8;
+    auto image = [&](uint64_t width) {
+        return std::vector<std::array<uint64_t, 4>>{
+            {256, 16, 1, width}, {257, 3, 1, 1}, {258, 3, 1, 8}, {273, 16, 1, pixels_at},
+            {278, 3, 1, 1}, {279, 16, 1, 5}, {33550, 12, 1, 0}};
+    };
+    geoslice::ConvertOptions options;
+    options.overwrite = true;
+
+    write(7, image(5));
+    EXPECT_EQ(geoslice::convert_tiff(tiff_path, out_base, options).width, 5);
+
+    // Entry count whose size in bytes wraps to 4
+    write(922337203685477581ull, image(5));
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base, options), std::runtime_error);
+
+    // Value counts whose size in bytes wraps to 8, which looks inline
+    auto entries = image(5);
+    entries[0][2] = (1ull << 61) + 1;
+    write(7, entries);
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base, options), std::runtime_error);
+    entries = image(5);
+    entries[6][2] = (1ull << 61) + 1;
+    write(7, entries);
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base, options), std::runtime_error);
+
+    // 2^32 + 5 is not 5
+    write(7, image((1ull << 32) + 5));
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base, options), std::runtime_error);
+}
+
+TEST_F(ConverterTest, RejectsOversizeLayouts) {
+    geoslice::ConvertOptions options;
+    options.overwrite = true;
+
+    // INT_MAX x INT_MAX x 4 float64 samples wraps size_t
+    TiffWriter w;
+    set_image(w, std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), 4, 64, 3);
+    w.set(259, 3, {1});
+    w.set(278, 4, {1});
+    w.write(tiff_path, {std::vector<uint8_t>(16)}, false);
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base, options), std::runtime_error);
+
+    // A 4x4 image in one 65536x65536 uint16 tile would need an 8 GiB buffer
+    TiffWriter tiled;
+    set_image(tiled, 4, 4, 1, 16, 1);
+    tiled.set(259, 3, {1});
+    tiled.set(322, 4, {65536});
+    tiled.set(323, 4, {65536});
+    tiled.write(tiff_path, {std::vector<uint8_t>(32)}, true);
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base, options), std::runtime_error);
+
+    // Tile sizes whose product wraps size_t
+    tiled.set(277, 3, {65535});
+    tiled.set(258, 3, {16});
+    tiled.set(339, 3, {1});
+    tiled.set(284, 3, {1});
+    tiled.set(322, 4, {std::numeric_limits<uint32_t>::max() >> 1});
+    tiled.set(323, 4, {std::numeric_limits<uint32_t>::max() >> 1});
+    tiled.write(tiff_path, {std::vector<uint8_t>(32)}, true);
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base, options), std::runtime_error);
+}
+
+TEST_F(ConverterTest, Errors) {
+    EXPECT_THROW(geoslice::convert_tiff("/nonexistent/file.tif", out_base), std::runtime_error);
+
+    std::ofstream(tiff_path) << "not a tiff at all";
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base), std::runtime_error);
+
+    // Unsupported compression (JPEG)
+    TiffWriter w;
+    set_image(w, 4, 4, 1, 8, 1);
+    w.set(259, 3, {7});
+    w.set(278, 4, {4});
+    w.write(tiff_path, {std::vector<uint8_t>(16)}, false);
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base), std::runtime_error);
+
+    // Existing outputs are kept unless overwrite is set
+    w.set(259, 3, {1});
+    w.write(tiff_path, {std::vector<uint8_t>(16)}, false);
+    geoslice::convert_tiff(tiff_path, out_base);
+    EXPECT_THROW(geoslice::convert_tiff(tiff_path, out_base), std::runtime_error);
+    geoslice::ConvertOptions options;
+    options.overwrite = true;
+    EXPECT_NO_THROW(geoslice::convert_tiff(tiff_path, out_base, options));
+}
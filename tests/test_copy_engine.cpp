@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "geoslice/copy_engine.hpp"
+#include "counting_executor.hpp"
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+class CopyEngineTest : public ::testing::Test {
+protected:
+    std::string test_base = "/tmp/test_geoslice_copy";
+
+    void SetUp() override {
+        std::ofstream json(test_base + ".json");
+        json << R"({
+            "dtype": "uint16",
+            "count": 3,
+            "height": 120,
+            "width": 90,
+            "transform": [1.0, 0.0, 0.0, 0.0, -1.0, 120.0],
+            "crs": "EPSG:32636"
+        })";
+        json.close();
+
+        std::vector<uint16_t> data(3 * 120 * 90);
+        for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<uint16_t>(i * 7);
+        std::ofstream bin(test_base + ".bin", std::ios::binary);
+        bin.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(uint16_t));
+    }
+
+    void TearDown() override {
+        std::remove((test_base + ".json").c_str());
+        std::remove((test_base + ".bin").c_str());
+    }
+
+    // Small thresholds so the test windows are split into many stripes
+    static geoslice::CopyEngineOptions striped() {
+        geoslice::CopyEngineOptions options;
+        options.threads_per_node = 3;
+        options.min_parallel_bytes = 0;
+        options.task_bytes = 500;
+        return options;
+    }
+};
+
+TEST(CpuList, ParsesRangesAndSingles) {
+    EXPECT_EQ(geoslice::parse_cpu_list("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(geoslice::parse_cpu_list("5"), (std::vector<int>{5}));
+    EXPECT_TRUE(geoslice::parse_cpu_list("").empty());
+    EXPECT_THROW(geoslice::parse_cpu_list("3-1"), std::invalid_argument);
+    EXPECT_THROW(geoslice::parse_cpu_list("a"), std::invalid_argument);
+}
+
+TEST(NumaNodes, CoverUsableCpus) {
+    auto nodes = geoslice::numa_nodes();
+    ASSERT_FALSE(nodes.empty());
+    for (const auto& node : nodes) EXPECT_FALSE(node.cpus.empty());
+}
+
+TEST_F(CopyEngineTest, MatchesReadWindow) {
+    geoslice::MMapReader reader(test_base);
+    geoslice::CopyEngine engine(striped());
+    EXPECT_EQ(engine.threads(), std::min<size_t>(3, geoslice::default_executor()->concurrency() + 1));
+
+    const size_t pixels = 3 * 101 * 77;
+    std::vector<uint16_t> expected(pixels), actual(pixels);
+    reader.read_window(5, 9, 77, 101, expected.data());
+    engine.read_window(reader, 5, 9, 77, 101, actual.data());
+    EXPECT_EQ(actual, expected);
+}
+
+TEST_F(CopyEngineTest, HelpersRunOnTheDefaultExecutor) {
+    auto executor = std::make_shared<CountingExecutor>();
+    geoslice::set_default_executor(executor);
+    geoslice::MMapReader reader(test_base);
+    geoslice::CopyEngine engine(striped());
+    // The caller and the 2 helpers the executor can run
+    EXPECT_EQ(engine.threads(), 3u);
+
+    std::vector<uint16_t> expected(3 * 120 * 90), actual(expected.size());
+    reader.read_window(0, 0, 90, 120, expected.data());
+    engine.read_window(reader, 0, 0, 90, 120, actual.data());
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(executor->submitted.load(), 2);
+    geoslice::set_default_executor(nullptr);
+}
+
+TEST_F(CopyEngineTest, ChunkedReaderAndConcurrentCallers) {
+    geoslice::ReaderOptions chunked;
+    chunked.chunk_bytes = 2000;
+    geoslice::MMapReader reader(test_base, chunked);
+    geoslice::CopyEngine engine(striped());
+
+    std::vector<uint16_t> expected(3 * 120 * 90);
+    reader.read_window(0, 0, 90, 120, expected.data());
+
+    std::vector<std::vector<uint16_t>> outs(4, std::vector<uint16_t>(expected.size()));
+    std::vector<std::thread> callers;
+    for (auto& out : outs) {
+        callers.emplace_back([&] { engine.read_window(reader, 0, 0, 90, 120, out.data()); });
+    }
+    for (auto& t : callers) t.join();
+    for (const auto& out : outs) EXPECT_EQ(out, expected);
+}
+
+TEST_F(CopyEngineTest, RejectsInvalidWindow) {
+    geoslice::MMapReader reader(test_base);
+    geoslice::CopyEngine engine(striped());
+    std::vector<uint16_t> out(3 * 10 * 10);
+
+    EXPECT_THROW(engine.read_window(reader, 85, 0, 10, 10, out.data()), std::out_of_range);
+    EXPECT_THROW(reader.read_band(3, 0, 0, 10, 10, out.data()), std::out_of_range);
+}
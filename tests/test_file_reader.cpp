@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+#include "geoslice/file_reader.hpp"
+#include "geoslice/raster_header.hpp"
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+class FileReaderTest : public ::testing::Test {
+protected:
+    std::string base = "/tmp/test_geoslice_file_reader";
+    static constexpr int W = 300, H = 200, B = 3;
+
+    void SetUp() override {
+        std::ofstream json(base + ".json");
+        json << R"({"dtype": "uint16", "count": 3, "height": 200, "width": 300,)"
+             << R"( "transform": [1.0, 0.0, 0.0, 0.0, -1.0, 200.0], "crs": "EPSG:4326", "nodata": null})";
+        json.close();
+
+        std::ofstream bin(base + ".bin", std::ios::binary);
+        for (int b = 0; b < B; b++)
+            for (int y = 0; y < H; y++)
+                for (int x = 0; x < W; x++) {
+                    const uint16_t v = value(b, y, x);
+                    bin.write(reinterpret_cast<const char*>(&v), sizeof(v));
+                }
+    }
+
+    void TearDown() override {
+        std::remove((base + ".json").c_str());
+        std::remove((base + ".bin").c_str());
+    }
+
+    static uint16_t value(int b, int y, int x) { return static_cast<uint16_t>(b * 20000 + y * 97 + x); }
+
+    // pread backend that records the reads it is handed
+    struct CountingBackend : geoslice::ReaderBackend {
+        std::unique_ptr<geoslice::ReaderBackend> inner = geoslice::make_pread_backend(1);
+        std::vector<size_t> lengths;
+
+        const char* name() const override { return "counting"; }
+        void read(int fd, const std::vector<geoslice::ReadRequest>& requests) override {
+            for (const auto& r : requests) lengths.push_back(r.length);
+            inner->read(fd, requests);
+        }
+    };
+
+    std::shared_ptr<geoslice::ReaderBackend> io_uring_or_null() {
+        try {
+            return geoslice::make_io_uring_backend(16);
+        } catch (const std::runtime_error&) {
+            return nullptr;
+        }
+    }
+};
+
+TEST_F(FileReaderTest, MatchesMMapReader) {
+    geoslice::MMapReader mmap_reader(base);
+    geoslice::FileReader reader(base);
+    EXPECT_EQ(reader.width(), W);
+    EXPECT_EQ(reader.bands(), B);
+
+    const int x = 17, y = 33, w = 120, h = 90;
+    std::vector<uint16_t> expected(B * w * h), got(B * w * h);
+    mmap_reader.read_window(x, y, w, h, expected.data());
+    reader.read_window(x, y, w, h, got.data());
+    EXPECT_EQ(got, expected);
+}
+
+TEST_F(FileReaderTest, PreadBackendReadsBatch) {
+    geoslice::FileReader reader(base, geoslice::make_pread_backend(4));
+    EXPECT_STREQ(reader.backend().name(), "pread");
+
+    const std::vector<geoslice::WindowRect> windows = {{0, 0, 300, 200}, {250, 150, 50, 50}, {5, 7, 1, 1}};
+    std::vector<std::vector<uint16_t>> bufs;
+    std::vector<void*> outs;
+    for (const auto& w : windows) bufs.emplace_back(B * w.width * w.height);
+    for (auto& buf : bufs) outs.push_back(buf.data());
+    reader.read_windows(windows, outs);
+
+    for (size_t i = 0; i < windows.size(); i++) {
+        const auto& w = windows[i];
+        for (int b = 0; b < B; b++)
+            for (int r = 0; r < w.height; r++)
+                for (int c = 0; c < w.width; c++)
+                    ASSERT_EQ(bufs[i][(b * w.height + r) * w.width + c], value(b, w.y + r, w.x + c));
+    }
+}
+
+TEST_F(FileReaderTest, IoUringBackendMatchesPread) {
+    auto ring = io_uring_or_null();
+    if (!ring) GTEST_SKIP() << "io_uring not available";
+
+    // More row reads than the queue depth, so the ring is refilled
+    geoslice::FileReader uring_reader(base, ring);
+    geoslice::FileReader pread_reader(base, geoslice::make_pread_backend(1));
+    EXPECT_STREQ(uring_reader.backend().name(), "io_uring");
+
+    std::vector<uint16_t> expected(B * W * H), got(B * W * H);
+    pread_reader.read_window(0, 0, W, H, expected.data());
+    uring_reader.read_window(0, 0, W, H, got.data());
+    EXPECT_EQ(got, expected);
+}
+
+TEST_F(FileReaderTest, IoUringBackendSharedAcrossThreads) {
+    auto ring = io_uring_or_null();
+    if (!ring) GTEST_SKIP() << "io_uring not available";
+
+    // Readers on one backend read concurrently, each on a ring of its own
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            geoslice::FileReader reader(base, ring);
+            for (int i = 0; i < 20; i++) {
+                const int x = (t * 37 + i * 11) % (W - 64), y = (t * 23 + i * 7) % (H - 48);
+                std::vector<uint16_t> got(B * 48 * 64);
+                reader.read_window(x, y, 64, 48, got.data());
+                for (int b = 0; b < B; b++)
+                    for (int r = 0; r < 48; r++)
+                        for (int c = 0; c < 64; c++)
+                            mismatches[t] += got[(b * 48 + r) * 64 + c] != value(b, y + r, x + c);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(mismatches, std::vector<int>(4, 0));
+}
+
+TEST_F(FileReaderTest, UsesBinaryHeader) {
+    geoslice::MMapReader original(base);
+    std::vector<uint16_t> pixels(B * W * H);
+    original.read_window(0, 0, W, H, pixels.data());
+
+    const std::string headed = base + "_headed";
+    {
+        std::ofstream bin(headed + ".bin", std::ios::binary);
+        const auto header = geoslice::make_header(original.metadata());
+        bin.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::vector<char> pad(geoslice::HEADER_DATA_OFFSET - sizeof(header), 0);
+        bin.write(pad.data(), pad.size());
+        bin.write(reinterpret_cast<const char*>(pixels.data()), pixels.size() * sizeof(uint16_t));
+    }
+
+    geoslice::FileReader reader(headed);
+    EXPECT_EQ(reader.data_offset(), geoslice::HEADER_DATA_OFFSET);
+    uint16_t px[B];
+    reader.read_window(299, 199, 1, 1, px);
+    for (int b = 0; b < B; b++) EXPECT_EQ(px[b], value(b, 199, 299));
+    std::remove((headed + ".bin").c_str());
+}
+
+TEST_F(FileReaderTest, RejectsBadWindowsAndShortFiles) {
+    geoslice::FileReader reader(base);
+    std::vector<uint16_t> out(B * 10 * 10);
+    EXPECT_THROW(reader.read_window(295, 0, 10, 10, out.data()), std::out_of_range);
+    EXPECT_THROW(reader.read_windows({{0, 0, 10, 10}}, {}), std::invalid_argument);
+
+    // Truncated .bin: refused up front; reads past the end throw
+    {
+        std::ofstream bin(base + ".bin", std::ios::binary | std::ios::trunc);
+        bin << "short";
+    }
+    EXPECT_THROW(geoslice::FileReader{base}, std::runtime_error);
+
+    std::vector<uint8_t> small(8);
+    for (auto backend : {std::shared_ptr<geoslice::ReaderBackend>(geoslice::make_pread_backend()), io_uring_or_null()}) {
+        if (!backend) continue;
+        EXPECT_THROW(backend->read(-1, {{0, small.size(), small.data()}}), std::runtime_error) << backend->name();
+    }
+}
+
+TEST_F(FileReaderTest, IoUringShortReadAtEndOfFileThrows) {
+    auto ring = io_uring_or_null();
+    if (!ring) GTEST_SKIP() << "io_uring not available";
+
+    // Cut the file after the readers checked its size: the last row read
+    // comes back short, then empty
+    geoslice::FileReader uring_reader(base, ring);
+    geoslice::FileReader pread_reader(base, geoslice::make_pread_backend(1));
+    ASSERT_EQ(truncate((base + ".bin").c_str(), static_cast<off_t>(B) * W * H * 2 - W), 0);
+
+    std::vector<uint16_t> out(B * W * H);
+    auto message = [&](const geoslice::FileReader& reader) -> std::string {
+        try {
+            reader.read_window(0, 0, W, H, out.data());
+        } catch (const std::runtime_error& e) {
+            return e.what();
+        }
+        return "no exception";
+    };
+    EXPECT_EQ(message(pread_reader), "Read past end of file");
+    EXPECT_EQ(message(uring_reader), "Read past end of file");
+}
+
+TEST_F(FileReaderTest, DirectModeMatchesBufferedReads) {
+    geoslice::MMapReader mmap_reader(base);
+    geoslice::FileReaderOptions options;
+    options.direct = true;
+    options.buffer_bytes = 16 * 1024;  // forces split requests and several buffer rounds
+    options.max_buffers = 2;
+
+    auto ring = io_uring_or_null();
+    for (auto backend : {std::shared_ptr<geoslice::ReaderBackend>(geoslice::make_pread_backend()), ring}) {
+        if (!backend) continue;
+        geoslice::FileReader reader(base, backend, options);
+
+        // The last window reaches into the file's final partial block
+        const std::vector<geoslice::WindowRect> windows = {{0, 0, 300, 200}, {13, 41, 77, 5}, {250, 190, 50, 10}};
+        for (const auto& w : windows) {
+            std::vector<uint16_t> expected(B * w.width * w.height), got(B * w.width * w.height);
+            mmap_reader.read_window(w.x, w.y, w.width, w.height, expected.data());
+            reader.read_window(w.x, w.y, w.width, w.height, got.data());
+            ASSERT_EQ(got, expected) << backend->name() << " " << w.x << "," << w.y;
+        }
+    }
+
+    options.buffer_bytes = 6000;
+    EXPECT_THROW(geoslice::FileReader(base, nullptr, options), std::invalid_argument);
+}
+
+TEST_F(FileReaderTest, ScanStripsCoversRaster) {
+    geoslice::FileReaderOptions options;
+    options.direct = true;
+    geoslice::FileReader reader(base, nullptr, options);
+
+    int next_row = 0;
+    reader.scan_strips(64, [&](const geoslice::WindowRect& strip, const void* data) {
+        EXPECT_EQ(strip.y, next_row);
+        EXPECT_EQ(strip.width, W);
+        const auto* px = static_cast<const uint16_t*>(data);
+        for (int b = 0; b < B; b++)
+            for (int r = 0; r < strip.height; r++)
+                ASSERT_EQ(px[(b * strip.height + r) * W + 5], value(b, strip.y + r, 5));
+        next_row += strip.height;
+    });
+    EXPECT_EQ(next_row, H);
+    EXPECT_THROW(reader.scan_strips(0, [](const geoslice::WindowRect&, const void*) {}), std::invalid_argument);
+}
+
+TEST(AlignedBufferPoolTest, LeasesAlignedBuffers) {
+    geoslice::AlignedBufferPool pool(8192, 3);
+    {
+        const auto lease = pool.acquire(2);
+        EXPECT_EQ(pool.available(), 1u);
+        for (size_t i = 0; i < lease.size(); i++) {
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(lease[i]) % geoslice::DIRECT_IO_ALIGNMENT, 0u);
+        }
+        EXPECT_NE(lease[0], lease[1]);
+    }
+    EXPECT_EQ(pool.available(), 3u);
+    EXPECT_THROW(pool.acquire(4), std::invalid_argument);
+    EXPECT_THROW(geoslice::AlignedBufferPool(1000, 1), std::invalid_argument);
+}
+
+TEST_F(FileReaderTest, OverlappingBatchReadsEachByteOnce) {
+    geoslice::MMapReader mmap_reader(base);
+    geoslice::FileReader reader(base, geoslice::make_pread_backend(2));
+
+    // Survey grid with 60% overlap, plus an exact duplicate
+    std::vector<geoslice::WindowRect> windows;
+    for (int y = 0; y + 50 <= H; y += 20)
+        for (int x = 0; x + 50 <= W; x += 20) windows.push_back({x, y, 50, 50});
+    windows.push_back(windows.front());
+
+    std::vector<std::vector<uint16_t>> bufs;
+    std::vector<void*> outs;
+    for (const auto& w : windows) bufs.emplace_back(B * w.width * w.height);
+    for (auto& buf : bufs) outs.push_back(buf.data());
+    reader.read_windows(windows, outs);
+
+    for (size_t i = 0; i < windows.size(); i++) {
+        const auto& w = windows[i];
+        std::vector<uint16_t> expected(B * w.width * w.height);
+        mmap_reader.read_window(w.x, w.y, w.width, w.height, expected.data());
+        ASSERT_EQ(bufs[i], expected) << i;
+    }
+
+    // The windows cover columns [0, 290) of rows [0, 190) of every band
+    EXPECT_EQ(reader.bytes_read(), uint64_t(B) * 190 * 290 * sizeof(uint16_t));
+}
+
+TEST_F(FileReaderTest, AbuttingRequestsAreReadOnce) {
+    geoslice::MMapReader mmap_reader(base);
+    auto counting = std::make_shared<CountingBackend>();
+    geoslice::FileReader reader(base, counting);
+
+    // Two windows side by side: each band row of the pair is one read
+    const std::vector<geoslice::WindowRect> windows = {{0, 0, 50, 10}, {50, 0, 50, 10}};
+    std::vector<std::vector<uint16_t>> bufs;
+    std::vector<void*> outs;
+    for (const auto& w : windows) bufs.emplace_back(B * w.width * w.height);
+    for (auto& buf : bufs) outs.push_back(buf.data());
+    reader.read_windows(windows, outs);
+
+    for (size_t i = 0; i < windows.size(); i++) {
+        const auto& w = windows[i];
+        std::vector<uint16_t> expected(B * w.width * w.height);
+        mmap_reader.read_window(w.x, w.y, w.width, w.height, expected.data());
+        ASSERT_EQ(bufs[i], expected) << i;
+    }
+    EXPECT_EQ(counting->lengths, std::vector<size_t>(B * 10, 100 * sizeof(uint16_t)));
+    EXPECT_EQ(reader.bytes_read(), uint64_t(B) * 10 * 100 * sizeof(uint16_t));
+
+    // Full-width rows meet end to end: the whole raster is a single read
+    counting->lengths.clear();
+    std::vector<uint16_t> expected(B * W * H), got(B * W * H);
+    mmap_reader.read_window(0, 0, W, H, expected.data());
+    reader.read_window(0, 0, W, H, got.data());
+    EXPECT_EQ(got, expected);
+    EXPECT_EQ(counting->lengths, std::vector<size_t>(1, size_t(B) * W * H * sizeof(uint16_t)));
+}
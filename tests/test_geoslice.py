@@ -1,14 +1,16 @@
 """Unit tests for geoslice."""
 
+import asyncio
 import json
 import os
+import struct
 import tempfile
 from pathlib import Path
 
 import numpy as np
 import pytest
 
-from geoslice import FastGeoMap, GeoTransform, DroneState, FlightPath
+from geoslice import FastGeoMap, GeoTransform, DroneState, FlightPath, HAS_CPP_BACKEND
 
 
 @pytest.fixture
@@ -51,6 +53,7 @@ class TestFastGeoMap:
         assert loader.meta.dtype == "uint8"
         assert loader.meta.crs == "EPSG:32636"
         assert len(loader.meta.transform) == 6
+        assert loader.meta.nodata is None
 
     def test_get_window(self, test_data_dir):
         loader = FastGeoMap(test_data_dir, use_cpp=False)
@@ -97,6 +100,55 @@ class TestFastGeoMap:
         with pytest.raises(FileNotFoundError):
             FastGeoMap("/nonexistent/path", use_cpp=False)
 
+    def test_binary_header(self, tmp_path):
+        base = tmp_path / "with_header"
+        header = struct.pack(
+            "<4sHBBIIIIQ6dd168s", b"GSRH", 1, 2, 0, 2, 4, 5, 1, 4096,
+            0.5, 0.0, 100.0, 0.0, -0.5, 200.0, 7.0, b"EPSG:4326",
+        )
+        data = np.arange(2 * 4 * 5, dtype=np.uint16).reshape(2, 4, 5)
+        with open(f"{base}.bin", "wb") as f:
+            f.write(header.ljust(4096, b"\0"))
+            f.write(data.tobytes())
+
+        loader = FastGeoMap(base, use_cpp=False)  # no .json needed
+
+        assert loader.meta.dtype == "uint16"
+        assert loader.meta.crs == "EPSG:4326"
+        assert loader.meta.nodata == 7.0
+        assert loader.meta.transform[2] == 100.0
+        np.testing.assert_array_equal(loader.get_window(0, 0, 5, 4), data)
+
+
+class TestAsyncWindows:
+    @pytest.mark.parametrize("use_cpp", [
+        False,
+        pytest.param(True, marks=pytest.mark.skipif(not HAS_CPP_BACKEND, reason="C++ extension not built")),
+    ])
+    def test_concurrent_requests(self, test_data_dir, use_cpp):
+        loader = FastGeoMap(test_data_dir, use_cpp=use_cpp)
+        windows = [(i * 10, i * 5, 30, 20) for i in range(8)]
+
+        async def main():
+            # Many batches in flight at once on one loop
+            batches = await asyncio.gather(*(loader.get_windows_async(windows) for _ in range(4)))
+            single = await loader.get_window_copy_async(5, 5, 10, 10)
+            return batches, single
+
+        batches, single = asyncio.run(main())
+        for arrays in batches:
+            assert len(arrays) == len(windows)
+            for (x, y, w, h), array in zip(windows, arrays):
+                np.testing.assert_array_equal(array, loader.get_window(x, y, w, h))
+        np.testing.assert_array_equal(single, loader.get_window(5, 5, 10, 10))
+
+    @pytest.mark.skipif(not HAS_CPP_BACKEND, reason="C++ extension not built")
+    def test_invalid_window_raises(self, test_data_dir):
+        loader = FastGeoMap(test_data_dir, use_cpp=True)
+
+        with pytest.raises(IndexError):
+            asyncio.run(loader.get_windows_async([(190, 0, 20, 20)]))
+
 
 class TestGeoTransform:
     @pytest.fixture
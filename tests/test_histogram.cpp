@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include "geoslice/histogram.hpp"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+namespace {
+void write_raster(const std::string& base, const char* dtype, int bands, int height, int width,
+                  const void* data, size_t bytes) {
+    std::ofstream json(base + ".json");
+    json << "{\"dtype\": \"" << dtype << "\", \"count\": " << bands
+         << ", \"height\": " << height << ", \"width\": " << width
+         << ", \"transform\": [1.0, 0.0, 0.0, 0.0, -1.0, 0.0], \"crs\": \"EPSG:32636\"}";
+    json.close();
+    std::ofstream bin(base + ".bin", std::ios::binary);
+    bin.write(static_cast<const char*>(data), bytes);
+}
+}
+
+class HistogramTest : public ::testing::Test {
+protected:
+    std::string u8_base = "/tmp/test_geoslice_hist_u8";
+    std::string u16_base = "/tmp/test_geoslice_hist_u16";
+
+    void SetUp() override {
+        // uint8: 2 bands of 64x64, band 0 = (x + y) % 256, band 1 = 5
+        std::vector<uint8_t> u8(2 * 64 * 64);
+        for (int y = 0; y < 64; y++)
+            for (int x = 0; x < 64; x++) {
+                u8[y * 64 + x] = static_cast<uint8_t>((x + y) % 256);
+                u8[64 * 64 + y * 64 + x] = 5;
+            }
+        write_raster(u8_base, "uint8", 2, 64, 64, u8.data(), u8.size());
+
+        // uint16: 1 band of 100x10, values 1000..1999 row-major
+        std::vector<uint16_t> u16(100 * 10);
+        std::iota(u16.begin(), u16.end(), uint16_t{1000});
+        write_raster(u16_base, "uint16", 1, 10, 100, u16.data(), u16.size() * 2);
+    }
+
+    void TearDown() override {
+        for (const auto& base : {u8_base, u16_base}) {
+            std::remove((base + ".json").c_str());
+            std::remove((base + ".bin").c_str());
+        }
+    }
+};
+
+TEST_F(HistogramTest, Uint8DirectBins) {
+    geoslice::MMapReader reader(u8_base);
+    auto hist = geoslice::window_histogram(reader.get_window(0, 0, 64, 64));
+
+    ASSERT_EQ(hist.size(), 2u);
+    ASSERT_EQ(hist[0].counts.size(), 256u);
+    EXPECT_DOUBLE_EQ(hist[0].min, 0.0);
+    EXPECT_DOUBLE_EQ(hist[0].max, 255.0);
+    EXPECT_EQ(hist[0].counts[0], 1u);    // only (0, 0)
+    EXPECT_EQ(hist[0].counts[63], 64u);  // the anti-diagonal
+    EXPECT_EQ(hist[1].counts[5], 64u * 64u);
+    EXPECT_EQ(std::accumulate(hist[0].counts.begin(), hist[0].counts.end(), uint64_t{0}), 64u * 64u);
+}
+
+TEST_F(HistogramTest, Uint8NodataExcluded) {
+    geoslice::MMapReader reader(u8_base);
+    geoslice::HistogramOptions options;
+    options.nodata = 5.0;
+
+    auto hist = geoslice::window_histogram(reader.get_window(0, 0, 64, 64), options);
+
+    EXPECT_EQ(hist[1].counts[5], 0u);
+    EXPECT_EQ(hist[0].counts[5], 0u);
+    EXPECT_EQ(hist[0].counts[6], 7u);
+}
+
+TEST_F(HistogramTest, Uint16DataRange) {
+    geoslice::MMapReader reader(u16_base);
+    geoslice::HistogramOptions options;
+    options.bins = 10;
+
+    auto hist = geoslice::window_histogram(reader.get_window(0, 0, 100, 10), options);
+
+    EXPECT_DOUBLE_EQ(hist[0].min, 1000.0);
+    EXPECT_DOUBLE_EQ(hist[0].max, 1999.0);
+    // Ten 99.9-wide bins, last edge inclusive: 100 values each
+    for (int i = 0; i < 10; i++) EXPECT_EQ(hist[0].counts[i], 100u) << "bin " << i;
+}
+
+TEST_F(HistogramTest, ExplicitRangeDropsOutliers) {
+    geoslice::MMapReader reader(u16_base);
+    geoslice::HistogramOptions options;
+    options.bins = 4;
+    options.min = 1000.0;
+    options.max = 1099.0;
+
+    auto hist = geoslice::window_histogram(reader.get_window(0, 0, 100, 10), options);
+
+    EXPECT_EQ(std::accumulate(hist[0].counts.begin(), hist[0].counts.end(), uint64_t{0}), 100u);
+}
+
+TEST_F(HistogramTest, Uint8PartialRange) {
+    geoslice::MMapReader reader(u8_base);
+    auto total = [](const geoslice::BandHistogram& h) {
+        return std::accumulate(h.counts.begin(), h.counts.end(), uint64_t{0});
+    };
+
+    geoslice::HistogramOptions options;
+    options.min = 10.0;
+    auto hist = geoslice::window_histogram(reader.get_window(0, 0, 64, 64), options);
+    EXPECT_DOUBLE_EQ(hist[0].min, 10.0);
+    EXPECT_DOUBLE_EQ(hist[0].max, 255.0);
+    EXPECT_EQ(total(hist[0]), 64u * 64u - 55u);  // x + y < 10 at 55 pixels
+
+    options.min.reset();
+    options.max = 4.0;
+    hist = geoslice::window_histogram(reader.get_window(0, 0, 64, 64), options);
+    EXPECT_DOUBLE_EQ(hist[1].min, 0.0);
+    EXPECT_DOUBLE_EQ(hist[1].max, 4.0);
+    EXPECT_EQ(total(hist[1]), 0u);  // every pixel is 5
+}
+
+TEST_F(HistogramTest, ParallelMatchesSerial) {
+    geoslice::MMapReader reader(u16_base);
+    geoslice::HistogramOptions options;
+    options.bins = 37;
+    options.nodata = 1500.0;
+
+    auto view = reader.get_window(3, 1, 90, 9);
+    auto serial = geoslice::window_histogram(view, options);
+    auto parallel = geoslice::window_histogram_parallel(view, options, 4);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    EXPECT_EQ(serial[0].counts, parallel[0].counts);
+    EXPECT_DOUBLE_EQ(serial[0].min, parallel[0].min);
+}
+
+TEST_F(HistogramTest, RejectsBadOptions) {
+    geoslice::MMapReader reader(u8_base);
+    geoslice::HistogramOptions options;
+    options.bins = 0;
+
+    EXPECT_THROW(geoslice::window_histogram(reader.get_window(0, 0, 8, 8), options),
+                 std::invalid_argument);
+
+    options.bins = 16;
+    options.min = 0.0;
+    options.max = INFINITY;
+    EXPECT_THROW(geoslice::window_histogram(reader.get_window(0, 0, 8, 8), options),
+                 std::invalid_argument);
+    options.min = std::nan("");
+    options.max = 10.0;
+    EXPECT_THROW(geoslice::window_histogram(reader.get_window(0, 0, 8, 8), options),
+                 std::invalid_argument);
+}
+
+TEST(HistogramFloat, NaNPixelsAreNotCounted) {
+    std::vector<float> pixels(9 * 4);
+    std::iota(pixels.begin(), pixels.end(), 0.0f);
+    pixels[0] = std::nanf("");
+    pixels[35] = std::nanf("");
+    geoslice::WindowView view{reinterpret_cast<const uint8_t*>(pixels.data()), 1, 4, 9,
+                              pixels.size() * sizeof(float), 9 * sizeof(float), sizeof(float),
+                              geoslice::DType::Float32};
+    geoslice::HistogramOptions options;
+    options.bins = 4;
+
+    auto hist = geoslice::window_histogram(view, options);
+    EXPECT_DOUBLE_EQ(hist[0].min, 1.0);
+    EXPECT_DOUBLE_EQ(hist[0].max, 34.0);
+    EXPECT_EQ(std::accumulate(hist[0].counts.begin(), hist[0].counts.end(), uint64_t{0}), 34u);
+}
+
+TEST(HistogramFloat, InfinitePixelsStayOutOfTheRange) {
+    std::vector<float> pixels(9 * 4);
+    std::iota(pixels.begin(), pixels.end(), 0.0f);
+    pixels[0] = INFINITY;
+    pixels[35] = -INFINITY;
+    geoslice::WindowView view{reinterpret_cast<const uint8_t*>(pixels.data()), 1, 4, 9,
+                              pixels.size() * sizeof(float), 9 * sizeof(float), sizeof(float),
+                              geoslice::DType::Float32};
+    geoslice::HistogramOptions options;
+    options.bins = 4;
+
+    auto hist = geoslice::window_histogram(view, options);
+    EXPECT_DOUBLE_EQ(hist[0].min, 1.0);
+    EXPECT_DOUBLE_EQ(hist[0].max, 34.0);
+    EXPECT_EQ(std::accumulate(hist[0].counts.begin(), hist[0].counts.end(), uint64_t{0}), 34u);
+}
+
+TEST(HistogramFloat, SubnormalRangeWidth) {
+    // bins / (max - min) overflows to inf for this range
+    const double tiny = std::numeric_limits<double>::denorm_min();
+    std::vector<double> pixels = {0.0, tiny, 2 * tiny, 4 * tiny, 1.0, -1.0};
+    geoslice::WindowView view{reinterpret_cast<const uint8_t*>(pixels.data()), 1, 1, 6,
+                              pixels.size() * sizeof(double), 6 * sizeof(double), sizeof(double),
+                              geoslice::DType::Float64};
+    geoslice::HistogramOptions options;
+    options.bins = 4;
+    options.min = 0.0;
+    options.max = 4 * tiny;
+
+    auto hist = geoslice::window_histogram(view, options);
+    EXPECT_EQ(hist[0].counts, (std::vector<uint64_t>{1, 1, 1, 1}));
+}
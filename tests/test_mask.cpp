@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "geoslice/mmap_reader.hpp"
+#include <cstdio>
+#include <fstream>
+
+class NodataMaskTest : public ::testing::Test {
+protected:
+    std::string test_base = "/tmp/test_geoslice_mask";
+    static constexpr int W = 600;
+    static constexpr int H = 300;
+    std::vector<uint8_t> data;
+
+    // 2 bands, nodata 0. Columns < 256 are nodata in both bands, (400, 100)
+    // is nodata in both bands, (500, 10) only in band 0 (so still valid).
+    void SetUp() override {
+        write_json("0");
+        data.assign(2 * H * W, 0);
+        for (int b = 0; b < 2; b++)
+            for (int y = 0; y < H; y++)
+                for (int x = 256; x < W; x++) data[(b * H + y) * W + x] = 1 + x % 200;
+        data[(0 * H + 100) * W + 400] = 0;
+        data[(1 * H + 100) * W + 400] = 0;
+        data[(0 * H + 10) * W + 500] = 0;
+        write_bin();
+    }
+
+    void TearDown() override {
+        std::remove((test_base + ".json").c_str());
+        std::remove((test_base + ".bin").c_str());
+        std::remove((test_base + ".mask").c_str());
+    }
+
+    void write_json(const char* nodata) {
+        std::ofstream json(test_base + ".json");
+        json << R"({"dtype": "uint8", "count": 2, "height": 300, "width": 600,)"
+             << R"( "transform": [1.0, 0.0, 0.0, 0.0, -1.0, 300.0], "crs": "EPSG:32636",)"
+             << R"( "nodata": )" << nodata << "}";
+    }
+
+    void write_bin() {
+        std::ofstream bin(test_base + ".bin", std::ios::binary);
+        bin.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+};
+
+TEST_F(NodataMaskTest, ParsesNodata) {
+    geoslice::MMapReader reader(test_base);
+    ASSERT_TRUE(reader.metadata().nodata.has_value());
+    EXPECT_DOUBLE_EQ(*reader.metadata().nodata, 0.0);
+
+    write_json("null");
+    geoslice::MMapReader no_nodata(test_base);
+    EXPECT_FALSE(no_nodata.metadata().nodata.has_value());
+}
+
+TEST_F(NodataMaskTest, BuildsFromNodata) {
+    geoslice::MMapReader reader(test_base);
+    auto mask = geoslice::NodataMask::from_nodata(reader);
+
+    EXPECT_FALSE(mask.valid(10, 10));
+    EXPECT_FALSE(mask.valid(400, 100));
+    EXPECT_TRUE(mask.valid(500, 10));
+    EXPECT_TRUE(mask.valid(599, 299));
+}
+
+TEST_F(NodataMaskTest, TileSummary) {
+    geoslice::MMapReader reader(test_base);
+    auto mask = geoslice::NodataMask::from_nodata(reader);
+
+    ASSERT_EQ(mask.tiles_x(), 3);
+    ASSERT_EQ(mask.tiles_y(), 2);
+    EXPECT_EQ(mask.tile(0, 0), geoslice::Coverage::Empty);
+    EXPECT_EQ(mask.tile(0, 1), geoslice::Coverage::Empty);
+    EXPECT_EQ(mask.tile(1, 0), geoslice::Coverage::Partial);
+    EXPECT_EQ(mask.tile(2, 0), geoslice::Coverage::Full);
+    EXPECT_EQ(mask.tile(1, 1), geoslice::Coverage::Full);
+}
+
+TEST_F(NodataMaskTest, CoverageRefinesPartialTiles) {
+    geoslice::MMapReader reader(test_base);
+    auto mask = geoslice::NodataMask::from_nodata(reader);
+
+    EXPECT_EQ(mask.coverage(300, 0, 50, 50), geoslice::Coverage::Full);
+    EXPECT_EQ(mask.coverage(390, 95, 20, 20), geoslice::Coverage::Partial);
+    EXPECT_EQ(mask.coverage(0, 0, 256, 300), geoslice::Coverage::Empty);
+    EXPECT_EQ(mask.coverage(200, 0, 100, 10), geoslice::Coverage::Partial);
+}
+
+TEST_F(NodataMaskTest, NoSidecarIsPartial) {
+    geoslice::MMapReader reader(test_base);
+
+    EXPECT_FALSE(reader.has_mask());
+    EXPECT_EQ(reader.coverage(0, 0, 10, 10), geoslice::Coverage::Partial);
+}
+
+TEST_F(NodataMaskTest, SidecarLoadedByReader) {
+    {
+        geoslice::MMapReader reader(test_base);
+        geoslice::NodataMask::from_nodata(reader).save(test_base + ".mask");
+    }
+    geoslice::MMapReader reader(test_base);
+
+    ASSERT_TRUE(reader.has_mask());
+    EXPECT_EQ(reader.coverage(0, 0, 100, 100), geoslice::Coverage::Empty);
+    EXPECT_EQ(reader.coverage(300, 150, 100, 100), geoslice::Coverage::Full);
+    EXPECT_FALSE(reader.mask()->valid(400, 100));
+}
+
+TEST_F(NodataMaskTest, ReadWindowSkipsEmptyRegions) {
+    {
+        geoslice::MMapReader reader(test_base);
+        geoslice::NodataMask::from_nodata(reader).save(test_base + ".mask");
+    }
+    // Scribble over the nodata area: an empty window must not read it
+    for (int y = 0; y < 10; y++) data[y * W] = 99;
+    write_bin();
+
+    geoslice::MMapReader reader(test_base);
+    std::vector<uint8_t> out(2 * 10 * 10, 42);
+    reader.read_window(0, 0, 10, 10, out.data());
+
+    for (uint8_t v : out) EXPECT_EQ(v, 0);
+}
+
+TEST_F(NodataMaskTest, ReadWindowCopiesData) {
+    geoslice::MMapReader reader(test_base);
+    std::vector<uint8_t> out(2 * 4 * 8);
+    reader.read_window(300, 5, 8, 4, out.data());
+
+    auto view = reader.get_window(300, 5, 8, 4);
+    for (int b = 0; b < 2; b++)
+        for (int y = 0; y < 4; y++)
+            for (int x = 0; x < 8; x++)
+                EXPECT_EQ(out[(b * 4 + y) * 8 + x], view.at<uint8_t>(b, y, x));
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "geoslice/metrics.hpp"
+#include "geoslice/mmap_reader.hpp"
+#include "geoslice/window_cache.hpp"
+#include <cstdio>
+#include <fstream>
+
+using geoslice::LatencyHistogram;
+
+TEST(MetricsTest, HistogramBucketsBoundValues) {
+    size_t previous = 0;
+    for (uint64_t v = 0; v < (uint64_t(1) << 40); v = v * 5 / 4 + 1) {
+        const size_t b = LatencyHistogram::bucket(v);
+        ASSERT_LT(b, LatencyHistogram::BUCKETS);
+        ASSERT_GE(b, previous) << v;
+        const uint64_t upper = LatencyHistogram::bucket_upper(b);
+        ASSERT_GE(upper, v);
+        ASSERT_LE(upper, v + v / 8) << v;  // within 12.5%
+        previous = b;
+    }
+    EXPECT_EQ(LatencyHistogram::bucket(~uint64_t(0)), LatencyHistogram::BUCKETS - 1);
+    EXPECT_EQ(LatencyHistogram::bucket_upper(LatencyHistogram::BUCKETS - 1), ~uint64_t(0));
+}
+
+TEST(MetricsTest, SnapshotSummarizesLatencies) {
+    geoslice::reset_metrics();
+    for (uint64_t us = 1; us <= 1000; us++) geoslice::record_latency(geoslice::Op::TileDecode, us * 1000);
+    const auto snapshot = geoslice::metrics_snapshot();
+    const auto& l = snapshot.latency(geoslice::Op::TileDecode);
+    EXPECT_EQ(l.count, 1000u);
+    EXPECT_NEAR(l.mean_ns, 500500.0, 1.0);
+    EXPECT_NEAR(static_cast<double>(l.p50_ns), 500000.0, 500000.0 * 0.125);
+    EXPECT_NEAR(static_cast<double>(l.p99_ns), 990000.0, 990000.0 * 0.125);
+    EXPECT_EQ(l.max_ns, 1000000u);
+    EXPECT_LE(l.p999_ns, l.max_ns);
+    EXPECT_EQ(snapshot.latency(geoslice::Op::GetWindow).count, 0u);
+
+    geoslice::reset_metrics();
+    EXPECT_EQ(geoslice::metrics_snapshot().latency(geoslice::Op::TileDecode).count, 0u);
+    EXPECT_STREQ(geoslice::op_name(geoslice::Op::TileDecode), "tile_decode");
+    EXPECT_STREQ(geoslice::counter_name(geoslice::Counter::PrefetchIssued), "prefetch_issued");
+}
+
+TEST(MetricsTest, ReaderOperationsAreRecordedWhenEnabled) {
+    const std::string base = "/tmp/test_geoslice_metrics";
+    {
+        std::ofstream json(base + ".json");
+        json << R"({"dtype": "uint8", "count": 1, "height": 64, "width": 64,)"
+             << R"( "transform": [1.0, 0.0, 0.0, 0.0, -1.0, 64.0], "crs": "EPSG:32636"})";
+        std::ofstream bin(base + ".bin", std::ios::binary);
+        bin << std::string(64 * 64, '\x05');
+    }
+
+    geoslice::reset_metrics();
+    {
+        geoslice::MMapReader reader(base);
+        std::vector<uint8_t> out(16 * 16);
+        reader.get_window(0, 0, 16, 16);
+        reader.read_window(8, 8, 16, 16, out.data());
+        reader.prefetch(0, 0, 64, 64);
+
+        geoslice::WindowCache cache(out.size());
+        cache.get(0, 0, 16, 16);
+        cache.put(0, 0, 16, 16, out.data(), out.size());
+        cache.put(8, 8, 16, 16, out.data(), out.size());  // evicts the first
+        cache.get(8, 8, 16, 16);
+    }
+    std::remove((base + ".json").c_str());
+    std::remove((base + ".bin").c_str());
+
+    const auto s = geoslice::metrics_snapshot();
+    EXPECT_EQ(s.enabled, geoslice::metrics_enabled());
+    const uint64_t on = s.enabled ? 1 : 0;
+    EXPECT_EQ(s.counter(geoslice::Counter::WindowViews), on);
+    EXPECT_EQ(s.counter(geoslice::Counter::WindowCopies), on);
+    EXPECT_EQ(s.counter(geoslice::Counter::BytesCopied), on * 16 * 16);
+    EXPECT_EQ(s.counter(geoslice::Counter::PrefetchIssued), on);
+    EXPECT_EQ(s.counter(geoslice::Counter::WindowCacheHits), on);
+    EXPECT_EQ(s.counter(geoslice::Counter::WindowCacheMisses), on);
+    EXPECT_EQ(s.counter(geoslice::Counter::WindowCacheEvictions), on);
+    EXPECT_EQ(s.latency(geoslice::Op::GetWindow).count, on);
+    EXPECT_EQ(s.latency(geoslice::Op::ReadWindow).count, on);
+}
@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 #include "geoslice/mmap_reader.hpp"
+#include "geoslice/raster_header.hpp"
+#include <cstring>
 #include <fstream>
 #include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
 
 class MMapReaderTest : public ::testing::Test {
 protected:
@@ -42,7 +46,7 @@ TEST_F(MMapReaderTest, LoadsMetadata) {
     EXPECT_EQ(reader.width(), 200);
     EXPECT_EQ(reader.height(), 100);
     EXPECT_EQ(reader.bands(), 3);
-    EXPECT_EQ(reader.metadata().dtype, "uint8");
+    EXPECT_STREQ(reader.metadata().dtype(), "uint8");
     EXPECT_EQ(reader.metadata().crs, "EPSG:32636");
 }
 
@@ -85,6 +89,95 @@ TEST_F(MMapReaderTest, ThrowsOnInvalidWindow) {
     EXPECT_THROW(reader.get_window(195, 0, 10, 10), std::out_of_range);
 }
 
+TEST_F(MMapReaderTest, PrefetchAdvisesWindowPages) {
+    geoslice::MMapReader reader(test_base);
+    EXPECT_TRUE(reader.prefetch(10, 10, 50, 20));
+    EXPECT_TRUE(reader.prefetch(0, 0, 200, 100));
+    EXPECT_THROW(reader.prefetch(195, 0, 10, 10), std::out_of_range);
+
+    geoslice::ReaderOptions options;
+    options.chunk_bytes = 1000;
+    EXPECT_FALSE(geoslice::MMapReader(test_base, options).prefetch(0, 0, 10, 10));
+}
+
+TEST_F(MMapReaderTest, ResidencyFollowsPageCache) {
+    // Large enough that opening (which faults in the first pages) leaves
+    // most of the file unmapped
+    const std::string base = "/tmp/test_geoslice_residency";
+    {
+        std::ofstream json(base + ".json");
+        json << R"({"dtype": "uint8", "count": 1, "height": 1024, "width": 1024,)"
+             << R"( "transform": [1.0, 0.0, 0.0, 0.0, -1.0, 1024.0], "crs": "EPSG:32636"})";
+        std::ofstream bin(base + ".bin", std::ios::binary);
+        bin << std::string(1024 * 1024, '\x01');
+    }
+    const auto evict = [&] {
+        const int fd = open((base + ".bin").c_str(), O_RDONLY);
+        ASSERT_GE(fd, 0);
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);  // drops every page not mapped
+        close(fd);
+    };
+    // Before opening (pages of the fresh write are not dropped once any of
+    // them is mapped) and after (opening reads the header and readahead
+    // brings in more)
+    evict();
+    geoslice::MMapReader reader(base);
+    evict();
+
+    const auto cold = reader.residency_map(256);
+    EXPECT_EQ(cold.tiles_x, 4);
+    EXPECT_EQ(cold.tiles_y, 4);
+    EXPECT_EQ(cold.resident_tiles(), 0u);
+    EXPECT_LT(reader.residency(0, 512, 1024, 512), 0.5);
+
+    std::vector<uint8_t> out(1024 * 256);
+    reader.read_window(0, 768, 1024, 256, out.data());
+    EXPECT_DOUBLE_EQ(reader.residency(0, 768, 1024, 256), 1.0);
+    EXPECT_DOUBLE_EQ(reader.residency(900, 1000, 50, 24), 1.0);
+    const auto warm = reader.residency_map(256);
+    EXPECT_EQ(warm.resident_tiles(), 4u);
+    EXPECT_TRUE(warm.resident(3, 3));
+    EXPECT_FALSE(warm.resident(3, 1));
+
+    EXPECT_THROW(reader.residency(1000, 0, 100, 10), std::out_of_range);
+    std::remove((base + ".json").c_str());
+    std::remove((base + ".bin").c_str());
+
+    geoslice::ReaderOptions options;
+    options.chunk_bytes = 1000;
+    EXPECT_THROW(geoslice::MMapReader(test_base, options).residency(0, 0, 10, 10), std::logic_error);
+}
+
+TEST_F(MMapReaderTest, ReadWindowAsyncMatchesReadWindow) {
+    geoslice::MMapReader reader(test_base);
+    std::vector<std::vector<uint8_t>> outs(8, std::vector<uint8_t>(3 * 20 * 30));
+    std::vector<std::future<void>> reads;
+    for (int i = 0; i < 8; i++) {
+        reads.push_back(reader.read_window_async(i * 20, i * 10, 30, 20, outs[i].data()));
+    }
+
+    std::vector<uint8_t> expected(3 * 20 * 30);
+    for (int i = 0; i < 8; i++) {
+        reads[i].get();
+        reader.read_window(i * 20, i * 10, 30, 20, expected.data());
+        EXPECT_EQ(outs[i], expected);
+    }
+}
+
+TEST_F(MMapReaderTest, ReadWindowAsyncCallback) {
+    geoslice::MMapReader reader(test_base);
+    std::vector<uint8_t> out(3 * 4 * 4);
+    std::promise<std::exception_ptr> completed;
+    reader.read_window_async(10, 10, 4, 4, out.data(),
+                             [&](std::exception_ptr error) { completed.set_value(error); });
+
+    EXPECT_EQ(completed.get_future().get(), nullptr);
+    EXPECT_EQ(out[0], static_cast<uint8_t>((10 * 200 + 10) % 256));
+    // Bad windows are rejected before anything is queued
+    EXPECT_THROW(reader.read_window_async(195, 0, 10, 10, out.data()), std::out_of_range);
+}
+
 TEST_F(MMapReaderTest, MoveConstruction) {
     geoslice::MMapReader reader1(test_base);
     geoslice::MMapReader reader2(std::move(reader1));
@@ -93,3 +186,223 @@ TEST_F(MMapReaderTest, MoveConstruction) {
     auto view = reader2.get_window(0, 0, 10, 10);
     EXPECT_NE(view.data, nullptr);
 }
+
+TEST_F(MMapReaderTest, ParsesDTypeOnce) {
+    geoslice::MMapReader reader(test_base);
+
+    EXPECT_EQ(reader.metadata().dtype_id, geoslice::DType::UInt8);
+    EXPECT_EQ(reader.metadata().pixel_size(), 1u);
+    EXPECT_EQ(reader.get_window(0, 0, 10, 10).dtype, geoslice::DType::UInt8);
+}
+
+TEST_F(MMapReaderTest, RowPointerMatchesAt) {
+    geoslice::MMapReader reader(test_base);
+
+    auto view = reader.get_window(5, 7, 20, 10);
+    const uint8_t* row = view.row<uint8_t>(2, 3);
+
+    for (int x = 0; x < view.width; x++) {
+        EXPECT_EQ(row[x], view.at<uint8_t>(2, 3, x));
+    }
+}
+
+TEST_F(MMapReaderTest, VisitWindowDispatchesTyped) {
+    geoslice::MMapReader reader(test_base);
+
+    auto view = reader.get_window(0, 0, 10, 10);
+    uint64_t expected = 0;
+    for (int b = 0; b < view.bands; b++)
+        for (int y = 0; y < view.height; y++)
+            for (int x = 0; x < view.width; x++)
+                expected += view.at<uint8_t>(b, y, x);
+
+    uint64_t sum = geoslice::visit_window(view, [](auto typed) {
+        using T = typename decltype(typed)::value_type;
+        static_assert(std::is_arithmetic_v<T>);
+        uint64_t total = 0;
+        for (int b = 0; b < typed.bands; b++) {
+            for (int y = 0; y < typed.height; y++) {
+                const T* row = typed.row(b, y);
+                for (int x = 0; x < typed.width; x++) total += static_cast<uint64_t>(row[x]);
+            }
+        }
+        return total;
+    });
+
+    EXPECT_EQ(sum, expected);
+}
+
+TEST(DTypeTest, ParseAndName) {
+    EXPECT_EQ(geoslice::parse_dtype("uint16"), geoslice::DType::UInt16);
+    EXPECT_EQ(geoslice::parse_dtype("float32"), geoslice::DType::Float32);
+    EXPECT_STREQ(geoslice::dtype_name(geoslice::DType::Int16), "int16");
+    EXPECT_EQ(geoslice::dtype_size(geoslice::DType::Float64), 8u);
+    EXPECT_THROW(geoslice::parse_dtype("complex64"), std::invalid_argument);
+}
+
+TEST_F(MMapReaderTest, JsonKeysInAnyOrderAndNullCrs) {
+    std::ofstream json(test_base + ".json");
+    json << R"({"crs": null, "transform": [2.5, 0, 10, 0, -2.5, 50], "width": 200,)"
+         << R"( "nodata": null, "count": 3, "height": 100, "dtype": "uint8"})";
+    json.close();
+
+    geoslice::MMapReader reader(test_base);
+    EXPECT_EQ(reader.width(), 200);
+    EXPECT_EQ(reader.bands(), 3);
+    EXPECT_TRUE(reader.metadata().crs.empty());
+    EXPECT_FALSE(reader.metadata().nodata.has_value());
+    EXPECT_DOUBLE_EQ(reader.metadata().transform[0], 2.5);
+    EXPECT_DOUBLE_EQ(reader.metadata().transform[5], 50.0);
+}
+
+TEST_F(MMapReaderTest, JsonRejectsShortDataAndBadDimensions) {
+    // .bin one byte shorter than the .json describes, mapped whole or chunked
+    {
+        std::vector<uint8_t> data(3 * 100 * 200 - 1);
+        std::ofstream bin(test_base + ".bin", std::ios::binary);
+        bin.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    geoslice::ReaderOptions chunked;
+    chunked.chunk_bytes = 1000;
+    EXPECT_THROW(geoslice::MMapReader{test_base}, std::runtime_error);
+    EXPECT_THROW((geoslice::MMapReader{test_base, chunked}), std::runtime_error);
+
+    for (const char* dims : {R"("count": 3, "width": 200)", R"("count": 3, "height": 0, "width": 200)",
+                             R"("count": -1, "height": 1, "width": 1)",
+                             R"("count": 3, "height": 100, "width": 1e12)",
+                             R"("count": 3, "height": NaN, "width": 200)",
+                             R"("count": 3, "height": -Infinity, "width": 200)",
+                             R"("count": 3, "height": 100.5, "width": 200)"}) {
+        std::ofstream json(test_base + ".json");
+        json << R"({"dtype": "uint8", )" << dims << "}";
+        json.close();
+        EXPECT_THROW(geoslice::MMapReader{test_base}, std::runtime_error) << dims;
+        EXPECT_THROW((geoslice::MMapReader{test_base, chunked}), std::runtime_error) << dims;
+    }
+}
+
+TEST_F(MMapReaderTest, BinaryHeaderReplacesJson) {
+    geoslice::GeoMetadata meta;
+    meta.dtype_id = geoslice::DType::UInt16;
+    meta.count = 2;
+    meta.height = 4;
+    meta.width = 5;
+    meta.transform = {0.5, 0.0, 100.0, 0.0, -0.5, 200.0};
+    meta.crs = "EPSG:4326";
+    meta.nodata = 7.0;
+
+    const auto header = geoslice::make_header(meta);
+    std::vector<uint8_t> file(geoslice::HEADER_DATA_OFFSET + meta.total_bytes());
+    std::memcpy(file.data(), &header, sizeof(header));
+    uint16_t* pixels = reinterpret_cast<uint16_t*>(file.data() + geoslice::HEADER_DATA_OFFSET);
+    for (int i = 0; i < 2 * 4 * 5; i++) pixels[i] = static_cast<uint16_t>(i * 3);
+
+    std::ofstream bin(test_base + ".bin", std::ios::binary);
+    bin.write(reinterpret_cast<const char*>(file.data()), file.size());
+    bin.close();
+    std::remove((test_base + ".json").c_str());  // the header is enough
+
+    geoslice::MMapReader reader(test_base);
+    EXPECT_EQ(reader.data_offset(), geoslice::HEADER_DATA_OFFSET);
+    EXPECT_STREQ(reader.metadata().dtype(), "uint16");
+    EXPECT_EQ(reader.bands(), 2);
+    EXPECT_EQ(reader.width(), 5);
+    EXPECT_EQ(reader.metadata().crs, "EPSG:4326");
+    EXPECT_DOUBLE_EQ(reader.metadata().transform[2], 100.0);
+    ASSERT_TRUE(reader.metadata().nodata.has_value());
+    EXPECT_DOUBLE_EQ(*reader.metadata().nodata, 7.0);
+    EXPECT_EQ(reader.get_window(2, 1, 2, 2).at<uint16_t>(1, 1, 1), (20 + 2 * 5 + 3) * 3);
+
+    // A header describing more data than the file holds is rejected
+    file.resize(file.size() - 1);
+    std::ofstream truncated(test_base + ".bin", std::ios::binary);
+    truncated.write(reinterpret_cast<const char*>(file.data()), file.size());
+    truncated.close();
+    EXPECT_THROW(geoslice::MMapReader{test_base}, std::runtime_error);
+}
+
+TEST_F(MMapReaderTest, BinaryHeaderRejectsHugeDimensions) {
+    geoslice::GeoMetadata meta;
+    meta.dtype_id = geoslice::DType::Float64;
+    meta.count = 1;
+    meta.height = 1;
+    meta.width = 1;
+    meta.transform = {1.0, 0.0, 0.0, 0.0, -1.0, 0.0};
+    std::vector<uint8_t> file(geoslice::HEADER_DATA_OFFSET + meta.total_bytes());
+
+    auto write = [&](uint32_t count, uint32_t height, uint32_t width) {
+        auto header = geoslice::make_header(meta);
+        header.count = count;
+        header.height = height;
+        header.width = width;
+        std::memcpy(file.data(), &header, sizeof(header));
+        std::ofstream bin(test_base + ".bin", std::ios::binary);
+        bin.write(reinterpret_cast<const char*>(file.data()), file.size());
+    };
+    std::remove((test_base + ".json").c_str());
+
+    write(1, 1, 0x80000000u);  // not an int
+    EXPECT_THROW(geoslice::MMapReader{test_base}, std::runtime_error);
+    write(0x7fffffffu, 0x7fffffffu, 0x7fffffffu);  // size overflows
+    EXPECT_THROW(geoslice::MMapReader{test_base}, std::runtime_error);
+    write(1, 1, 1);
+    EXPECT_EQ(geoslice::MMapReader{test_base}.width(), 1);
+}
+
+TEST_F(MMapReaderTest, ChunkedReadsSpanChunks) {
+    geoslice::MMapReader full(test_base);
+    geoslice::ReaderOptions options;
+    options.chunk_bytes = 1000;  // 5 rows of 200 bytes
+    options.max_chunks = 2;
+    geoslice::MMapReader chunked(test_base, options);
+
+    ASSERT_TRUE(chunked.chunked());
+    EXPECT_THROW(chunked.get_window(0, 0, 10, 10), std::logic_error);
+
+    const int x = 17, y = 3, w = 150, h = 23;  // rows 3..25 cross five chunks per band
+    std::vector<uint8_t> expected(3 * w * h), actual(3 * w * h);
+    full.read_window(x, y, w, h, expected.data());
+    chunked.read_window(x, y, w, h, actual.data());
+    EXPECT_EQ(actual, expected);
+    EXPECT_LE(chunked.mapped_chunks(), 2u);
+
+    size_t tiles = 0;
+    chunked.scan_tiles([&](const geoslice::WindowRect& tile, const geoslice::WindowView* view) {
+        ASSERT_NE(view, nullptr);
+        EXPECT_EQ(view->at<uint8_t>(2, 1, 1), full.get_window(tile.x, tile.y, 2, 2).at<uint8_t>(2, 1, 1));
+        tiles++;
+    });
+    EXPECT_EQ(tiles, 1u);
+}
+
+TEST_F(MMapReaderTest, ChunkedWithHeaderOffset) {
+    // Rows of 3 bytes: chunk offsets past the 4096-byte header are unaligned
+    geoslice::GeoMetadata meta;
+    meta.dtype_id = geoslice::DType::UInt8;
+    meta.count = 2;
+    meta.height = 2000;
+    meta.width = 3;
+    meta.transform = {1.0, 0.0, 0.0, 0.0, -1.0, 0.0};
+
+    const auto header = geoslice::make_header(meta);
+    std::vector<uint8_t> file(geoslice::HEADER_DATA_OFFSET + meta.total_bytes());
+    std::memcpy(file.data(), &header, sizeof(header));
+    for (size_t i = geoslice::HEADER_DATA_OFFSET; i < file.size(); i++) file[i] = static_cast<uint8_t>(i * 7);
+    std::ofstream bin(test_base + ".bin", std::ios::binary);
+    bin.write(reinterpret_cast<const char*>(file.data()), file.size());
+    bin.close();
+
+    geoslice::ReaderOptions options;
+    options.chunk_bytes = 1500;
+    geoslice::MMapReader reader(test_base, options);
+    ASSERT_TRUE(reader.chunked());
+
+    std::vector<uint8_t> out(2 * 3 * 1200);
+    reader.read_window(0, 400, 3, 1200, out.data());
+    for (int b = 0; b < 2; b++) {
+        for (int r = 0; r < 1200; r++) {
+            const size_t src = geoslice::HEADER_DATA_OFFSET + (static_cast<size_t>(b) * 2000 + 400 + r) * 3 + 2;
+            ASSERT_EQ(out[(b * 1200 + r) * 3 + 2], static_cast<uint8_t>(src * 7)) << b << "," << r;
+        }
+    }
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "geoslice/mosaic.hpp"
+#include <cstdio>
+#include <fstream>
+
+class MosaicTest : public ::testing::Test {
+protected:
+    std::string dir = "/tmp/test_geoslice_mosaic_";
+    std::vector<std::string> written;
+
+    // 2x2 catalog of 40x30 uint16 tiles with 2 m pixels, the bottom-right
+    // tile missing. Pixel value encodes the mosaic position: band * 10000 +
+    // row * 100 + col.
+    void SetUp() override {
+        for (int ty = 0; ty < 2; ty++) {
+            for (int tx = 0; tx < 2; tx++) {
+                if (tx == 1 && ty == 1) continue;
+                write_tile("t" + std::to_string(ty) + std::to_string(tx), tx * 40, ty * 30, 40, 30);
+            }
+        }
+    }
+
+    void TearDown() override {
+        for (const auto& base : written) {
+            std::remove((base + ".json").c_str());
+            std::remove((base + ".bin").c_str());
+        }
+    }
+
+    std::string write_tile(const std::string& name, int col, int row, int w, int h,
+                           const char* dtype = "uint16", double offset = 0.0, const char* nodata = "65535") {
+        const std::string base = dir + name;
+        std::ofstream json(base + ".json");
+        json << R"({"dtype": ")" << dtype << R"(", "count": 2, "height": )" << h << R"(, "width": )" << w
+             << R"(, "transform": [2.0, 0.0, )" << 1000.0 + col * 2.0 + offset << R"(, 0.0, -2.0, )"
+             << 5000.0 - row * 2.0 << R"(], "crs": "EPSG:32636", "nodata": )" << nodata << "}";
+        json.close();
+
+        std::vector<uint16_t> data(2 * w * h);
+        for (int b = 0; b < 2; b++)
+            for (int y = 0; y < h; y++)
+                for (int x = 0; x < w; x++)
+                    data[(b * h + y) * w + x] = static_cast<uint16_t>(b * 10000 + (row + y) * 100 + col + x);
+        std::ofstream bin(base + ".bin", std::ios::binary);
+        bin.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(uint16_t));
+
+        written.push_back(base);
+        return base;
+    }
+
+    std::vector<std::string> catalog() const { return written; }
+};
+
+TEST_F(MosaicTest, BuildsGridFromTransforms) {
+    geoslice::MosaicReader mosaic(catalog());
+
+    EXPECT_EQ(mosaic.num_sources(), 3u);
+    EXPECT_EQ(mosaic.width(), 80);
+    EXPECT_EQ(mosaic.height(), 60);
+    EXPECT_EQ(mosaic.bands(), 2);
+    EXPECT_DOUBLE_EQ(mosaic.metadata().transform[2], 1000.0);
+    EXPECT_DOUBLE_EQ(mosaic.metadata().transform[5], 5000.0);
+    EXPECT_EQ(mosaic.source_extent(1).x, 40);
+    EXPECT_EQ(mosaic.source_extent(2).y, 30);
+}
+
+TEST_F(MosaicTest, OpensSourcesLazily) {
+    geoslice::MosaicReader mosaic(catalog());
+    EXPECT_EQ(mosaic.open_sources(), 0u);
+
+    std::vector<uint16_t> out(2 * 10 * 10);
+    mosaic.read_window(5, 5, 10, 10, out.data());
+    EXPECT_EQ(mosaic.open_sources(), 1u);
+    EXPECT_EQ(out[0], 5 * 100 + 5);
+    EXPECT_EQ(out[100 + 9 * 10 + 9], 10000 + 14 * 100 + 14);
+}
+
+TEST_F(MosaicTest, StitchesAcrossBoundaries) {
+    geoslice::MosaicReader mosaic(catalog());
+    const int x = 30, y = 20, w = 30, h = 25;
+    EXPECT_EQ(mosaic.sources_in(x, y, w, h), (std::vector<size_t>{0, 1, 2}));
+
+    std::vector<uint16_t> out(2 * w * h);
+    mosaic.read_window(x, y, w, h, out.data());
+
+    for (int b = 0; b < 2; b++) {
+        for (int r = 0; r < h; r++) {
+            for (int c = 0; c < w; c++) {
+                const int mx = x + c, my = y + r;
+                const bool missing = mx >= 40 && my >= 30;
+                const uint16_t expected = missing ? 65535 : static_cast<uint16_t>(b * 10000 + my * 100 + mx);
+                ASSERT_EQ(out[(b * h + r) * w + c], expected) << b << "," << my << "," << mx;
+            }
+        }
+    }
+}
+
+TEST_F(MosaicTest, StitchesChunkedSources) {
+    // Chunked readers have no zero-copy views: the stitch copies through them
+    geoslice::ReaderOptions chunked;
+    chunked.chunk_bytes = 800;  // 10 rows of 40 uint16 pixels
+    chunked.max_chunks = 2;
+    auto pool = std::make_shared<geoslice::ReaderPool>(geoslice::ReaderPool::DEFAULT_MAX_READERS, 0, chunked);
+    geoslice::MosaicReader mosaic(catalog(), pool);
+    geoslice::MosaicReader mapped(catalog());
+
+    const int x = 30, y = 20, w = 30, h = 25;
+    std::vector<uint16_t> expected(2 * w * h), actual(2 * w * h);
+    mapped.read_window(x, y, w, h, expected.data());
+    mosaic.read_window(x, y, w, h, actual.data());
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(actual[(1 * h + 24) * w + 0], 10000 + 44 * 100 + 30);
+}
+
+TEST_F(MosaicTest, GapIsNodata) {
+    geoslice::MosaicReader mosaic(catalog());
+    EXPECT_TRUE(mosaic.sources_in(45, 35, 10, 10).empty());
+
+    std::vector<uint16_t> out(2 * 10 * 10, 0);
+    mosaic.read_window(45, 35, 10, 10, out.data());
+    for (uint16_t v : out) ASSERT_EQ(v, 65535);
+    EXPECT_EQ(mosaic.open_sources(), 0u);
+    EXPECT_THROW(mosaic.read_window(75, 0, 10, 10, out.data()), std::out_of_range);
+}
+
+TEST_F(MosaicTest, RejectsIncompatibleSources) {
+    EXPECT_THROW(geoslice::MosaicReader({}), std::invalid_argument);
+
+    auto sources = catalog();
+    sources.push_back(write_tile("shifted", 80, 0, 10, 10, "uint16", 0.5));  // quarter-pixel off grid
+    EXPECT_THROW(geoslice::MosaicReader{sources}, std::invalid_argument);
+
+    sources = catalog();
+    sources.pop_back();
+    sources.push_back(write_tile("int16", 80, 0, 10, 10, "int16"));
+    EXPECT_THROW(geoslice::MosaicReader{sources}, std::invalid_argument);
+
+    const auto grid = catalog();
+    for (const char* nodata : {"0", "null"}) {
+        sources.assign(grid.begin(), grid.begin() + 3);  // the compatible tiles
+        sources.push_back(write_tile(std::string("nodata_") + nodata, 80, 0, 10, 10, "uint16", 0.0, nodata));
+        EXPECT_THROW(geoslice::MosaicReader{sources}, std::invalid_argument) << nodata;
+    }
+}
+
+TEST_F(MosaicTest, OverlapKeepsValidPixelsUnderNodata) {
+    // A later source over the top-left corner that is nodata except for one
+    // pixel: only that pixel may replace the first tile's data
+    const std::string over = write_tile("over", 0, 0, 10, 10);
+    std::vector<uint16_t> data(2 * 10 * 10, 65535);
+    data[(1 * 10 + 3) * 10 + 2] = 7;
+    std::ofstream(over + ".bin", std::ios::binary)
+        .write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(uint16_t));
+
+    geoslice::MosaicReader mosaic(catalog());
+    for (int size : {10, 20}) {  // window inside the overlap, and around it
+        std::vector<uint16_t> out(2 * size * size);
+        mosaic.read_window(0, 0, size, size, out.data());
+        for (int b = 0; b < 2; b++) {
+            for (int r = 0; r < size; r++) {
+                for (int c = 0; c < size; c++) {
+                    const uint16_t expected = b == 1 && r == 3 && c == 2 ? 7 : static_cast<uint16_t>(b * 10000 + r * 100 + c);
+                    ASSERT_EQ(out[(b * size + r) * size + c], expected) << size << ":" << b << "," << r << "," << c;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(MosaicTest, StaysWithinPoolBudget) {
+    auto pool = std::make_shared<geoslice::ReaderPool>(1);
+    geoslice::MosaicReader mosaic(catalog(), pool);
+
+    std::vector<uint16_t> out(2 * 60 * 80);
+    mosaic.read_window(0, 0, 80, 60, out.data());
+
+    EXPECT_EQ(mosaic.open_sources(), 1u);
+    EXPECT_EQ(pool->evictions(), 2u);
+    EXPECT_EQ(out[59 * 80 + 30], 59 * 100 + 30);
+}
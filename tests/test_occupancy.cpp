@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "geoslice/mmap_reader.hpp"
+#include <cstdio>
+#include <fstream>
+
+class OccupancyTest : public ::testing::Test {
+protected:
+    std::string test_base = "/tmp/test_geoslice_occ";
+    static constexpr int W = 256;
+    static constexpr int H = 128;
+    static constexpr int TILE = 64;
+    std::vector<uint16_t> data;
+
+    // 1 band uint16, nodata 0, 4x2 tiles of 64: tiles (0, 0) and (1, 1) are
+    // empty, tile (2, 0) has a single nodata pixel, the rest hold x + 1.
+    void SetUp() override {
+        std::ofstream json(test_base + ".json");
+        json << R"({"dtype": "uint16", "count": 1, "height": 128, "width": 256,)"
+             << R"( "transform": [1.0, 0.0, 0.0, 0.0, -1.0, 128.0], "crs": "EPSG:32636", "nodata": 0})";
+        json.close();
+
+        data.resize(W * H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                const int tx = x / TILE, ty = y / TILE;
+                const bool empty = (tx == 0 && ty == 0) || (tx == 1 && ty == 1);
+                data[y * W + x] = empty ? 0 : static_cast<uint16_t>(x + 1);
+            }
+        }
+        data[10 * W + 150] = 0;
+        write_bin();
+    }
+
+    void TearDown() override {
+        std::remove((test_base + ".json").c_str());
+        std::remove((test_base + ".bin").c_str());
+        std::remove((test_base + ".occ").c_str());
+    }
+
+    void write_bin() {
+        std::ofstream bin(test_base + ".bin", std::ios::binary);
+        bin.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(uint16_t));
+    }
+
+    void write_index() {
+        geoslice::MMapReader reader(test_base);
+        geoslice::OccupancyIndex::build(reader, TILE).save(test_base + ".occ");
+    }
+};
+
+TEST_F(OccupancyTest, BuildClassifiesTiles) {
+    geoslice::MMapReader reader(test_base);
+    auto index = geoslice::OccupancyIndex::build(reader, TILE);
+
+    ASSERT_EQ(index.tiles_x(), 4);
+    ASSERT_EQ(index.tiles_y(), 2);
+    EXPECT_EQ(index.tile(0, 0), geoslice::Coverage::Empty);
+    EXPECT_EQ(index.tile(1, 1), geoslice::Coverage::Empty);
+    EXPECT_EQ(index.tile(2, 0), geoslice::Coverage::Partial);
+    EXPECT_EQ(index.tile(3, 1), geoslice::Coverage::Full);
+    EXPECT_EQ(index.empty_tiles(), 2u);
+}
+
+TEST_F(OccupancyTest, SaveLoadRoundTrip) {
+    write_index();
+    auto index = geoslice::OccupancyIndex::load(test_base + ".occ", W, H);
+
+    EXPECT_EQ(index.tile_size(), TILE);
+    EXPECT_EQ(index.tile(0, 0), geoslice::Coverage::Empty);
+    EXPECT_EQ(index.tile(2, 0), geoslice::Coverage::Partial);
+    EXPECT_THROW(geoslice::OccupancyIndex::load(test_base + ".occ", W * 2, H), std::runtime_error);
+}
+
+TEST_F(OccupancyTest, ReaderUsesIndex) {
+    write_index();
+    geoslice::MMapReader reader(test_base);
+
+    ASSERT_NE(reader.occupancy(), nullptr);
+    EXPECT_EQ(reader.coverage(0, 0, 64, 64), geoslice::Coverage::Empty);
+    EXPECT_EQ(reader.coverage(192, 0, 64, 128), geoslice::Coverage::Full);
+    EXPECT_EQ(reader.coverage(0, 0, 128, 64), geoslice::Coverage::Partial);
+}
+
+TEST_F(OccupancyTest, ReadWindowSynthesizesEmptyTiles) {
+    write_index();
+    // Scribble over the empty tile: reads must fill it instead of reading it
+    for (int y = 0; y < TILE; y++) data[y * W + 5] = 999;
+    write_bin();
+
+    geoslice::MMapReader reader(test_base);
+    std::vector<uint16_t> out(100 * 20);
+    reader.read_window(0, 10, 100, 20, out.data());
+
+    for (int y = 0; y < 20; y++) {
+        for (int x = 0; x < 100; x++) {
+            const uint16_t expected = x < TILE ? 0 : static_cast<uint16_t>(x + 1);
+            ASSERT_EQ(out[y * 100 + x], expected) << x << "," << y;
+        }
+    }
+}
+
+TEST_F(OccupancyTest, BatchReadMatchesSingle) {
+    write_index();
+    geoslice::MMapReader reader(test_base);
+    std::vector<geoslice::WindowRect> windows = {{0, 0, 64, 64}, {30, 40, 100, 60}, {150, 5, 20, 20}};
+    std::vector<std::vector<uint16_t>> outs;
+    std::vector<void*> ptrs;
+    for (const auto& w : windows) outs.emplace_back(w.width * w.height);
+    for (auto& o : outs) ptrs.push_back(o.data());
+
+    reader.read_windows(windows, ptrs, 2);
+
+    for (size_t i = 0; i < windows.size(); i++) {
+        const auto& w = windows[i];
+        std::vector<uint16_t> single(w.width * w.height);
+        reader.read_window(w.x, w.y, w.width, w.height, single.data());
+        EXPECT_EQ(outs[i], single);
+    }
+    EXPECT_THROW(reader.read_windows(windows, {ptrs[0]}), std::invalid_argument);
+}
+
+TEST_F(OccupancyTest, ScanSkipsEmptyTiles) {
+    write_index();
+    geoslice::MMapReader reader(test_base);
+
+    int visited = 0, skipped = 0;
+    reader.scan_tiles([&](const geoslice::WindowRect& tile, const geoslice::WindowView* view) {
+        EXPECT_EQ(tile.width, TILE);
+        if (view) {
+            EXPECT_EQ(view->at<uint16_t>(0, 0, 0), tile.x + 1);
+            visited++;
+        } else {
+            skipped++;
+        }
+    });
+
+    EXPECT_EQ(visited, 6);
+    EXPECT_EQ(skipped, 2);
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "geoslice/reader_pool.hpp"
+#include <cstdio>
+#include <fstream>
+
+class ReaderPoolTest : public ::testing::Test {
+protected:
+    std::string dir = "/tmp/test_geoslice_pool_";
+    static constexpr int N = 4;
+
+    // N single-band 16x16 uint8 rasters (256 bytes each), filled with their index
+    void SetUp() override {
+        for (int i = 0; i < N; i++) {
+            std::ofstream json(path(i) + ".json");
+            json << R"({"dtype": "uint8", "count": 1, "height": 16, "width": 16,)"
+                 << R"( "transform": [1.0, 0.0, 0.0, 0.0, -1.0, 16.0], "crs": null})";
+            std::vector<uint8_t> data(256, static_cast<uint8_t>(i));
+            std::ofstream bin(path(i) + ".bin", std::ios::binary);
+            bin.write(reinterpret_cast<const char*>(data.data()), data.size());
+        }
+    }
+
+    void TearDown() override {
+        for (int i = 0; i < N; i++) {
+            std::remove((path(i) + ".json").c_str());
+            std::remove((path(i) + ".bin").c_str());
+        }
+    }
+
+    std::string path(int i) const { return dir + std::to_string(i); }
+};
+
+TEST_F(ReaderPoolTest, ReusesOpenReaders) {
+    geoslice::ReaderPool pool;
+    auto a = pool.acquire(path(0));
+    auto b = pool.acquire(path(0));
+
+    EXPECT_EQ(a.get(), b.get());
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool.hits(), 1u);
+    EXPECT_EQ(pool.misses(), 1u);
+    EXPECT_EQ(pool.mapped_bytes(), 256u);
+}
+
+TEST_F(ReaderPoolTest, EvictsLeastRecentlyUsedByCount) {
+    geoslice::ReaderPool pool(2);
+    pool.acquire(path(0));
+    pool.acquire(path(1));
+    pool.acquire(path(0));  // 1 is now least recently used
+    pool.acquire(path(2));
+
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_TRUE(pool.contains(path(0)));
+    EXPECT_FALSE(pool.contains(path(1)));
+    EXPECT_TRUE(pool.contains(path(2)));
+    EXPECT_EQ(pool.evictions(), 1u);
+}
+
+TEST_F(ReaderPoolTest, EvictsByMappedBytes) {
+    geoslice::ReaderPool pool(100, 600);
+    for (int i = 0; i < N; i++) pool.acquire(path(i));
+
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_LE(pool.mapped_bytes(), 600u);
+    EXPECT_TRUE(pool.contains(path(3)));
+}
+
+TEST_F(ReaderPoolTest, EvictedReaderStaysValidWhileHeld) {
+    geoslice::ReaderPool pool(1);
+    auto held = pool.acquire(path(1));
+    pool.acquire(path(2));
+
+    EXPECT_FALSE(pool.contains(path(1)));
+    EXPECT_EQ(held->get_window(3, 3, 1, 1).at<uint8_t>(0, 0, 0), 1);
+
+    pool.clear();
+    EXPECT_EQ(pool.size(), 0u);
+    EXPECT_EQ(pool.mapped_bytes(), 0u);
+    EXPECT_THROW(geoslice::ReaderPool(0), std::invalid_argument);
+    EXPECT_THROW(pool.acquire(dir + "missing"), std::runtime_error);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "geoslice/parallel.hpp"
+#include "counting_executor.hpp"
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+class ThreadPoolTest : public ::testing::Test {
+protected:
+    void TearDown() override { geoslice::set_default_executor(nullptr); }
+};
+}
+
+TEST_F(ThreadPoolTest, RunsSubmittedTasks) {
+    geoslice::ThreadPool pool({3, {}});
+    EXPECT_EQ(pool.concurrency(), 3u);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 50; i++) {
+        auto task = std::make_shared<std::packaged_task<int()>>([i] { return i * i; });
+        results.push_back(task->get_future());
+        pool.submit([task] { (*task)(); });
+    }
+    for (int i = 0; i < 50; i++) EXPECT_EQ(results[i].get(), i * i);
+}
+
+TEST_F(ThreadPoolTest, NestedLoopsShareThePool) {
+    geoslice::configure_thread_pool({3, {}});
+    std::mutex mutex;
+    std::set<std::thread::id> seen;
+    std::atomic<int> sum{0};
+
+    geoslice::parallel_for(8, 0, [&](size_t i) {
+        geoslice::parallel_for(16, 0, [&](size_t j) {
+            sum += static_cast<int>(i * 16 + j);
+            std::lock_guard<std::mutex> lock(mutex);
+            seen.insert(std::this_thread::get_id());
+        });
+    });
+
+    EXPECT_EQ(sum.load(), 127 * 128 / 2);
+    // The 3 workers and this thread, however deep the nesting
+    EXPECT_LE(seen.size(), 4u);
+}
+
+TEST_F(ThreadPoolTest, ExceptionsReachTheCaller) {
+    geoslice::configure_thread_pool({2, {}});
+    EXPECT_THROW(geoslice::parallel_for(1000, 3, [&](size_t i) {
+        if (i == 10) throw std::runtime_error("stop");
+    }), std::runtime_error);
+
+    // The pool is still usable
+    std::atomic<int> count{0};
+    geoslice::parallel_for(100, 3, [&](size_t) { count++; });
+    EXPECT_EQ(count.load(), 100);
+}
+
+TEST_F(ThreadPoolTest, InjectedExecutorRunsTheHelpers) {
+    auto executor = std::make_shared<CountingExecutor>();
+    geoslice::set_default_executor(executor);
+    EXPECT_EQ(geoslice::default_executor(), executor);
+
+    std::atomic<int> count{0};
+    geoslice::parallel_for(100, 8, [&](size_t) { count++; });
+    EXPECT_EQ(count.load(), 100);
+    // threads - 1 helpers, capped at the executor's concurrency
+    EXPECT_EQ(executor->submitted.load(), 2);
+
+    geoslice::parallel_for(100, 1, [&](size_t) { count++; });
+    EXPECT_EQ(executor->submitted.load(), 2);  // one thread runs inline
+}
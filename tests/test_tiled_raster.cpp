@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include "geoslice/raster_header.hpp"
+#include "geoslice/tiled_raster.hpp"
+#include <cstdio>
+#include <fstream>
+
+class TiledRasterTest : public ::testing::Test {
+protected:
+    std::string base = "/tmp/test_geoslice_tiled";
+    std::string out = "/tmp/test_geoslice_tiled_out";
+    static constexpr int W = 300, H = 170, B = 2;
+
+    void SetUp() override {
+        std::ofstream json(base + ".json");
+        json << R"({"dtype": "uint16", "count": 2, "height": 170, "width": 300,)"
+             << R"( "transform": [1.0, 0.0, 0.0, 0.0, -1.0, 170.0], "crs": "EPSG:32636", "nodata": 0})";
+        json.close();
+
+        std::ofstream bin(base + ".bin", std::ios::binary);
+        for (int b = 0; b < B; b++)
+            for (int y = 0; y < H; y++)
+                for (int x = 0; x < W; x++) {
+                    const uint16_t v = value(b, y, x);
+                    bin.write(reinterpret_cast<const char*>(&v), sizeof(v));
+                }
+    }
+
+    void TearDown() override {
+        std::remove((base + ".json").c_str());
+        std::remove((base + ".bin").c_str());
+        std::remove((out + ".gsz").c_str());
+    }
+
+    // Smooth, so it compresses
+    static uint16_t value(int b, int y, int x) { return static_cast<uint16_t>(b * 1000 + y / 3 + x / 5); }
+
+    void expect_window(const geoslice::TiledReader& reader, int x, int y, int w, int h) {
+        std::vector<uint16_t> px(B * w * h);
+        reader.read_window(x, y, w, h, px.data());
+        for (int b = 0; b < B; b++)
+            for (int r = 0; r < h; r++)
+                for (int c = 0; c < w; c++)
+                    ASSERT_EQ(px[(b * h + r) * w + c], value(b, y + r, x + c)) << b << "," << y + r << "," << x + c;
+    }
+};
+
+TEST_F(TiledRasterTest, RoundTripsWindows) {
+    geoslice::TiledOptions options;
+    options.tile_size = 64;
+    geoslice::write_tiled_raster(base, out, options);
+
+    geoslice::TiledReader reader(out);
+    EXPECT_EQ(reader.width(), W);
+    EXPECT_EQ(reader.height(), H);
+    EXPECT_EQ(reader.metadata().crs, "EPSG:32636");
+    ASSERT_TRUE(reader.metadata().nodata.has_value());
+    EXPECT_EQ(reader.num_tiles(), 5u * 3u);
+    EXPECT_EQ(reader.codec(), geoslice::TileCodec::LZ4);
+    EXPECT_LT(reader.file_bytes(), size_t(B) * W * H * sizeof(uint16_t) / 3);
+
+    expect_window(reader, 0, 0, W, H);
+    expect_window(reader, 60, 60, 10, 10);      // straddles four tiles
+    expect_window(reader, 290, 160, 10, 10);    // clipped corner tile
+    EXPECT_THROW(expect_window(reader, 295, 0, 10, 10), std::out_of_range);
+}
+
+TEST_F(TiledRasterTest, DecodesOnlyIntersectingTilesThroughCache) {
+    geoslice::TiledOptions options;
+    options.tile_size = 64;
+    geoslice::write_tiled_raster(base, out, options);
+    geoslice::TiledReader reader(out);
+
+    std::vector<uint16_t> px(B * 10 * 10);
+    reader.read_window(10, 10, 10, 10, px.data());
+    EXPECT_EQ(reader.cache_misses(), 1u);
+    reader.read_window(60, 60, 10, 10, px.data());
+    EXPECT_EQ(reader.cache_misses(), 4u);
+    EXPECT_EQ(reader.cache_hits(), 1u);
+    EXPECT_EQ(reader.cached_tiles(), 4u);
+
+    // A batch decodes tiles shared by its windows once
+    reader.clear_cache();
+    std::vector<uint16_t> a(B * 20 * 20), b(B * 20 * 20);
+    reader.read_windows({{100, 100, 20, 20}, {110, 110, 20, 20}}, {a.data(), b.data()});
+    EXPECT_EQ(reader.cache_misses(), 4u + 4u);
+    EXPECT_EQ(a[0], value(0, 100, 100));
+    EXPECT_EQ(b[B * 20 * 20 - 1], value(1, 129, 129));
+}
+
+TEST_F(TiledRasterTest, DeltaFilterRoundTripsAndShrinks) {
+    geoslice::TiledOptions options;
+    options.tile_size = 64;
+    geoslice::write_tiled_raster(base, out, options);
+    const size_t unfiltered = geoslice::TiledReader(out).file_bytes();
+
+    options.filter = geoslice::TileFilter::Delta;
+    options.overwrite = true;
+    geoslice::write_tiled_raster(base, out, options);
+    geoslice::TiledReader reader(out);
+    EXPECT_EQ(reader.filter(), geoslice::TileFilter::Delta);
+    EXPECT_LT(reader.file_bytes(), unfiltered);
+    expect_window(reader, 0, 0, W, H);
+    expect_window(reader, 290, 160, 10, 10);
+}
+
+TEST_F(TiledRasterTest, CacheStaysWithinBudget) {
+    geoslice::TiledOptions options;
+    options.tile_size = 64;
+    options.codec = geoslice::TileCodec::None;
+    geoslice::write_tiled_raster(base, out, options);
+
+    geoslice::TiledReaderOptions reader_options;
+    reader_options.cache_bytes = 2 * B * 64 * 64 * sizeof(uint16_t);
+    geoslice::TiledReader reader(out, reader_options);
+    expect_window(reader, 0, 0, W, H);
+    EXPECT_LE(reader.cached_bytes(), reader_options.cache_bytes);
+    EXPECT_GE(reader.cached_tiles(), 2u);
+}
+
+TEST_F(TiledRasterTest, RejectsMismatchedFiles) {
+    geoslice::write_tiled_raster(base, out);
+    EXPECT_THROW(geoslice::write_tiled_raster(base, out), std::runtime_error);  // exists
+
+    // A raw reader refuses the tiled file and vice versa
+    {
+        std::ifstream src(out + ".gsz", std::ios::binary);
+        std::ofstream dst(out + ".bin", std::ios::binary);
+        dst << src.rdbuf();
+    }
+    EXPECT_THROW(geoslice::MMapReader{out}, std::runtime_error);
+    std::remove((out + ".bin").c_str());
+
+    {
+        std::ofstream gsz(out + ".gsz", std::ios::binary | std::ios::trunc);
+        const auto header = geoslice::make_header(geoslice::MMapReader(base).metadata());
+        gsz.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    EXPECT_THROW(geoslice::TiledReader{out}, std::runtime_error);
+}
+
+TEST_F(TiledRasterTest, TileSizeBoundedByRaster) {
+    // Larger tile sizes are clamped when writing...
+    geoslice::TiledOptions options;
+    options.tile_size = 1 << 30;
+    geoslice::write_tiled_raster(base, out, options);
+    {
+        geoslice::TiledReader reader(out);
+        EXPECT_EQ(reader.tile_size(), W);
+        EXPECT_EQ(reader.num_tiles(), 1u);
+        expect_window(reader, 10, 20, 50, 40);
+    }
+
+    // ...and rejected when reading, including sizes that do not fit an int
+    for (uint32_t tile_size : {uint32_t(W + 1), uint32_t(1) << 31, uint32_t(0xFFFFFFFF)}) {
+        {
+            std::fstream gsz(out + ".gsz", std::ios::binary | std::ios::in | std::ios::out);
+            gsz.seekp(sizeof(geoslice::RasterHeader));
+            gsz.write(reinterpret_cast<const char*>(&tile_size), sizeof(tile_size));
+        }
+        EXPECT_THROW(geoslice::TiledReader{out}, std::runtime_error) << tile_size;
+    }
+}
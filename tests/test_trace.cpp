@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "geoslice/trace.hpp"
+#include "geoslice/window_cache.hpp"
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+const std::string TRACE_PATH = "/tmp/test_geoslice_trace.json";
+
+std::string dump(size_t& events) {
+    events = geoslice::dump_trace(TRACE_PATH);
+    std::ifstream in(TRACE_PATH);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::remove(TRACE_PATH.c_str());
+    return ss.str();
+}
+
+size_t count(const std::string& s, const std::string& what) {
+    size_t n = 0;
+    for (size_t pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + 1)) n++;
+    return n;
+}
+}
+
+TEST(TraceTest, RecordsScopesPerThreadAsChromeTrace) {
+    { geoslice::ScopedTrace before("before"); }  // not tracing yet
+    geoslice::start_tracing();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 10; i++) geoslice::ScopedTrace scope("worker");
+        });
+    }
+    for (auto& t : threads) t.join();  // rings outlive their threads
+    { geoslice::ScopedTrace scope("main"); }
+    geoslice::stop_tracing();
+    { geoslice::ScopedTrace after("after"); }
+
+    size_t events = 0;
+    const std::string json = dump(events);
+    EXPECT_EQ(events, 41u);
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\"", 0), 0u);
+    EXPECT_EQ(count(json, "\"ph\": \"X\""), 41u);
+    EXPECT_EQ(count(json, "\"name\": \"worker\""), 40u);
+    EXPECT_EQ(count(json, "\"before\"") + count(json, "\"after\""), 0u);
+
+    std::set<std::string> tids;
+    for (size_t pos = json.find("\"tid\": "); pos != std::string::npos; pos = json.find("\"tid\": ", pos + 1)) {
+        tids.insert(json.substr(pos + 7, json.find(',', pos) - pos - 7));
+    }
+    EXPECT_EQ(tids.size(), 5u);
+}
+
+TEST(TraceTest, RingKeepsLatestEvents) {
+    geoslice::start_tracing(4);
+    for (int i = 0; i < 10; i++) geoslice::ScopedTrace scope(geoslice::intern_trace_name("event" + std::to_string(i)));
+    geoslice::stop_tracing();
+
+    size_t events = 0;
+    const std::string json = dump(events);
+    EXPECT_EQ(events, 4u);
+    EXPECT_EQ(count(json, "\"event9\""), 1u);
+    EXPECT_EQ(count(json, "\"event5\""), 0u);
+    EXPECT_THROW(geoslice::start_tracing(0), std::invalid_argument);
+
+    // A new session discards the previous one
+    geoslice::start_tracing();
+    geoslice::stop_tracing();
+    EXPECT_EQ(geoslice::dump_trace(TRACE_PATH), 0u);
+    std::remove(TRACE_PATH.c_str());
+}
+
+TEST(TraceTest, LibraryTracePointsWhenCompiledIn) {
+    geoslice::WindowCache cache(1024);
+    const std::vector<uint8_t> data(16, 1);
+    geoslice::start_tracing();
+    cache.put(0, 0, 4, 4, data.data(), data.size());
+    cache.get(0, 0, 4, 4);
+    geoslice::stop_tracing();
+
+    size_t events = 0;
+    const std::string json = dump(events);
+    const size_t on = geoslice::trace_points_enabled() ? 1 : 0;
+    EXPECT_EQ(count(json, "\"window_cache.get\""), on);
+    EXPECT_EQ(count(json, "\"window_cache.put\""), on);
+    EXPECT_EQ(count(json, "\"window_cache.lock\""), 2 * on);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "geoslice/simd.hpp"
+#include "geoslice/window_stats.hpp"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+class WindowStatsTest : public ::testing::Test {
+protected:
+    std::string test_base = "/tmp/test_geoslice_stats";
+    std::vector<uint16_t> data;
+
+    void SetUp() override {
+        std::ofstream json(test_base + ".json");
+        json << R"({
+            "dtype": "uint16",
+            "count": 2,
+            "height": 32,
+            "width": 64,
+            "transform": [1.0, 0.0, 0.0, 0.0, -1.0, 32.0],
+            "crs": "EPSG:32636"
+        })";
+        json.close();
+
+        // Band 0: x + y * 64, band 1: constant 7 with a nodata (0) left half
+        data.resize(2 * 32 * 64);
+        for (int y = 0; y < 32; y++) {
+            for (int x = 0; x < 64; x++) {
+                data[y * 64 + x] = static_cast<uint16_t>(x + y * 64);
+                data[32 * 64 + y * 64 + x] = x < 32 ? 0 : 7;
+            }
+        }
+        std::ofstream bin(test_base + ".bin", std::ios::binary);
+        bin.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(uint16_t));
+        bin.close();
+    }
+
+    void TearDown() override {
+        std::remove((test_base + ".json").c_str());
+        std::remove((test_base + ".bin").c_str());
+    }
+};
+
+TEST_F(WindowStatsTest, FullWindowMatchesReference) {
+    geoslice::MMapReader reader(test_base);
+    auto stats = geoslice::window_stats(reader.get_window(0, 0, 64, 32));
+
+    ASSERT_EQ(stats.size(), 2u);
+    const double n = 64.0 * 32.0;
+    double mean = (n - 1) / 2;
+    double var = (n * n - 1) / 12;  // uniform 0..n-1
+
+    EXPECT_EQ(stats[0].valid_count, 64u * 32u);
+    EXPECT_DOUBLE_EQ(stats[0].min, 0.0);
+    EXPECT_DOUBLE_EQ(stats[0].max, n - 1);
+    EXPECT_NEAR(stats[0].mean, mean, 1e-9);
+    EXPECT_NEAR(stats[0].std, std::sqrt(var), 1e-6);
+}
+
+TEST_F(WindowStatsTest, SubWindow) {
+    geoslice::MMapReader reader(test_base);
+    auto stats = geoslice::window_stats(reader.get_window(10, 5, 4, 2));
+
+    // Values: 330..333 and 394..397
+    EXPECT_EQ(stats[0].valid_count, 8u);
+    EXPECT_DOUBLE_EQ(stats[0].min, 330.0);
+    EXPECT_DOUBLE_EQ(stats[0].max, 397.0);
+    EXPECT_NEAR(stats[0].mean, 363.5, 1e-9);
+}
+
+TEST_F(WindowStatsTest, SkipsNodata) {
+    geoslice::MMapReader reader(test_base);
+    auto stats = geoslice::window_stats(reader.get_window(0, 0, 64, 32), 0.0);
+
+    EXPECT_EQ(stats[1].valid_count, 32u * 32u);
+    EXPECT_DOUBLE_EQ(stats[1].min, 7.0);
+    EXPECT_DOUBLE_EQ(stats[1].max, 7.0);
+    EXPECT_NEAR(stats[1].std, 0.0, 1e-12);
+    // Only pixel (0, 0) of band 0 is zero
+    EXPECT_EQ(stats[0].valid_count, 64u * 32u - 1);
+    EXPECT_DOUBLE_EQ(stats[0].min, 1.0);
+}
+
+TEST_F(WindowStatsTest, AllNodataBandIsNaN) {
+    geoslice::MMapReader reader(test_base);
+    auto stats = geoslice::window_stats(reader.get_window(0, 0, 16, 16), 0.0);
+
+    EXPECT_EQ(stats[1].valid_count, 0u);
+    EXPECT_TRUE(std::isnan(stats[1].mean));
+    EXPECT_TRUE(std::isnan(stats[1].min));
+}
+
+TEST_F(WindowStatsTest, UnrepresentableNodataIgnored) {
+    geoslice::MMapReader reader(test_base);
+    auto stats = geoslice::window_stats(reader.get_window(0, 0, 64, 32), -9999.0);
+
+    EXPECT_EQ(stats[1].valid_count, 64u * 32u);
+}
+
+TEST_F(WindowStatsTest, BatchMatchesSingle) {
+    geoslice::MMapReader reader(test_base);
+    std::vector<geoslice::WindowRect> windows;
+    for (int i = 0; i < 20; i++) windows.push_back({i, i % 16, 32, 16});
+
+    auto batch = geoslice::window_stats_batch(reader, windows, 0.0, 4);
+
+    ASSERT_EQ(batch.size(), windows.size());
+    for (size_t i = 0; i < windows.size(); i++) {
+        const auto& w = windows[i];
+        auto single = geoslice::window_stats(reader.get_window(w.x, w.y, w.width, w.height), 0.0);
+        for (int b = 0; b < 2; b++) {
+            EXPECT_EQ(batch[i][b].valid_count, single[b].valid_count);
+            if (single[b].valid_count > 0) {
+                EXPECT_DOUBLE_EQ(batch[i][b].mean, single[b].mean);
+            }
+        }
+    }
+}
+
+TEST_F(WindowStatsTest, BatchRejectsInvalidWindow) {
+    geoslice::MMapReader reader(test_base);
+    std::vector<geoslice::WindowRect> windows = {{0, 0, 10, 10}, {60, 0, 10, 10}};
+
+    EXPECT_THROW(geoslice::window_stats_batch(reader, windows), std::out_of_range);
+}
+
+TEST(WindowStatsFloat, NaNPixelsAreSkipped) {
+    // Odd width exercises the kernel's tail after its vector lanes
+    std::vector<float> pixels(7 * 5, 2.0f);
+    pixels[3] = std::nanf("");
+    pixels[20] = std::nanf("");
+    pixels[34] = 9.0f;
+    geoslice::WindowView view{reinterpret_cast<const uint8_t*>(pixels.data()), 1, 5, 7,
+                              pixels.size() * sizeof(float), 7 * sizeof(float), sizeof(float),
+                              geoslice::DType::Float32};
+
+    auto stats = geoslice::window_stats(view);
+    EXPECT_EQ(stats[0].valid_count, 33u);
+    EXPECT_DOUBLE_EQ(stats[0].min, 2.0);
+    EXPECT_DOUBLE_EQ(stats[0].max, 9.0);
+    EXPECT_NEAR(stats[0].mean, (32 * 2.0 + 9.0) / 33, 1e-12);
+}
+
+TEST(WindowStatsFloat, LargeOffsetKeepsVariance) {
+    // Values near 1e6 differing by one float ulp: sums of squares around
+    // zero would cancel most of the variance
+    const int width = 4096, height = 3;
+    std::vector<float> pixels(width * height);
+    for (size_t i = 0; i < pixels.size(); i++) pixels[i] = 1e6f + (i % 2 ? 0.125f : 0.0f);
+    geoslice::WindowView view{reinterpret_cast<const uint8_t*>(pixels.data()), 1, height, width,
+                              pixels.size() * sizeof(float), width * sizeof(float), sizeof(float),
+                              geoslice::DType::Float32};
+
+    auto stats = geoslice::window_stats(view);
+    EXPECT_DOUBLE_EQ(stats[0].mean, 1e6 + 0.0625);
+    EXPECT_NEAR(stats[0].std, 0.0625, 1e-9);
+}
+
+TEST(WindowStatsFloat, KernelLevelIsReported) {
+    const std::string level = geoslice::simd_level();
+    EXPECT_TRUE(level == "avx512f" || level == "avx2" || level == "sse4.2" || level == "neon" ||
+                level == "baseline") << level;
+}